@@ -0,0 +1,108 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++20 -Wall -Wfatal-errors -pthread
+QMAKE_CXXFLAGS_RELEASE += -O2
+
+OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/benchmarks/
+DESTDIR = $$_PRO_FILE_PWD_/bin/
+TARGET = track-benchmarks
+
+LIBS += -lz -pthread
+
+INCLUDEPATH += headers/ headers/gpx/ headers/xml/ benchmarks/
+
+HEADERS += \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/gzip.h \
+    headers/mapped-file.h \
+    headers/haversine.h \
+    headers/point-columns.h \
+    headers/sensor-data.h \
+    headers/thread-pool.h \
+    headers/track.h \
+    headers/track-invariants.h \
+    headers/track-leg.h \
+    headers/track-summary.h \
+    headers/track-cache.h \
+    headers/track-codec.h \
+    headers/track-decimator.h \
+    headers/track-file.h \
+    headers/trackpoint.h \
+    headers/types.h \
+    headers/waypoint.h \
+    headers/gpx/gpx-batch-parser.h \
+    headers/gpx/gpx-date-time.h \
+    headers/gpx/gpx-number.h \
+    headers/gpx/gpx-parser.h \
+    headers/gpx/gpx-track-reader.h \
+    headers/gpx/gpx-writer.h \
+    headers/xml/xml-document.h \
+    headers/xml/xml-element.h \
+    headers/xml/xml-incremental-parser.h \
+    headers/xml/xml-parser.h \
+    headers/xml/xml-path-filter.h \
+    headers/xml/xml-scan.h
+
+SOURCES += \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/gzip.cpp \
+    src/mapped-file.cpp \
+    src/point-columns.cpp \
+    src/sensor-data.cpp \
+    src/thread-pool.cpp \
+    src/track.cpp \
+    src/haversine.cpp \
+    src/track-invariants.cpp \
+    src/track-leg.cpp \
+    src/track-summary.cpp \
+    src/track-cache.cpp \
+    src/track-codec.cpp \
+    src/track-decimator.cpp \
+    src/track-file.cpp \
+    src/waypoint.cpp \
+    src/gpx/gpx-batch-parser.cpp \
+    src/gpx/gpx-date-time.cpp \
+    src/gpx/gpx-number.cpp \
+    src/gpx/gpx-parallel-parser.cpp \
+    src/gpx/gpx-parser.cpp \
+    src/gpx/gpx-track-reader.cpp \
+    src/gpx/gpx-writer.cpp \
+    src/xml/xml-document.cpp \
+    src/xml/xml-element.cpp \
+    src/xml/xml-incremental-parser.cpp \
+    src/xml/xml-parser.cpp \
+    src/xml/xml-path-filter.cpp \
+    src/xml/xml-scan.cpp
+
+HEADERS += \
+    benchmarks/benchmarks.h
+
+SOURCES += \
+    benchmarks/benchmark-main.cpp \
+    benchmarks/gpx-batch-benchmark.cpp \
+    benchmarks/gpx-gzip-benchmark.cpp \
+    benchmarks/gpx-high-rate-benchmark.cpp \
+    benchmarks/gpx-parallel-benchmark.cpp \
+    benchmarks/gpx-parser-benchmark.cpp \
+    benchmarks/gpx-sensors-benchmark.cpp \
+    benchmarks/gpx-writer-benchmark.cpp \
+    benchmarks/haversine-benchmark.cpp \
+    benchmarks/track-cache-benchmark.cpp \
+    benchmarks/track-codec-benchmark.cpp \
+    benchmarks/track-columns-benchmark.cpp \
+    benchmarks/track-file-benchmark.cpp \
+    benchmarks/track-invariants-benchmark.cpp \
+    benchmarks/track-legs-benchmark.cpp \
+    benchmarks/track-summary-benchmark.cpp \
+    benchmarks/xml-document-benchmark.cpp \
+    benchmarks/xml-filter-benchmark.cpp \
+    benchmarks/xml-parser-benchmark.cpp \
+    benchmarks/xml-scan-benchmark.cpp
+
+OTHER_FILES += \
+    data/NorthYorkMoors.gpx
@@ -3,38 +3,106 @@ CONFIG += console c++20
 CONFIG -= app_bundle
 CONFIG -= qt
 
-QMAKE_CXXFLAGS += -std=c++20 -Wall -Wfatal-errors
+QMAKE_CXXFLAGS += -std=c++20 -Wall -Wfatal-errors -pthread
 
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
 TARGET = track-tests
 
-LIBS += -lboost_unit_test_framework
+LIBS += -lz -lboost_unit_test_framework -pthread
 
 INCLUDEPATH += headers/ headers/gpx/ headers/xml/
 
 HEADERS += \
     headers/earth.h \
     headers/geometry.h \
+    headers/gzip.h \
+    headers/mapped-file.h \
+    headers/haversine.h \
+    headers/point-columns.h \
+    headers/sensor-data.h \
+    headers/thread-pool.h \
     headers/track.h \
+    headers/track-invariants.h \
+    headers/track-leg.h \
+    headers/track-summary.h \
+    headers/track-cache.h \
+    headers/track-codec.h \
+    headers/track-decimator.h \
+    headers/track-file.h \
     headers/trackpoint.h \
     headers/types.h \
     headers/waypoint.h \
+    headers/gpx/gpx-batch-parser.h \
+    headers/gpx/gpx-date-time.h \
+    headers/gpx/gpx-number.h \
     headers/gpx/gpx-parser.h \
+    headers/gpx/gpx-track-reader.h \
+    headers/gpx/gpx-writer.h \
+    headers/xml/xml-document.h \
     headers/xml/xml-element.h \
-    headers/xml/xml-parser.h
+    headers/xml/xml-incremental-parser.h \
+    headers/xml/xml-parser.h \
+    headers/xml/xml-path-filter.h \
+    headers/xml/xml-scan.h
 
 SOURCES += \
     src/earth.cpp \
     src/geometry.cpp \
+    src/gzip.cpp \
+    src/mapped-file.cpp \
+    src/point-columns.cpp \
+    src/sensor-data.cpp \
+    src/thread-pool.cpp \
     src/track.cpp \
+    src/haversine.cpp \
+    src/track-invariants.cpp \
+    src/track-leg.cpp \
+    src/track-summary.cpp \
+    src/track-cache.cpp \
+    src/track-codec.cpp \
+    src/track-decimator.cpp \
+    src/track-file.cpp \
     src/waypoint.cpp \
+    src/gpx/gpx-batch-parser.cpp \
+    src/gpx/gpx-date-time.cpp \
+    src/gpx/gpx-number.cpp \
+    src/gpx/gpx-parallel-parser.cpp \
     src/gpx/gpx-parser.cpp \
+    src/gpx/gpx-track-reader.cpp \
+    src/gpx/gpx-writer.cpp \
+    src/xml/xml-document.cpp \
     src/xml/xml-element.cpp \
-    src/xml/xml-parser.cpp
+    src/xml/xml-incremental-parser.cpp \
+    src/xml/xml-parser.cpp \
+    src/xml/xml-path-filter.cpp \
+    src/xml/xml-scan.cpp
 
 SOURCES += \
-    tests/track-tests.cpp
+    tests/gpx-batch-parser-tests.cpp \
+    tests/gpx-date-time-tests.cpp \
+    tests/gpx-number-tests.cpp \
+    tests/gpx-parallel-parser-tests.cpp \
+    tests/gpx-parser-tests.cpp \
+    tests/gpx-track-reader-tests.cpp \
+    tests/gpx-writer-tests.cpp \
+    tests/gzip-tests.cpp \
+    tests/haversine-tests.cpp \
+    tests/point-columns-tests.cpp \
+    tests/sensor-data-tests.cpp \
+    tests/thread-pool-tests.cpp \
+    tests/track-cache-tests.cpp \
+    tests/track-codec-tests.cpp \
+    tests/track-decimator-tests.cpp \
+    tests/track-file-tests.cpp \
+    tests/track-invariants-tests.cpp \
+    tests/track-leg-tests.cpp \
+    tests/track-summary-tests.cpp \
+    tests/track-tests.cpp \
+    tests/xml-document-tests.cpp \
+    tests/xml-incremental-parser-tests.cpp \
+    tests/xml-parser-tests.cpp \
+    tests/xml-scan-tests.cpp
 
 OTHER_FILES += \
     data/NorthYorkMoors.gpx
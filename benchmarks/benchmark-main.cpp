@@ -0,0 +1,120 @@
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#include "benchmarks.h"
+
+namespace
+{
+  std::atomic<std::size_t> allocations {0};
+  std::atomic<std::size_t> bytesAllocated {0};
+}
+
+[[gnu::noinline]] void* operator new(std::size_t bytes)
+{
+    ++allocations;
+    bytesAllocated += bytes;
+    if (void* memory = std::malloc(bytes == 0 ? 1 : bytes)) return memory;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace Benchmarks
+{
+  std::size_t allocationCount()
+  {
+      return allocations;
+  }
+
+  std::size_t allocatedBytes()
+  {
+      return bytesAllocated;
+  }
+
+  std::string scaledSampleGPX(std::size_t targetBytes)
+  {
+      std::ifstream sampleFile {"data/NorthYorkMoors.gpx"};
+      if (! sampleFile)
+      {
+          throw std::runtime_error("Benchmarks must be run from the project directory (data/NorthYorkMoors.gpx not found).");
+      }
+      std::ostringstream sampleText;
+      sampleText << sampleFile.rdbuf();
+      const std::string sample = sampleText.str();
+
+      const std::size_t firstPoint = sample.find("<trkpt");
+      const std::size_t endOfLastPoint = sample.rfind("</trkpt>") + std::string("</trkpt>\n").size();
+      const std::string_view points {sample.data() + firstPoint, endOfLastPoint - firstPoint};
+
+      std::string gpx = sample.substr(0, firstPoint);
+      gpx.reserve(targetBytes + sample.size());
+      while (gpx.size() < targetBytes)
+      {
+          gpx += points;
+      }
+      gpx += sample.substr(endOfLastPoint);
+      return gpx;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::map<std::string, std::function<void()>> benchmarks {
+        {"xml-parser", Benchmarks::xmlParser},
+        {"xml-document", Benchmarks::xmlDocument},
+        {"xml-scan", Benchmarks::xmlScan},
+        {"xml-filter", Benchmarks::xmlFilter},
+        {"gpx-parser", Benchmarks::gpxParser},
+        {"gpx-parallel", Benchmarks::gpxParallel},
+        {"gpx-batch", Benchmarks::gpxBatch},
+        {"gpx-writer", Benchmarks::gpxWriter},
+        {"gpx-gzip", Benchmarks::gpxGzip},
+        {"gpx-high-rate", Benchmarks::gpxHighRate},
+        {"gpx-sensors", Benchmarks::gpxSensors},
+        {"track-cache", Benchmarks::trackCache},
+        {"track-file", Benchmarks::trackFile},
+        {"track-legs", Benchmarks::trackLegs},
+        {"track-summary", Benchmarks::trackSummary},
+        {"track-codec", Benchmarks::trackCodec},
+        {"track-columns", Benchmarks::trackColumns},
+        {"haversine", Benchmarks::haversine},
+        {"track-invariants", Benchmarks::trackInvariants},
+    };
+
+    if (argc == 1)
+    {
+        for (const auto& [name, benchmark] : benchmarks)
+        {
+            std::cout << "== " << name << " ==" << std::endl;
+            benchmark();
+        }
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto benchmark = benchmarks.find(argv[i]);
+        if (benchmark == benchmarks.end())
+        {
+            std::cerr << "Unknown benchmark: " << argv[i] << std::endl;
+            return 1;
+        }
+        std::cout << "== " << benchmark->first << " ==" << std::endl;
+        benchmark->second();
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef GPS_BENCHMARKS_H
+#define GPS_BENCHMARKS_H
+
+#include <chrono>
+#include <string>
+
+namespace Benchmarks
+{
+  /* The sample track from data/, with its track points repeated to produce a document of
+   * (approximately) the requested size.
+   */
+  std::string scaledSampleGPX(std::size_t targetBytes);
+
+  // Heap allocations made so far by this program (operator new is replaced to count them).
+  std::size_t allocationCount();
+  std::size_t allocatedBytes();
+
+  // Run the function repeatedly and return the fastest wall-clock time, in seconds.
+  template <typename Function>
+  double bestTimeOf(unsigned int repetitions, Function function)
+  {
+      double best = 0;
+      for (unsigned int i = 0; i < repetitions; ++i)
+      {
+          const auto start = std::chrono::steady_clock::now();
+          function();
+          const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+          if (i == 0 || elapsed.count() < best) best = elapsed.count();
+      }
+      return best;
+  }
+
+  void xmlParser();
+  void xmlDocument();
+  void xmlScan();
+  void xmlFilter();
+  void gpxParser();
+  void gpxParallel();
+  void gpxBatch();
+  void gpxWriter();
+  void gpxGzip();
+  void gpxHighRate();
+  void gpxSensors();
+  void trackCache();
+  void trackFile();
+  void trackLegs();
+  void trackSummary();
+  void trackCodec();
+  void trackColumns();
+  void haversine();
+  void trackInvariants();
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gpx-batch-parser.h"
+#include "gpx-parser.h"
+#include "thread-pool.h"
+
+#include "benchmarks.h"
+
+/* Throughput of batch ingest over 500 GPX files of between ~100 KB and ~1 MB, written to a
+ * temporary directory, for increasing pool sizes.  The sequential figure is parseTrackFile() called
+ * on each file in turn.
+ */
+void Benchmarks::gpxBatch()
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "gpx-batch-benchmark";
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::string> filePaths;
+    std::size_t totalBytes = 0;
+    for (unsigned int file = 0; file < 500; ++file)
+    {
+        const std::string gpx = scaledSampleGPX(100'000 * (1 + file % 10));
+        filePaths.push_back((directory / ("track-" + std::to_string(file) + ".gpx")).string());
+        std::ofstream {filePaths.back(), std::ios::binary} << gpx;
+        totalBytes += gpx.size();
+    }
+    const double megabytes = totalBytes / 1e6;
+    const unsigned int repetitions = 3;
+
+    const double sequentialTime = bestTimeOf(repetitions, [&]{ for (const std::string& filePath : filePaths) GPS::GPX::parseTrackFile(filePath); });
+    std::cout << "Batch size:         " << filePaths.size() << " files, " << megabytes << " MB\n"
+              << "Hardware threads:   " << std::thread::hardware_concurrency() << "\n"
+              << "Sequential:         " << filePaths.size() / sequentialTime << " files/s, "
+              << megabytes / sequentialTime << " MB/s" << std::endl;
+
+    for (unsigned int threadCount : {1, 2, 4, 8, 16, 32, 64})
+    {
+        GPS::ThreadPool pool {threadCount};
+        const double batchTime = bestTimeOf(repetitions, [&]{ GPS::GPX::parseTrackFiles(filePaths, pool); });
+        std::cout << "Pool of " << threadCount << " threads: " << filePaths.size() / batchTime << " files/s, "
+                  << megabytes / batchTime << " MB/s (speed-up " << sequentialTime / batchTime << ")" << std::endl;
+    }
+
+    std::filesystem::remove_all(directory);
+}
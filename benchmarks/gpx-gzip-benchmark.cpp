@@ -0,0 +1,45 @@
+#include <iostream>
+#include <sstream>
+
+#include "gpx-parser.h"
+#include "gpx-writer.h"
+#include "gzip.h"
+
+#include "benchmarks.h"
+
+/* Parsing gzip-compressed GPX (the sample track scaled up to ~100 MB before compression): first
+ * decompressing it to a string and parsing that, as callers had to before, then streaming it
+ * through the parser.  Heap use is the total allocated during one parse.
+ */
+void Benchmarks::gpxGzip()
+{
+    const std::string gpx = scaledSampleGPX(100'000'000);
+    std::ostringstream compressedText;
+    {
+        GPS::GzipOutputStream gzip {compressedText};
+        const double compressTime = bestTimeOf(1, [&]{ gzip << gpx; gzip.close(); });
+        std::cout << "Compression:        " << gpx.size() / 1e6 / compressTime << " MB/s" << std::endl;
+    }
+    const std::string compressed = compressedText.str();
+    const double megabytes = gpx.size() / 1e6;
+    const unsigned int repetitions = 3;
+
+    auto measure = [&](auto function) {
+        const std::size_t bytesBefore = allocatedBytes();
+        const double time = bestTimeOf(repetitions, function);
+        return std::make_pair(megabytes / time, (allocatedBytes() - bytesBefore) / repetitions / 1e6);
+    };
+
+    const auto [wholeRate, wholeMegabytes] = measure([&]{
+        std::string text;
+        GPS::GzipInflater inflater;
+        inflater.feed(compressed, [&text](std::string_view chunk) { text += chunk; });
+        inflater.finish();
+        GPS::GPX::parseTrackString(text);
+    });
+    const auto [streamedRate, streamedMegabytes] = measure([&]{ GPS::GPX::parseTrackString(compressed); });
+
+    std::cout << "Document size:      " << megabytes << " MB, " << compressed.size() / 1e6 << " MB compressed\n"
+              << "Decompress, parse:  " << wholeRate << " MB/s, " << wholeMegabytes << " MB allocated\n"
+              << "Streamed:           " << streamedRate << " MB/s, " << streamedMegabytes << " MB allocated" << std::endl;
+}
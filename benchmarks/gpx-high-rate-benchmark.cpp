@@ -0,0 +1,39 @@
+#include <iostream>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "gpx-writer.h"
+#include "track-decimator.h"
+
+#include "benchmarks.h"
+
+/* Parsing an hour-long track logged at 100 Hz (360,000 points, each 10 ms apart): keeping every
+ * point, then decimating to one point per second, either the first or the mean, as the track is
+ * parsed.  Heap use is the total allocated during one parse.
+ */
+void Benchmarks::gpxHighRate()
+{
+    const unsigned int pointsPerSecond = 100;
+    const unsigned int pointCount = 3600 * pointsPerSecond;
+    std::vector<GPS::Trackpoint> session;
+    session.reserve(pointCount);
+    for (unsigned int i = 0; i < pointCount; ++i)
+    {
+        session.push_back({GPS::Waypoint {54 + i * 1e-7, -0.7 + i * 1e-7, 300}, 946684800'000'000 + i * 10'000LL});
+    }
+    const std::string gpx = GPS::GPX::writeTrackString(session);
+    const double megabytes = gpx.size() / 1e6;
+
+    auto measure = [&](const char* label, const GPS::DecimationOptions& options) {
+        std::size_t pointsKept = 0;
+        const std::size_t bytesBefore = allocatedBytes();
+        const double time = bestTimeOf(1, [&]{ pointsKept = GPS::GPX::parseTrackString(gpx, options).size(); });
+        std::cout << label << megabytes / time << " MB/s, " << pointsKept << " points, "
+                  << (allocatedBytes() - bytesBefore) / 1e6 << " MB allocated" << std::endl;
+    };
+
+    std::cout << "Document size:      " << megabytes << " MB, " << pointCount << " points" << std::endl;
+    measure("Every point:        ", {});
+    measure("First each second:  ", {GPS::microsecondsPerSecond});
+    measure("Mean each second:   ", {GPS::microsecondsPerSecond, GPS::DecimationOptions::Mode::Average});
+}
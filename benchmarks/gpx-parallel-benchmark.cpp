@@ -0,0 +1,31 @@
+#include <iostream>
+#include <thread>
+
+#include "gpx-parser.h"
+#include "thread-pool.h"
+
+#include "benchmarks.h"
+
+/* Throughput of the parallel GPX parser on the sample track scaled up to ~200 MB, for increasing
+ * pool sizes.  The calling thread parses the first piece and stitches the others together, so a
+ * pool of N threads keeps N+1 cores busy.
+ */
+void Benchmarks::gpxParallel()
+{
+    const std::string gpx = scaledSampleGPX(200'000'000);
+    const double megabytes = gpx.size() / 1e6;
+    const unsigned int repetitions = 3;
+
+    const double sequentialTime = bestTimeOf(repetitions, [&]{ GPS::GPX::parseTrackString(gpx); });
+    std::cout << "Document size:      " << megabytes << " MB\n"
+              << "Hardware threads:   " << std::thread::hardware_concurrency() << "\n"
+              << "Sequential:         " << megabytes / sequentialTime << " MB/s" << std::endl;
+
+    for (unsigned int threadCount : {1, 2, 4, 8, 16})
+    {
+        GPS::ThreadPool pool {threadCount};
+        const double parallelTime = bestTimeOf(repetitions, [&]{ GPS::GPX::parseTrackString(gpx, pool); });
+        std::cout << "Pool of " << threadCount << " threads: " << megabytes / parallelTime << " MB/s"
+                  << " (speed-up " << sequentialTime / parallelTime << ")" << std::endl;
+    }
+}
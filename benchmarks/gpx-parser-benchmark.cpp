@@ -0,0 +1,50 @@
+#include <iostream>
+
+#include "xml-parser.h"
+#include "gpx-parser.h"
+
+#include "benchmarks.h"
+
+/* Throughput and heap use of the GPX track reader on the sample track scaled up to ~100 MB.
+ *
+ * The previous reader built the whole XML::Element tree and then walked it, so building the tree
+ * alone (first line) is a lower bound on its cost.  The streaming reader builds no tree.
+ */
+void Benchmarks::gpxParser()
+{
+    const std::string gpx = scaledSampleGPX(100'000'000);
+    const double megabytes = gpx.size() / 1e6;
+    const unsigned int repetitions = 3;
+
+    auto measure = [&](auto function) {
+        const std::size_t bytesBefore = allocatedBytes();
+        const double time = bestTimeOf(repetitions, function);
+        return std::make_pair(megabytes / time, (allocatedBytes() - bytesBefore) / repetitions / 1e6);
+    };
+
+    const auto [treeRate, treeMegabytes] = measure([&]{
+        XML::Parser parser {std::string_view{gpx}};
+        parser.parseRootElement();
+    });
+
+    std::size_t pointCount = 0;
+    const auto [readerRate, readerMegabytes] = measure([&]{
+        pointCount = GPS::GPX::parseTrackString(gpx).size();
+    });
+
+    const auto [reservedRate, reservedMegabytes] = measure([&]{
+        std::vector<GPS::Trackpoint> trackPoints;
+        trackPoints.reserve(pointCount);
+        GPS::GPX::parseTrackString(gpx, trackPoints);
+    });
+
+    const auto [sinkRate, sinkMegabytes] = measure([&]{
+        GPS::GPX::parseTrackString(gpx, [](const GPS::Trackpoint&) {});
+    });
+
+    std::cout << "Document size:                   " << megabytes << " MB, " << pointCount << " points\n"
+              << "Element tree only:               " << treeRate << " MB/s, " << treeMegabytes << " MB allocated\n"
+              << "parseTrackString:                " << readerRate << " MB/s, " << readerMegabytes << " MB allocated\n"
+              << "parseTrackString (reserved):     " << reservedRate << " MB/s, " << reservedMegabytes << " MB allocated\n"
+              << "parseTrackString (sink):         " << sinkRate << " MB/s, " << sinkMegabytes << " MB allocated" << std::endl;
+}
@@ -0,0 +1,30 @@
+#include <fstream>
+#include <iostream>
+
+#include "gpx-parser.h"
+#include "gpx-writer.h"
+
+#include "benchmarks.h"
+
+/* Throughput and heap use of the GPX writer, for the points of the sample track scaled up to
+ * ~100 MB, written to a string and to a stream that discards its output.
+ */
+void Benchmarks::gpxWriter()
+{
+    const std::vector<GPS::Trackpoint> trackPoints = GPS::GPX::parseTrackString(scaledSampleGPX(100'000'000));
+    const unsigned int repetitions = 3;
+
+    std::string gpx;
+    const double stringTime = bestTimeOf(repetitions, [&]{ gpx = GPS::GPX::writeTrackString(trackPoints); });
+    const double megabytes = gpx.size() / 1e6;
+
+    std::ofstream discard {"/dev/null"};
+    const std::size_t allocationsBefore = allocationCount();
+    const double streamTime = bestTimeOf(repetitions, [&]{ GPS::GPX::writeTrack(discard, trackPoints); });
+    const std::size_t streamAllocations = (allocationCount() - allocationsBefore) / repetitions;
+
+    std::cout << "Points:             " << trackPoints.size() << "\n"
+              << "Document size:      " << megabytes << " MB\n"
+              << "writeTrackString:   " << megabytes / stringTime << " MB/s, " << trackPoints.size() / stringTime / 1e6 << " M points/s\n"
+              << "writeTrack:         " << megabytes / streamTime << " MB/s, " << streamAllocations << " allocations per document" << std::endl;
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "haversine.h"
+#include "point-columns.h"
+
+#include "benchmarks.h"
+
+/* Throughput, in distances per second, of the horizontal distance of every leg of a track of four
+ * million points (the sample track walked repeatedly) and of the distance of every point from the
+ * start: one Waypoint::horizontalDistanceBetween() call per distance, and each available Kernel over
+ * the point columns.
+ */
+void Benchmarks::haversine()
+{
+    const std::vector<GPS::Trackpoint> lap = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    std::vector<GPS::Trackpoint> trackPoints;
+    while (trackPoints.size() < 4'000'000) trackPoints.insert(trackPoints.end(), lap.begin(), lap.end());
+    const GPS::PointColumns columns {trackPoints};
+    const std::size_t legCount = columns.size() - 1;
+    const GPS::Waypoint origin = columns.waypoint(0);
+    const unsigned int repetitions = 5;
+
+    std::vector<GPS::metres> expectedLegs (legCount), expectedFromOrigin (columns.size());
+    const double waypointLegsTime = bestTimeOf(repetitions, [&]{
+        for (std::size_t i = 0; i < legCount; ++i)
+        {
+            expectedLegs[i] = GPS::Waypoint::horizontalDistanceBetween(trackPoints[i].waypoint, trackPoints[i+1].waypoint);
+        }
+    });
+    const double waypointFromTime = bestTimeOf(repetitions, [&]{
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            expectedFromOrigin[i] = GPS::Waypoint::horizontalDistanceBetween(origin, trackPoints[i].waypoint);
+        }
+    });
+
+    auto report = [&](const char* name, double legsTime, double fromTime, double legsError, double fromError) {
+        std::cout << std::left << std::setw(10) << name << std::right << std::scientific << std::setprecision(3)
+                  << std::setw(14) << legCount / legsTime << std::setw(14) << columns.size() / fromTime
+                  << std::setw(16) << legsError << std::setw(16) << fromError << std::endl;
+    };
+    auto greatestDifference = [](const std::vector<GPS::metres>& distances, const std::vector<GPS::metres>& expected) {
+        double greatest = 0;
+        for (std::size_t i = 0; i < distances.size(); ++i) greatest = std::max(greatest, std::abs(distances[i] - expected[i]));
+        return greatest;
+    };
+
+    std::cout << "distances/s          legs   from start   legs max diff   from max diff (m)" << std::endl;
+    report("Waypoint", waypointLegsTime, waypointFromTime, 0, 0);
+    for (const GPS::Haversine::Kernel& kernel : GPS::Haversine::availableKernels())
+    {
+        std::vector<GPS::metres> legs (legCount), fromOrigin (columns.size());
+        const double legsTime = bestTimeOf(repetitions, [&]{
+            kernel.distancesBetween(columns.latitudes.data(), columns.longitudes.data(),
+                                    columns.latitudes.data() + 1, columns.longitudes.data() + 1, legs.data(), legCount);
+        });
+        const double fromTime = bestTimeOf(repetitions, [&]{
+            kernel.distancesFrom(origin.latitude(), origin.longitude(), columns.latitudes.data(), columns.longitudes.data(),
+                                 fromOrigin.data(), fromOrigin.size());
+        });
+        report(kernel.name, legsTime, fromTime, greatestDifference(legs, expectedLegs), greatestDifference(fromOrigin, expectedFromOrigin));
+    }
+    std::cout << std::defaultfloat << std::setprecision(6)
+              << "Selected: " << GPS::Haversine::selectedKernel().name << std::endl;
+}
@@ -0,0 +1,37 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "gpx-parser.h"
+#include "track-cache.h"
+
+#include "benchmarks.h"
+
+/* Re-ingesting the same ~100 MB of GPX, as a nightly batch job does: hashing it, then parsing it
+ * through an empty cache (a miss, which also stores the points) and through a warm one (a hit).
+ */
+void Benchmarks::trackCache()
+{
+    const std::string gpx = scaledSampleGPX(100'000'000);
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "track-cache-benchmark";
+    const std::string gpxPath = (directory / "track.gpx").string();
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::ofstream {gpxPath, std::ios::binary} << gpx;
+    const double megabytes = gpx.size() / 1e6;
+
+    std::uint64_t hash = 0;
+    const double hashTime = bestTimeOf(3, [&]{ hash = GPS::contentHash(gpx); });
+    const double parseTime = bestTimeOf(1, [&]{ GPS::GPX::parseTrackFile(gpxPath); });
+
+    GPS::TrackCache cache {(directory / "cache").string()};
+    const double missTime = bestTimeOf(1, [&]{ cache.parseTrackFile(gpxPath); });
+    const double hitTime = bestTimeOf(3, [&]{ cache.parseTrackFile(gpxPath); });
+
+    std::cout << "Document size:      " << megabytes << " MB (hash " << std::hex << hash << std::dec << ")\n"
+              << "contentHash:        " << megabytes / hashTime << " MB/s\n"
+              << "parseTrackFile:     " << parseTime * 1000 << " ms\n"
+              << "Cache miss:         " << missTime * 1000 << " ms\n"
+              << "Cache hit:          " << hitTime * 1000 << " ms (" << cache.hits() << " hits, " << cache.misses() << " misses)" << std::endl;
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,33 @@
+#include <iostream>
+
+#include "gpx-parser.h"
+#include "track-codec.h"
+
+#include "benchmarks.h"
+
+/* Size and speed of the columnar track codec on the sample track scaled up to ~100 MB of GPX.
+ * Decoding speed is measured in bytes of Trackpoints produced.
+ */
+void Benchmarks::trackCodec()
+{
+    const std::string gpx = scaledSampleGPX(100'000'000);
+    const std::vector<GPS::Trackpoint> trackPoints = GPS::GPX::parseTrackString(gpx);
+    const double trackpointMegabytes = trackPoints.size() * sizeof(GPS::Trackpoint) / 1e6;
+    const unsigned int repetitions = 5;
+
+    std::string encoding;
+    const double encodeTime = bestTimeOf(repetitions, [&]{ encoding = GPS::encodeTrack(trackPoints); });
+
+    std::vector<GPS::Trackpoint> decoded;
+    decoded.reserve(trackPoints.size());
+    const double decodeTime = bestTimeOf(repetitions, [&]{ decoded.clear(); GPS::decodeTrack(encoding, decoded); });
+
+    std::cout << "Points:             " << trackPoints.size() << "\n"
+              << "GPX text:           " << gpx.size() / 1e6 << " MB\n"
+              << "Trackpoints:        " << trackpointMegabytes << " MB\n"
+              << "Encoding:           " << encoding.size() / 1e6 << " MB ("
+              << static_cast<double>(encoding.size()) / trackPoints.size() << " bytes per point, "
+              << static_cast<double>(gpx.size()) / encoding.size() << "x smaller than GPX)\n"
+              << "Encode:             " << trackpointMegabytes / encodeTime << " MB/s of Trackpoints\n"
+              << "Decode:             " << trackpointMegabytes / decodeTime << " MB/s of Trackpoints" << std::endl;
+}
@@ -0,0 +1,87 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "point-columns.h"
+#include "track.h"
+#include "track-leg.h"
+
+#include "benchmarks.h"
+
+/* Queries on a track of four million points (the sample track walked repeatedly), with the points
+ * stored as Trackpoints and stored by field: the six extreme-waypoint queries and the highest and
+ * lowest points, each as a scan over the Trackpoints and from the point columns; and computing the
+ * values of every leg from the Trackpoints and from the columns.
+ */
+void Benchmarks::trackColumns()
+{
+    const std::vector<GPS::Trackpoint> lap = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const GPS::microseconds lapTime = lap.back().timeStamp - lap.front().timeStamp + GPS::microsecondsPerSecond;
+    std::vector<GPS::Trackpoint> trackPoints;
+    for (GPS::microseconds offset = 0; trackPoints.size() < 4'000'000; offset += lapTime)
+    {
+        for (const GPS::Trackpoint& trackPoint : lap) trackPoints.push_back({trackPoint.waypoint, trackPoint.timeStamp + offset});
+    }
+    const GPS::Track track {trackPoints};
+    const unsigned int repetitions = 5;
+
+    // As the queries were written before the points were stored by field.
+    auto earliestWithGreatest = [&](auto key) {
+        std::size_t best = 0;
+        for (std::size_t i = 1; i < trackPoints.size(); ++i)
+        {
+            if (key(trackPoints[i].waypoint) > key(trackPoints[best].waypoint)) best = i;
+        }
+        return trackPoints[best].waypoint;
+    };
+
+    double checksum = 0;
+    const double pointScanTime = bestTimeOf(repetitions, [&]{
+        checksum = earliestWithGreatest([](const GPS::Waypoint& w) { return w.altitude(); }).altitude()
+                 + earliestWithGreatest([](const GPS::Waypoint& w) { return -w.altitude(); }).altitude()
+                 + earliestWithGreatest([](const GPS::Waypoint& w) { return w.latitude(); }).latitude()
+                 + earliestWithGreatest([](const GPS::Waypoint& w) { return -w.latitude(); }).latitude()
+                 + earliestWithGreatest([](const GPS::Waypoint& w) { return w.longitude(); }).longitude()
+                 + earliestWithGreatest([](const GPS::Waypoint& w) { return -w.longitude(); }).longitude()
+                 + earliestWithGreatest([](const GPS::Waypoint& w) { return -std::abs(w.latitude()); }).latitude()
+                 + earliestWithGreatest([](const GPS::Waypoint& w) { return std::abs(w.latitude()); }).latitude();
+    });
+    const double pointScanChecksum = checksum;
+
+    const double buildTime = bestTimeOf(repetitions, [&]{ GPS::PointColumns columns {trackPoints}; });
+    track.highestWaypoint();
+    const double columnScanTime = bestTimeOf(repetitions, [&]{
+        checksum = track.highestWaypoint().altitude() + track.lowestWaypoint().altitude()
+                 + track.mostNorthelyWaypoint().latitude() + track.mostSoutherlyWaypoint().latitude()
+                 + track.mostEasterlyWaypoint().longitude() + track.mostWesterlyWaypoint().longitude()
+                 + track.mostEquatorialWaypoint().latitude() + track.leastEquatorialWaypoint().latitude();
+    });
+
+    const double pointLegsTime = bestTimeOf(repetitions, [&]{
+        const std::size_t legCount = trackPoints.size() - 1;
+        std::vector<GPS::metres> distances (legCount), altitudeChanges (legCount);
+        std::vector<GPS::microseconds> durations (legCount);
+        std::vector<GPS::speed> speeds (legCount);
+        std::vector<GPS::degrees> gradients (legCount);
+        for (std::size_t i = 0; i < legCount; ++i)
+        {
+            const GPS::Leg leg {trackPoints[i], trackPoints[i+1]};
+            distances[i] = leg.distance();
+            altitudeChanges[i] = leg.altitudeChange;
+            durations[i] = leg.duration;
+            speeds[i] = leg.averageSpeed();
+            gradients[i] = leg.gradient();
+        }
+    });
+    const GPS::PointColumns columns {trackPoints};
+    const double columnLegsTime = bestTimeOf(repetitions, [&]{ GPS::LegColumns legs {columns}; });
+
+    std::cout << "Track size:                     " << trackPoints.size() << " points\n"
+              << "8 extreme queries, Trackpoints: " << pointScanTime * 1e3 << " ms\n"
+              << "8 extreme queries, columns:     " << columnScanTime * 1e3 << " ms ("
+              << (checksum == pointScanChecksum ? "same" : "DIFFERENT") << " results)\n"
+              << "Building the point columns:     " << buildTime * 1e3 << " ms\n"
+              << "Legs from Trackpoints:          " << pointLegsTime * 1e3 << " ms\n"
+              << "Legs from columns:              " << columnLegsTime * 1e3 << " ms" << std::endl;
+}
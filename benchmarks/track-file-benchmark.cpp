@@ -0,0 +1,36 @@
+#include <filesystem>
+#include <iostream>
+
+#include "gpx-parser.h"
+#include "track.h"
+#include "track-file.h"
+
+#include "benchmarks.h"
+
+/* Time to reopen a track of a million points: parsing its GPX text, against opening it in the
+ * binary track file format (with the file already in the page cache).
+ */
+void Benchmarks::trackFile()
+{
+    const std::string gpx = scaledSampleGPX(112'000'000);
+    const std::string filePath = (std::filesystem::temp_directory_path() / "track-file-benchmark.track").string();
+    const unsigned int repetitions = 5;
+
+    std::vector<GPS::Trackpoint> trackPoints;
+    const double parseTime = bestTimeOf(repetitions, [&]{ trackPoints = GPS::GPX::parseTrackString(gpx); });
+    const double writeTime = bestTimeOf(repetitions, [&]{ GPS::writeTrackFile(filePath, trackPoints); });
+
+    std::size_t pointCount = 0;
+    const double openTime = bestTimeOf(repetitions, [&]{ pointCount = GPS::TrackFile {filePath}.trackPoints().size(); });
+    const double trackTime = bestTimeOf(repetitions, [&]{ GPS::Track track {GPS::readTrackFile(filePath)}; });
+
+    std::cout << "Track size:                 " << trackPoints.size() << " points (" << pointCount << " reopened)\n"
+              << "GPX text:                   " << gpx.size() / 1e6 << " MB\n"
+              << "Track file:                 " << std::filesystem::file_size(filePath) / 1e6 << " MB\n"
+              << "parseTrackString:           " << parseTime * 1e3 << " ms\n"
+              << "writeTrackFile:             " << writeTime * 1e3 << " ms\n"
+              << "TrackFile (mapped):         " << openTime * 1e3 << " ms\n"
+              << "Track from readTrackFile:   " << trackTime * 1e3 << " ms" << std::endl;
+
+    std::filesystem::remove(filePath);
+}
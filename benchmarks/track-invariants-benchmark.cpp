@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track.h"
+
+#include "benchmarks.h"
+
+/* Time queries on a track of four million points (the sample track walked repeatedly), checking that
+ * the times increase by a scan on every query and by the invariants found when the Track was built;
+ * and rejecting a batch of small uploads whose times stand still, by building a Track and catching
+ * the exception from its first query, and by Track::validated().
+ */
+void Benchmarks::trackInvariants()
+{
+    const std::vector<GPS::Trackpoint> lap = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const GPS::microseconds lapTime = lap.back().timeStamp - lap.front().timeStamp + GPS::microsecondsPerSecond;
+    std::vector<GPS::Trackpoint> trackPoints;
+    for (GPS::microseconds offset = 0; trackPoints.size() < 4'000'000; offset += lapTime)
+    {
+        for (const GPS::Trackpoint& trackPoint : lap) trackPoints.push_back({trackPoint.waypoint, trackPoint.timeStamp + offset});
+    }
+    const GPS::Track track {trackPoints};
+    const GPS::microseconds start = trackPoints.front().timeStamp;
+    const GPS::microseconds span = trackPoints.back().timeStamp - start;
+    const unsigned int queries = 100;
+    const unsigned int repetitions = 5;
+
+    // As the queries were written before the invariants were found on construction.
+    auto scanningLastWaypointBefore = [&](GPS::microseconds targetTime) {
+        for (std::size_t i = 1; i < trackPoints.size(); ++i)
+        {
+            if (trackPoints[i].timeStamp <= trackPoints[i-1].timeStamp) throw std::domain_error("Times must increase.");
+        }
+        const auto after = std::partition_point(trackPoints.begin(), trackPoints.end(), [targetTime](const GPS::Trackpoint& p) {
+            return p.timeStamp < targetTime;
+        });
+        return std::prev(after)->waypoint;
+    };
+
+    double checksum = 0;
+    const double scanningTime = bestTimeOf(repetitions, [&]{
+        for (unsigned int q = 1; q <= queries; ++q) checksum += scanningLastWaypointBefore(start + span / queries * q).altitude();
+    });
+    const double invariantsTime = bestTimeOf(repetitions, [&]{
+        for (unsigned int q = 1; q <= queries; ++q) checksum += track.lastWaypointBefore(start + span / queries * q).altitude();
+    });
+
+    const std::vector<GPS::Trackpoint> badUpload = {lap[0], lap[1], lap[1], lap[2]};
+    const unsigned int uploads = 10'000;
+    std::size_t rejected = 0;
+    const double throwingTime = bestTimeOf(repetitions, [&]{
+        rejected = 0;
+        for (unsigned int u = 0; u < uploads; ++u)
+        {
+            try
+            {
+                GPS::Track {badUpload}.averageSpeed();
+            }
+            catch (const std::domain_error&)
+            {
+                ++rejected;
+            }
+        }
+    });
+    const double validatedTime = bestTimeOf(repetitions, [&]{
+        rejected = 0;
+        for (unsigned int u = 0; u < uploads; ++u)
+        {
+            if (! GPS::Track::validated(badUpload)) ++rejected;
+        }
+    });
+
+    std::cout << "Track size:                           " << trackPoints.size() << " points\n"
+              << queries << " lastWaypointBefore(), scanning:    " << scanningTime * 1e3 << " ms\n"
+              << queries << " lastWaypointBefore(), invariants:  " << invariantsTime * 1e3 << " ms\n"
+              << uploads << " bad uploads, by exception:       " << throwingTime * 1e3 << " ms\n"
+              << uploads << " bad uploads, Track::validated(): " << validatedTime * 1e3 << " ms ("
+              << rejected << " rejected)" << std::endl;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track.h"
+
+#include "benchmarks.h"
+
+/* Interactive queries on a loaded track of a million points (the sample track walked repeatedly):
+ * a round of ten queries over the legs when the legs must be computed (the cache released before
+ * each query), the first round on a fresh track (which builds the cache), and a later round.
+ */
+void Benchmarks::trackLegs()
+{
+    const std::vector<GPS::Trackpoint> lap = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const GPS::microseconds lapTime = lap.back().timeStamp - lap.front().timeStamp + GPS::microsecondsPerSecond;
+    std::vector<GPS::Trackpoint> trackPoints;
+    for (GPS::microseconds offset = 0; trackPoints.size() < 1'000'000; offset += lapTime)
+    {
+        for (const GPS::Trackpoint& trackPoint : lap) trackPoints.push_back({trackPoint.waypoint, trackPoint.timeStamp + offset});
+    }
+    const GPS::Track track {trackPoints};
+
+    double checksum = 0;
+    auto queries = [&](bool releaseEachTime) {
+        auto query = [&](double result) {
+            checksum += result;
+            if (releaseEachTime) track.releaseCaches();
+        };
+        query(track.totalLength());
+        query(track.averageSpeed());
+        query(track.maxSpeed());
+        query(track.maxRateOfAscent());
+        query(track.steepestGradient());
+        query(track.restingTime(15));
+        query(track.longestTravellingPeriod(20));
+        query(track.averageTravellingSpeed(20));
+        query(track.proportionRestingTime(15));
+        query(track.durationBeforeTravellingBegins(20));
+    };
+
+    const double uncachedTime = bestTimeOf(3, [&]{ queries(true); });
+    const double firstTime = bestTimeOf(1, [&]{ track.releaseCaches(); queries(false); });
+    const double cachedTime = bestTimeOf(3, [&]{ queries(false); });
+
+    std::cout << "Track size:                " << trackPoints.size() << " points\n"
+              << "10 queries, uncached:      " << uncachedTime * 1e3 << " ms\n"
+              << "10 queries, first round:   " << firstTime * 1e3 << " ms\n"
+              << "10 queries, cached:        " << cachedTime * 1e3 << " ms\n"
+              << "(checksum " << checksum << ")" << std::endl;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track.h"
+#include "track-summary.h"
+
+#include "benchmarks.h"
+
+/* Analysing a track of a million points (the sample track walked repeatedly, one lap after another):
+ * calling every Track query that a TrackSummary covers, one after another, against building the
+ * summary and reading every result from it.
+ */
+void Benchmarks::trackSummary()
+{
+    const std::vector<GPS::Trackpoint> lap = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const GPS::microseconds lapTime = lap.back().timeStamp - lap.front().timeStamp + GPS::microsecondsPerSecond;
+    std::vector<GPS::Trackpoint> trackPoints;
+    for (GPS::microseconds offset = 0; trackPoints.size() < 1'000'000; offset += lapTime)
+    {
+        for (const GPS::Trackpoint& trackPoint : lap) trackPoints.push_back({trackPoint.waypoint, trackPoint.timeStamp + offset});
+    }
+    const GPS::Track track {trackPoints};
+    const GPS::TrackSummaryOptions options {15, 20, lap.front().waypoint, 100};
+    const GPS::Waypoint target = *options.targetWaypoint;
+    const unsigned int repetitions = 3;
+
+    double checksum = 0;
+    const double individualTime = bestTimeOf(repetitions, [&]{
+        checksum = track.totalTime() + track.netHeightGain() + track.totalHeightGain() + track.netLength()
+                 + track.totalLength() + track.averageSpeed() + track.highestWaypoint().altitude()
+                 + track.lowestWaypoint().altitude() + track.mostNorthelyWaypoint().latitude()
+                 + track.mostSoutherlyWaypoint().latitude() + track.mostEasterlyWaypoint().longitude()
+                 + track.mostWesterlyWaypoint().longitude() + track.mostEquatorialWaypoint().latitude()
+                 + track.leastEquatorialWaypoint().latitude() + track.maxSpeed() + track.maxRateOfAscent()
+                 + track.maxRateOfDescent() + track.maxGradient() + track.minGradient() + track.steepestGradient()
+                 + track.nearestWaypointTo(target).latitude() + track.farthestWaypointFrom(target).latitude()
+                 + track.numberOfWaypointsNear(target, options.nearDistance)
+                 + track.proportionOfWaypointsNear(target, options.nearDistance)
+                 + track.restingTime(options.restingSpeedThreshold) + track.travellingTime(options.travellingSpeedThreshold)
+                 + track.longestRestingPeriod(options.restingSpeedThreshold)
+                 + track.longestTravellingPeriod(options.travellingSpeedThreshold)
+                 + track.averageRestingPeriod(options.restingSpeedThreshold)
+                 + track.averageTravellingPeriod(options.travellingSpeedThreshold)
+                 + track.proportionRestingTime(options.restingSpeedThreshold)
+                 + track.proportionTravellingTime(options.travellingSpeedThreshold)
+                 + track.averageTravellingSpeed(options.travellingSpeedThreshold)
+                 + track.durationBeforeTravellingBegins(options.travellingSpeedThreshold);
+    });
+    const double individualChecksum = checksum;
+
+    const double summaryTime = bestTimeOf(repetitions, [&]{
+        const GPS::TrackSummary summary {track, options};
+        checksum = summary.totalTime() + summary.netHeightGain() + summary.totalHeightGain() + summary.netLength()
+                 + summary.totalLength() + summary.averageSpeed() + summary.highestWaypoint().altitude()
+                 + summary.lowestWaypoint().altitude() + summary.mostNorthelyWaypoint().latitude()
+                 + summary.mostSoutherlyWaypoint().latitude() + summary.mostEasterlyWaypoint().longitude()
+                 + summary.mostWesterlyWaypoint().longitude() + summary.mostEquatorialWaypoint().latitude()
+                 + summary.leastEquatorialWaypoint().latitude() + summary.maxSpeed() + summary.maxRateOfAscent()
+                 + summary.maxRateOfDescent() + summary.maxGradient() + summary.minGradient() + summary.steepestGradient()
+                 + summary.nearestWaypointTo().latitude() + summary.farthestWaypointFrom().latitude()
+                 + summary.numberOfWaypointsNear() + summary.proportionOfWaypointsNear()
+                 + summary.restingTime() + summary.travellingTime()
+                 + summary.longestRestingPeriod() + summary.longestTravellingPeriod()
+                 + summary.averageRestingPeriod() + summary.averageTravellingPeriod()
+                 + summary.proportionRestingTime() + summary.proportionTravellingTime()
+                 + summary.averageTravellingSpeed() + summary.durationBeforeTravellingBegins();
+    });
+
+    std::cout << "Track size:             " << trackPoints.size() << " points\n"
+              << "34 Track queries:       " << individualTime * 1e3 << " ms\n"
+              << "TrackSummary:           " << summaryTime * 1e3 << " ms ("
+              << (checksum == individualChecksum ? "same" : "DIFFERENT") << " results)" << std::endl;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+
+#include "xml-parser.h"
+#include "xml-document.h"
+
+#include "benchmarks.h"
+
+namespace
+{
+  struct HeapUse
+  {
+      std::size_t allocations;
+      std::size_t bytes;
+  };
+
+  template <typename Function>
+  HeapUse heapUseOf(Function function)
+  {
+      const std::size_t allocationsBefore = Benchmarks::allocationCount();
+      const std::size_t bytesBefore = Benchmarks::allocatedBytes();
+      function();
+      return {Benchmarks::allocationCount() - allocationsBefore, Benchmarks::allocatedBytes() - bytesBefore};
+  }
+}
+
+/* Heap use and parse time of the XML::Element tree against the arena-backed XML::Document,
+ * for the sample track scaled up to ~20 MB.  Heap use is reported net of what the parser
+ * itself allocates while producing events.
+ */
+void Benchmarks::xmlDocument()
+{
+    const std::string gpx = scaledSampleGPX(20'000'000);
+    const double megabytes = gpx.size() / 1e6;
+
+    auto parseEvents = [&]{
+        XML::Parser parser {std::string_view{gpx}};
+        while (parser.nextEvent().type != XML::Event::Type::EndOfDocument) {}
+    };
+    auto parseElementTree = [&]{
+        XML::Parser parser {std::string_view{gpx}};
+        parser.parseRootElement();
+    };
+    std::size_t arenaSize = 0;
+    auto parseDocument = [&]{
+        XML::Parser parser {std::string_view{gpx}};
+        XML::Document document {parser};
+        arenaSize = document.bytesReserved();
+    };
+
+    const HeapUse parserHeapUse = heapUseOf(parseEvents);
+    const HeapUse elementHeapUse = heapUseOf(parseElementTree);
+    const HeapUse documentHeapUse = heapUseOf(parseDocument);
+
+    const double elementTime = bestTimeOf(3, parseElementTree);
+    const double documentTime = bestTimeOf(3, parseDocument);
+
+    std::cout << "Document size:      " << megabytes << " MB\n"
+              << "XML::Element tree:  " << elementHeapUse.allocations - parserHeapUse.allocations << " allocations, "
+                                       << (elementHeapUse.bytes - parserHeapUse.bytes) / 1e6 << " MB allocated, "
+                                       << megabytes / elementTime << " MB/s\n"
+              << "XML::Document:      " << documentHeapUse.allocations - parserHeapUse.allocations << " allocations, "
+                                       << (documentHeapUse.bytes - parserHeapUse.bytes) / 1e6 << " MB allocated ("
+                                       << arenaSize / 1e6 << " MB arena), "
+                                       << megabytes / documentTime << " MB/s" << std::endl;
+}
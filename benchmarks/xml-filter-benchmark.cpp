@@ -0,0 +1,70 @@
+#include <iostream>
+
+#include "xml-parser.h"
+#include "xml-path-filter.h"
+#include "gpx-track-reader.h"
+
+#include "benchmarks.h"
+
+namespace
+{
+  // Garmin-style per-point extensions, which GPS::GPX never reads.
+  const std::string pointExtensions =
+      "<extensions><gpxtpx:TrackPointExtension><gpxtpx:atemp>12.5</gpxtpx:atemp>"
+      "<gpxtpx:hr>142</gpxtpx:hr><gpxtpx:cad>88</gpxtpx:cad></gpxtpx:TrackPointExtension></extensions>";
+
+  std::string withPointExtensions(const std::string& gpx)
+  {
+      const std::string endOfTime = "</time>";
+      std::string extended;
+      extended.reserve(gpx.size() * 2);
+      std::size_t copied = 0;
+      for (std::size_t found = gpx.find(endOfTime); found != std::string::npos; found = gpx.find(endOfTime, copied))
+      {
+          const std::size_t afterTime = found + endOfTime.size();
+          extended.append(gpx, copied, afterTime - copied);
+          extended += pointExtensions;
+          copied = afterTime;
+      }
+      extended.append(gpx, copied);
+      return extended;
+  }
+}
+
+/* Parse time and heap use with and without the GPX track filter, for the sample track scaled up
+ * to ~50 MB and then given Garmin-style extensions on every point (more than doubling its size).
+ */
+void Benchmarks::xmlFilter()
+{
+    const std::string gpx = withPointExtensions(scaledSampleGPX(50'000'000));
+    const double megabytes = gpx.size() / 1e6;
+    const unsigned int repetitions = 3;
+
+    auto timeAndAllocations = [&](const XML::PathFilter& filter, bool buildTree) {
+        const std::size_t allocationsBefore = allocationCount();
+        const double time = bestTimeOf(repetitions, [&]{
+            XML::Parser parser {std::string_view{gpx}};
+            parser.setFilter(filter);
+            if (buildTree)
+            {
+                parser.parseRootElement();
+            }
+            else
+            {
+                while (parser.nextEvent().type != XML::Event::Type::EndOfDocument) {}
+            }
+        });
+        return std::make_pair(megabytes / time, (allocationCount() - allocationsBefore) / repetitions);
+    };
+
+    const auto [treeRate, treeAllocations] = timeAndAllocations({}, true);
+    const auto [filteredTreeRate, filteredTreeAllocations] = timeAndAllocations(GPS::GPX::TrackReader::filter(), true);
+    const auto [eventRate, eventAllocations] = timeAndAllocations({}, false);
+    const auto [filteredEventRate, filteredEventAllocations] = timeAndAllocations(GPS::GPX::TrackReader::filter(), false);
+
+    std::cout << "Document size:               " << megabytes << " MB\n"
+              << "Element tree, everything:    " << treeRate << " MB/s, " << treeAllocations << " allocations\n"
+              << "Element tree, track filter:  " << filteredTreeRate << " MB/s, " << filteredTreeAllocations << " allocations\n"
+              << "Events, everything:          " << eventRate << " MB/s, " << eventAllocations << " allocations\n"
+              << "Events, track filter:        " << filteredEventRate << " MB/s, " << filteredEventAllocations << " allocations" << std::endl;
+}
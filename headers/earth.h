@@ -47,6 +47,13 @@ namespace GPS
       degrees longitudeSubtendedBy(metres eastWestDistance, degrees lat);
 
 
+      /* The Haversine Formula, for two points whose latitudes and longitudes are in radians, given
+       * with the cosines of their latitudes.  Waypoint::horizontalDistanceBetween() uses this, as must
+       * anything that works from precomputed values yet needs to agree with it exactly.
+       */
+      metres haversineDistance(radians lat1, radians lon1, double cosLat1, radians lat2, radians lon2, double cosLat2);
+
+
       /* Check that the altitude value is no lower than the centre of the Earth.
        * No upper limit is imposed.
        */
@@ -0,0 +1,77 @@
+#ifndef GPS_GPX_BATCH_PARSER_H
+#define GPS_GPX_BATCH_PARSER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "thread-pool.h"
+#include "trackpoint.h"
+
+namespace GPS::GPX
+{
+  // The track from one document of a batch, or the exception that parsing it threw.
+  struct BatchResult
+  {
+      std::vector<GPS::Trackpoint> trackPoints;
+      std::exception_ptr error;
+
+      bool succeeded() const { return ! error; }
+  };
+
+  struct BatchLimits
+  {
+      // The most documents parsed at once; 0 means one per thread of the pool.
+      unsigned int maxDocumentsInFlight = 0;
+
+      /* The most document text held at once, in bytes.  A document larger than this is only started
+       * once every other document has finished.
+       */
+      std::size_t maxBytesInFlight = std::size_t {1} << 30;
+  };
+
+  /* Running totals for batches.  They may be read from any thread while a batch is being parsed,
+   * and accumulate over every batch that they are passed to.  The clock starts on construction.
+   */
+  class BatchCounters
+  {
+    public:
+      BatchCounters();
+
+      std::size_t documents() const; // Including those that failed.
+      std::size_t failedDocuments() const;
+      std::size_t bytes() const;
+
+      double elapsedSeconds() const;
+      double documentsPerSecond() const;
+      double megabytesPerSecond() const;
+
+      void recordDocument(std::size_t bytes, bool failed);
+
+    private:
+      std::chrono::steady_clock::time_point start;
+      std::atomic<std::size_t> documentCount {0};
+      std::atomic<std::size_t> failedDocumentCount {0};
+      std::atomic<std::size_t> byteCount {0};
+  };
+
+  /* Parse many GPX documents at once, each on one of the pool's threads, as parseTrackFile() or
+   * parseTrackString() would.  The results are in the same order as the documents; an invalid
+   * document does not stop the others from being parsed.
+   *
+   * The calling thread starts each document when the limits allow, and waits for them all to finish,
+   * so these must not be called from a task running on the same pool.
+   */
+  std::vector<BatchResult> parseTrackFiles(const std::vector<std::string>& filePaths, GPS::ThreadPool&,
+                                           const BatchLimits& = {}, BatchCounters* = nullptr);
+
+  // The texts must remain valid until the call returns.
+  std::vector<BatchResult> parseTrackStrings(const std::vector<std::string_view>& gpxTexts, GPS::ThreadPool&,
+                                             const BatchLimits& = {}, BatchCounters* = nullptr);
+}
+
+#endif
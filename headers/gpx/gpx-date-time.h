@@ -0,0 +1,69 @@
+#ifndef GPS_GPX_DATE_TIME_H
+#define GPS_GPX_DATE_TIME_H
+
+#include <cstddef>
+#include <ctime>
+#include <string_view>
+
+#include "types.h"
+
+namespace GPS::GPX
+{
+  /* Decodes ISO 8601 date/time stamps of the form YYYY-MM-DDThh:mm:ss[.fff][Z|+hh:mm|-hh:mm],
+   * e.g. "2001-02-12T02:20:15Z", to seconds since the Unix Epoch.
+   *
+   * A stamp without a time zone designator is taken to be UTC, as GPX requires.  Fractions of a
+   * second are kept to the microsecond; further digits are accepted but discarded.  Leading and
+   * trailing whitespace is ignored.
+   *
+   * The conversion is arithmetic: it uses no locale or time zone state, and does not allocate.
+   * The start of the most recent date is cached, as consecutive track points usually share a date.
+   * A decoder may be used by one thread at a time; use one per thread.
+   */
+  class DateTimeDecoder
+  {
+    public:
+      // Throws a std::domain_error for malformed or out-of-range content.
+      GPS::microseconds decodeMicroseconds(std::string_view);
+
+      // As decodeMicroseconds(), rounded down to a whole second.
+      std::time_t decode(std::string_view);
+
+    private:
+      char cachedDate[10] {};
+      std::time_t cachedDateStart = 0;
+  };
+
+  // Decode a single date/time stamp, as DateTimeDecoder::decode().
+  std::time_t parseDateTime(std::string_view);
+
+  // The length of a stamp written by formatDateTime(), e.g. "2001-02-12T02:20:15Z".
+  const std::size_t formattedDateTimeLength = 20;
+
+  /* Write the time as a UTC stamp of the form YYYY-MM-DDThh:mm:ssZ, returning the end of the text.
+   * Throws a std::domain_error for times outside the years 0000 to 9999, which have no such form.
+   */
+  char* formatDateTime(std::time_t, char* output);
+
+  // The longest stamp written by formatTimeStamp(), e.g. "2001-02-12T02:20:15.000001Z".
+  const std::size_t maxFormattedTimeStampLength = 27;
+
+  /* As formatDateTime(), with the fraction of a second (if any) to the millisecond or, where that is
+   * not exact, to the microsecond, e.g. "2001-02-12T02:20:15.250Z".
+   */
+  char* formatTimeStamp(GPS::microseconds, char* output);
+
+  // Days from 1970-01-01 to the given date in the proleptic Gregorian calendar.
+  constexpr long long daysFromCivil(int year, unsigned int month, unsigned int day)
+  {
+      // See http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+      year -= month <= 2;
+      const int era = (year >= 0 ? year : year - 399) / 400;
+      const unsigned int yearOfEra = static_cast<unsigned int>(year - era * 400);
+      const unsigned int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+      const unsigned int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+      return era * 146097LL + dayOfEra - 719468;
+  }
+}
+
+#endif
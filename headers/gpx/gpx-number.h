@@ -0,0 +1,21 @@
+#ifndef GPS_GPX_NUMBER_H
+#define GPS_GPX_NUMBER_H
+
+#include <string_view>
+
+namespace GPS::GPX
+{
+  /* Parses decimal number content, such as a 'lat' or 'lon' attribute or an 'ele' element:
+   * an optional sign, digits with an optional fraction, and an optional exponent, e.g. "-1.25e3".
+   * Leading and trailing whitespace is ignored; anything else, including "inf" and "nan", is malformed.
+   *
+   * The text is parsed in place with std::from_chars, so the result is correctly rounded, does not
+   * depend on the locale, and no memory is allocated.
+   */
+  bool tryParseNumber(std::string_view, double& value);
+
+  // As tryParseNumber(), but throws a std::domain_error for malformed content.
+  double parseNumber(std::string_view);
+}
+
+#endif
@@ -1,18 +1,82 @@
 #ifndef GPS_GPX_PARSER_H
 #define GPS_GPX_PARSER_H
 
+#include <functional>
 #include <vector>
 #include <istream>
+#include <string>
+#include <string_view>
 
+#include "sensor-data.h"
+#include "thread-pool.h"
+#include "track-decimator.h"
 #include "trackpoint.h"
 
 namespace GPS::GPX
 {
+  /* Increased whenever a change to the parser could change the points read from a document, so that
+   * results saved from an earlier version (e.g. in a TrackCache) are not reused.
+   */
+  const unsigned int parserVersion = 1;
+
+  /* The track is read straight from the XML tokens, without building an element tree, so memory
+   * use is proportional to the number of points rather than to the size of the document.
+   *
+   * Only the first 'trk' element is read.  If it contains 'trkseg' elements their points are
+   * concatenated, and any 'trkpt' elements directly within the 'trk' are ignored.
+   * Throws a std::domain_error for malformed XML or for missing elements, attributes or content.
+   *
+   * gzip-compressed GPX (e.g. a .gpx.gz file) is recognised and decompressed in chunks as it is
+   * parsed, on a second thread, without holding the whole decompressed text.  A std::domain_error is
+   * also thrown for corrupt compressed data.
+   */
+
   // Parse a stream of GPX data containing a track.
   std::vector<GPS::Trackpoint> parseTrackStream(std::istream&);
 
   // Parse a GPX data string containing a track.
-  std::vector<GPS::Trackpoint> parseTrackString(const std::string&);
+  std::vector<GPS::Trackpoint> parseTrackString(std::string_view);
+
+  // Parse a GPX file containing a track.  The file is memory-mapped rather than read through a stream.
+  std::vector<GPS::Trackpoint> parseTrackFile(const std::string& filePath);
+
+  /* As above, but appending the points to a vector (which may already have been reserved).
+   * If an exception is thrown, the points read before the error was found will have been appended.
+   */
+  void parseTrackStream(std::istream&, std::vector<GPS::Trackpoint>&);
+  void parseTrackString(std::string_view, std::vector<GPS::Trackpoint>&);
+  void parseTrackFile(const std::string& filePath, std::vector<GPS::Trackpoint>&);
+
+  /* As above, but also appending the sensor readings (heart rate, cadence, power and temperature)
+   * from each point's 'extensions' to the SensorData, in the same pass; see TrackReader for the
+   * elements that are recognised.  A point is appended to both or to neither.
+   */
+  void parseTrackStream(std::istream&, std::vector<GPS::Trackpoint>&, GPS::SensorData&);
+  void parseTrackString(std::string_view, std::vector<GPS::Trackpoint>&, GPS::SensorData&);
+  void parseTrackFile(const std::string& filePath, std::vector<GPS::Trackpoint>&, GPS::SensorData&);
+
+  /* As above, but passing each point to the sink as soon as it has been read.
+   * If an exception is thrown, the points read before the error was found will have been passed on.
+   */
+  using TrackpointSink = std::function<void(const GPS::Trackpoint&)>;
+  void parseTrackStream(std::istream&, const TrackpointSink&);
+  void parseTrackString(std::string_view, const TrackpointSink&);
+  void parseTrackFile(const std::string& filePath, const TrackpointSink&);
+
+  /* As above, but thinning out the points as they are read (see DecimationOptions), e.g. so that a
+   * track logged at 100 Hz takes little more memory than one logged at 1 Hz.
+   */
+  std::vector<GPS::Trackpoint> parseTrackStream(std::istream&, const GPS::DecimationOptions&);
+  std::vector<GPS::Trackpoint> parseTrackString(std::string_view, const GPS::DecimationOptions&);
+  std::vector<GPS::Trackpoint> parseTrackFile(const std::string& filePath, const GPS::DecimationOptions&);
+
+  /* Parallel versions of the above, for large documents.  The text is split between 'trkpt' elements
+   * and the pieces are parsed on the pool's threads.  The points, and any error, are the same as
+   * for the sequential versions.
+   */
+  std::vector<GPS::Trackpoint> parseTrackStream(std::istream&, GPS::ThreadPool&);
+  std::vector<GPS::Trackpoint> parseTrackString(std::string_view, GPS::ThreadPool&);
+  std::vector<GPS::Trackpoint> parseTrackFile(const std::string& filePath, GPS::ThreadPool&);
 
 }
 
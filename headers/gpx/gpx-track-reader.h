@@ -0,0 +1,162 @@
+#ifndef GPS_GPX_TRACK_READER_H
+#define GPS_GPX_TRACK_READER_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "xml-incremental-parser.h"
+#include "xml-parser.h"
+#include "xml-path-filter.h"
+
+#include "gpx-date-time.h"
+#include "gpx-parser.h"
+#include "sensor-data.h"
+#include "trackpoint.h"
+
+namespace GPS::GPX
+{
+  /* Extracts the track points from a sequence of XML events.  This is the reader behind the functions
+   * in gpx-parser.h, which describes the points that are selected.
+   *
+   * Points within a 'trkseg' are passed to the sink as soon as they are complete.  Points directly
+   * within the 'trk' are held back until the 'trk' ends, because a later 'trkseg' would override them.
+   * Once an error has been found, no further points are passed to the sink.
+   *
+   * If a SensorData is given, the readings found in each point's 'extensions' are appended to it as
+   * the point is passed to the sink.  A reading is recognised by the name of its element, ignoring
+   * any namespace prefix, whether it is directly within 'extensions' or one level further in (as in
+   * Garmin's TrackPointExtension): 'hr' or 'heartrate', 'cad' or 'cadence', 'power', 'watts' or
+   * 'PowerInWatts', and 'atemp' or 'temp'.  The first reading on each channel is used, and malformed
+   * readings are ignored rather than failing the track.
+   */
+  class TrackReader
+  {
+    public:
+      using Sink = TrackpointSink;
+
+      explicit TrackReader(Sink, GPS::SensorData* = nullptr);
+
+      void consume(const XML::Event&);
+
+      // The elements that a TrackReader uses; a Parser may skip everything else.
+      static const XML::PathFilter& filter();
+
+      // As filter(), but also keeping the elements that sensor readings are taken from.
+      static const XML::PathFilter& filterWithSensors();
+
+      /* Call once every event has been consumed.
+       * Throws the exception for the first error in the track: a std::domain_error for missing
+       * elements, attributes or malformed content, or a std::invalid_argument for an invalid Waypoint.
+       */
+      void finish();
+
+      /* A TrackReader for a run of sibling elements from within a 'trkseg', e.g. one piece of a
+       * document that is being parsed in parallel.
+       */
+      static TrackReader forSegmentContents(Sink);
+
+      // As filter(), for a Parser over a run of sibling elements from within a 'trkseg'.
+      static const XML::PathFilter& segmentContentsFilter();
+
+      // True once an error has been found.
+      bool hasFailed() const;
+
+      /* True between the elements directly within a 'trkseg', e.g. straight after the EndElement event
+       * of a 'trkpt' there, but not of one directly within the 'trk'.
+       */
+      bool isWithinSegment() const;
+
+      /* Accept points from 'trkpt' elements that were parsed elsewhere, as though those elements had
+       * been consumed here.  Only valid straight after the EndElement event of a 'trkpt' within a
+       * 'trkseg' (see isWithinSegment()).
+       */
+      void consumePoints(std::span<const GPS::Trackpoint>);
+
+    private:
+      /* A number is parsed as soon as its text is seen, straight from the XML source.  Its text is
+       * only copied if it is malformed, for the error that is raised once the point is complete.
+       */
+      struct NumberContent
+      {
+          bool present = false;
+          bool wellFormed = true;
+          double value = 0;
+          std::string malformedText;
+
+          void read(std::string_view);
+          double get() const;
+      };
+
+      struct PointContent
+      {
+          NumberContent lat, lon, ele;
+          std::string time;
+          bool hasTime;
+          GPS::SensorReadings readings;
+
+          GPS::Trackpoint toTrackpoint(DateTimeDecoder&) const;
+      };
+
+      Sink sink;
+      GPS::SensorData* sensors;
+      DateTimeDecoder dateTimeDecoder;
+
+      unsigned int depth = 0;
+      bool trkFound = false;
+      bool inTrk = false;
+      bool segmentsFound = false;
+      bool inSegment = false;
+      std::size_t segmentPointCount = 0;
+
+      unsigned int pointDepth = 0; // Zero when not within a 'trkpt'.
+      bool pointInSegment = false;
+      PointContent point;
+      enum class Content { None, Ele, Time };
+      Content capturedContent = Content::None; // The 'ele' or 'time' element being read, if any.
+      bool inExtensions = false;
+
+      std::size_t directPointCount = 0;
+      std::vector<GPS::Trackpoint> directPoints;
+      std::vector<GPS::SensorReadings> directReadings; // Only kept when there is a SensorData.
+      std::exception_ptr directPointError;
+
+      std::exception_ptr firstError;
+
+      void startElement(const XML::Event&);
+      void endElement();
+      void startPoint(const XML::Event&, bool inSegment);
+      void endPoint();
+      void endTrack();
+      void readSensor(const XML::Event&);
+      void emit(const GPS::Trackpoint&, const GPS::SensorReadings&);
+
+      void recordError(std::exception_ptr&, std::exception_ptr);
+      void recordError(std::string_view missing);
+  };
+
+  /* Parses a GPX track that arrives in chunks, passing each point to the sink as soon as it can.
+   * Memory use is bounded by the chunk size and the longest tag (plus any points held back by the
+   * TrackReader), not by the size of the document or of the elements that are skipped.
+   */
+  class IncrementalTrackParser
+  {
+    public:
+      explicit IncrementalTrackParser(TrackReader::Sink, GPS::SensorData* = nullptr);
+
+      // Throws a std::domain_error for malformed XML.
+      void feed(const char* data, std::size_t size);
+
+      // Signal the end of the input.  Throws as parseTrackString() would for an invalid track.
+      void finish();
+
+    private:
+      TrackReader reader;
+      XML::IncrementalParser xmlParser;
+  };
+}
+
+#endif
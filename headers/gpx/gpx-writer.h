@@ -0,0 +1,92 @@
+#ifndef GPS_GPX_WRITER_H
+#define GPS_GPX_WRITER_H
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "track.h"
+#include "trackpoint.h"
+
+namespace GPS::GPX
+{
+  struct WriterOptions
+  {
+      std::string trackName; // Written as the 'trk' element's 'name', unless empty.
+      std::string creator = "GPS";
+  };
+
+  /* Writes a GPX 1.1 document with a single 'trk', one point at a time.
+   *
+   * Numbers are written in their shortest form that reads back as the same double, and times as UTC
+   * stamps of the form YYYY-MM-DDThh:mm:ssZ, with any fraction of a second to the millisecond or
+   * microsecond (e.g. "2001-02-12T02:20:15.250Z", see formatTimeStamp()), so the parser in gpx-parser.h
+   * reads back exactly the points that were written, and writing those points again gives the same
+   * bytes.  Every point is written with an 'ele' element, even at zero altitude.
+   *
+   * The text is built in a fixed-size buffer and passed on in chunks, with no allocation per point.
+   */
+  class TrackWriter
+  {
+    public:
+      // Write to a stream.  As with other stream output, check the stream's state once finished.
+      explicit TrackWriter(std::ostream&, WriterOptions = {});
+
+      // Append to a string.
+      explicit TrackWriter(std::string&, WriterOptions = {});
+
+      TrackWriter(const TrackWriter&) = delete;
+      TrackWriter& operator=(const TrackWriter&) = delete;
+
+      /* Throws a std::domain_error for a time stamp outside the years 0000 to 9999.
+       * Nothing is written for a point that throws.
+       */
+      void write(const GPS::Trackpoint&);
+
+      /* End the current 'trkseg' and start another, if the current one has any points; the first
+       * segment is started by the first point.
+       */
+      void startSegment();
+
+      /* Close the document and pass on the remaining text.  A document with no points has an empty
+       * 'trkseg', which the parser rejects.  Nothing more may be written afterwards.
+       */
+      void finish();
+
+    private:
+      std::function<void(std::string_view)> output;
+      WriterOptions options;
+      std::string buffer;
+      bool headerWritten = false;
+      bool segmentHasPoints = false;
+      bool finished = false;
+
+      void writeHeader();
+      void flushIfFull();
+  };
+
+  /* Write the points as a GPX document, as TrackWriter does.  A new 'trkseg' is started at each of
+   * the segment start indices (which must be increasing); otherwise all points are in one 'trkseg'.
+   */
+  void writeTrack(std::ostream&, std::span<const GPS::Trackpoint>, const WriterOptions& = {},
+                  std::span<const std::size_t> segmentStarts = {});
+  void writeTrack(std::ostream&, const std::vector<GPS::Trackpoint>&, const WriterOptions& = {},
+                  std::span<const std::size_t> segmentStarts = {});
+  void writeTrack(std::ostream&, const GPS::Track&, const WriterOptions& = {},
+                  std::span<const std::size_t> segmentStarts = {});
+  std::string writeTrackString(std::span<const GPS::Trackpoint>, const WriterOptions& = {},
+                               std::span<const std::size_t> segmentStarts = {});
+
+  /* As writeTrack(), to a file.  If the path ends in ".gz" the file is gzip-compressed as it is
+   * written (see GPS::GzipOutputStream), ready to be read back by parseTrackFile().
+   * Throws a std::system_error if the file cannot be written.
+   */
+  void writeTrackFile(const std::string& filePath, std::span<const GPS::Trackpoint>, const WriterOptions& = {},
+                      std::span<const std::size_t> segmentStarts = {});
+}
+
+#endif
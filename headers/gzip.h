@@ -0,0 +1,133 @@
+#ifndef GPS_GZIP_H
+#define GPS_GZIP_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace GPS
+{
+  // True if the data starts with the gzip magic bytes (which no XML document can start with).
+  bool isGzipData(std::string_view);
+
+  /* Decompresses gzip (or zlib) data that arrives in chunks.  Each call passes the handler the
+   * decompressed text in chunks of at most 'chunkSize' bytes, so memory use is bounded however large
+   * the data.  Concatenated gzip members are decompressed in turn, as by gunzip.
+   */
+  class GzipInflater
+  {
+    public:
+      using ChunkHandler = std::function<void(std::string_view)>;
+
+      explicit GzipInflater(std::size_t chunkSize = 256 * 1024);
+      ~GzipInflater();
+
+      GzipInflater(const GzipInflater&) = delete;
+      GzipInflater& operator=(const GzipInflater&) = delete;
+
+      // Throws a std::domain_error for corrupt data.
+      void feed(std::string_view compressed, const ChunkHandler&);
+
+      // Signal the end of the input.  Throws a std::domain_error if the data is incomplete.
+      void finish();
+
+    private:
+      struct Stream;
+      std::unique_ptr<Stream> stream;
+      std::string output;
+      bool atMemberEnd = false;
+  };
+
+  /* Reads and decompresses gzip data on a background thread, a few chunks ahead of the caller, so that
+   * decompression overlaps with whatever the caller does with each chunk.  Memory use is bounded by
+   * the size and number of chunks, however large the data.
+   */
+  class BackgroundGzipReader
+  {
+    public:
+      // Reads up to 'size' bytes of compressed data into the buffer, returning the number read: 0 at the end.
+      using Source = std::function<std::size_t(char* buffer, std::size_t size)>;
+
+      explicit BackgroundGzipReader(Source, std::size_t chunkSize = 256 * 1024, unsigned int chunksAhead = 4);
+
+      // Stops reading, if the data has not all been read.
+      ~BackgroundGzipReader();
+
+      BackgroundGzipReader(const BackgroundGzipReader&) = delete;
+      BackgroundGzipReader& operator=(const BackgroundGzipReader&) = delete;
+
+      /* The next chunk of decompressed data, valid until the next call; empty once all the data has
+       * been read.  Rethrows any exception from the source, or a std::domain_error for corrupt data.
+       */
+      std::string_view nextChunk();
+
+    private:
+      Source source;
+      const std::size_t chunkSize;
+
+      std::mutex mutex;
+      std::condition_variable chunksChanged;
+      std::deque<std::string> readyChunks;
+      std::vector<std::string> freeChunks;
+      std::string currentChunk;
+      bool ended = false;
+      bool stopping = false;
+      std::exception_ptr error;
+
+      std::thread thread;
+
+      void readAll();
+      void deliver(std::string_view);
+  };
+
+  /* Compresses data written to it in gzip format, passing the compressed data on to another stream
+   * in chunks.  close() (or destruction) writes the end of the gzip data.
+   */
+  class GzipOutputStream : public std::ostream
+  {
+    public:
+      // The level is as for zlib: 1 (fastest) to 9 (smallest), or -1 for the default (6).
+      explicit GzipOutputStream(std::ostream& destination, int level = -1);
+      ~GzipOutputStream();
+
+      // Write the rest of the compressed data.  Sets the failbit if it cannot be written.
+      void close();
+
+    private:
+      class Buffer : public std::streambuf
+      {
+        public:
+          Buffer(std::ostream& destination, int level);
+          ~Buffer();
+
+          bool close();
+
+        protected:
+          int_type overflow(int_type) override;
+          int sync() override;
+
+        private:
+          struct Stream;
+          std::unique_ptr<Stream> stream;
+          std::ostream& destination;
+          std::string input;
+          std::string output;
+          bool closed = false;
+
+          bool compress(bool finish);
+      };
+
+      Buffer buffer;
+  };
+}
+
+#endif
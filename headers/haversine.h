@@ -0,0 +1,64 @@
+#ifndef GPS_HAVERSINE_H
+#define GPS_HAVERSINE_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "types.h"
+#include "waypoint.h"
+
+/* Horizontal distances for many pairs of points at once, by the Haversine Formula, as for
+ * Waypoint::horizontalDistanceBetween().  Latitudes and longitudes are given in degrees.
+ *
+ * On x86-64 the distances are computed 4 (AVX2) or 8 (AVX-512) at a time, with polynomial
+ * approximations of sin, cos and asin in place of the library functions; the widest implementation
+ * supported by the CPU is chosen at start-up.  Other CPUs, and other platforms, use the scalar
+ * implementation, which gives exactly the results of Waypoint::horizontalDistanceBetween().
+ *
+ * The approximations are accurate to a few units in the last place, so every distance agrees with
+ * Waypoint::horizontalDistanceBetween() to within the relative tolerance below.  The exception is for
+ * points near to being antipodal, where the formula itself is ill-conditioned and an error of an ulp in
+ * an intermediate value moves either result by up to 20 cm.
+ */
+namespace GPS::Haversine
+{
+  // The greatest difference from Waypoint::horizontalDistanceBetween(), relative to the distance.
+  const double relativeTolerance = 1e-12;
+
+  // Within this distance of the antipode, the difference is bounded by antipodalTolerance instead.
+  const metres antipodalMargin = 100000;
+  const metres antipodalTolerance = 0.2;
+
+  struct Kernel
+  {
+      const char* name;
+      void (*distancesBetween)(const degrees* latitudes1, const degrees* longitudes1,
+                               const degrees* latitudes2, const degrees* longitudes2,
+                               metres* distances, std::size_t count);
+      void (*distancesFrom)(degrees latitude, degrees longitude,
+                            const degrees* latitudes, const degrees* longitudes,
+                            metres* distances, std::size_t count);
+  };
+
+  // The implementation used by the functions below.
+  const Kernel& selectedKernel();
+
+  // Every implementation that the CPU supports, narrowest first (for testing and benchmarking).
+  std::vector<Kernel> availableKernels();
+
+  /* The distance between the first and second points at each index.
+   * Throws a std::invalid_argument if the spans are not all the same size.
+   */
+  void distancesBetween(std::span<const degrees> latitudes1, std::span<const degrees> longitudes1,
+                        std::span<const degrees> latitudes2, std::span<const degrees> longitudes2,
+                        std::span<metres> distances);
+
+  /* The distance from the origin to each of the points.
+   * Throws a std::invalid_argument if the spans are not all the same size.
+   */
+  void distancesFrom(const Waypoint& origin, std::span<const degrees> latitudes, std::span<const degrees> longitudes,
+                     std::span<metres> distances);
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef GPS_MAPPED_FILE_H
+#define GPS_MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+
+namespace GPS
+{
+  /* A read-only view of the entire contents of a file.
+   * Where the platform supports it the file is memory-mapped, so the contents are paged in on
+   * demand rather than copied; otherwise the file is read into memory.
+   */
+  class MappedFile
+  {
+    public:
+      /* Throws a std::system_error if the file cannot be opened or mapped.
+       */
+      MappedFile(const std::string& filePath);
+      ~MappedFile();
+
+      MappedFile(MappedFile&&) noexcept;
+      MappedFile& operator=(MappedFile&&) noexcept;
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      // The file contents; valid for the lifetime of this MappedFile.
+      std::string_view contents() const;
+
+    private:
+      const char* data = nullptr;
+      std::size_t size = 0;
+      bool isMapped = false;
+      std::string fallbackBuffer;
+
+      void release();
+  };
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef GPS_POINT_COLUMNS_H
+#define GPS_POINT_COLUMNS_H
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <vector>
+
+#include "trackpoint.h"
+#include "types.h"
+#include "waypoint.h"
+
+namespace GPS
+{
+  // Allocates storage aligned to a cache line, which is also enough for the widest vector loads.
+  template <typename T>
+  struct ColumnAllocator
+  {
+      using value_type = T;
+      static constexpr std::align_val_t alignment {64};
+
+      ColumnAllocator() = default;
+      template <typename U> ColumnAllocator(const ColumnAllocator<U>&) {}
+
+      T* allocate(std::size_t count)
+      {
+          return static_cast<T*>(::operator new(count * sizeof(T), alignment));
+      }
+
+      void deallocate(T* column, std::size_t)
+      {
+          ::operator delete(column, alignment);
+      }
+
+      template <typename U> bool operator==(const ColumnAllocator<U>&) const { return true; }
+  };
+
+  template <typename T>
+  using Column = std::vector<T, ColumnAllocator<T>>;
+
+  /* The track points stored as one contiguous column per field, so that a query that needs only
+   * one field reads only that field, and can compare several values at once.
+   */
+  struct PointColumns
+  {
+      Column<degrees> latitudes;
+      Column<degrees> longitudes;
+      Column<metres> altitudes;
+      Column<microseconds> timeStamps;
+
+      explicit PointColumns(std::span<const Trackpoint>);
+
+      std::size_t size() const;
+
+      Waypoint waypoint(std::size_t) const;
+
+      // The heap memory held by the columns.
+      std::size_t capacityInBytes() const;
+  };
+
+  /* The index of the first of the greatest or least values in the column, or of the values whose
+   * magnitude is greatest or least.  These give the same results as a scan from the start, keeping
+   * the earlier value on a tie, but compare several values at once where the processor can.
+   *
+   * Pre-condition: the column is not empty, and contains no NaNs.
+   */
+  std::size_t firstIndexOfGreatest(std::span<const double>);
+  std::size_t firstIndexOfLeast(std::span<const double>);
+  std::size_t firstIndexOfGreatestMagnitude(std::span<const double>);
+  std::size_t firstIndexOfLeastMagnitude(std::span<const double>);
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef GPS_SENSOR_DATA_H
+#define GPS_SENSOR_DATA_H
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace GPS
+{
+  enum class SensorChannel { HeartRate, Cadence, Power, Temperature };
+
+  const std::size_t sensorChannelCount = 4;
+
+  // The readings for one track point; NaN where there is no reading.
+  struct SensorReadings
+  {
+      std::array<double, sensorChannelCount> values = {noReading(), noReading(), noReading(), noReading()};
+
+      static constexpr double noReading() { return std::numeric_limits<double>::quiet_NaN(); }
+
+      double& operator[](SensorChannel channel) { return values[static_cast<std::size_t>(channel)]; }
+      double operator[](SensorChannel channel) const { return values[static_cast<std::size_t>(channel)]; }
+  };
+
+  /* Sensor readings (heart rate in beats per minute, cadence in revolutions per minute, power in
+   * watts and temperature in degrees Celsius) for the points of a track, stored as one column per
+   * channel.  A column is only allocated once a reading on its channel is found, so a track without
+   * sensors costs nothing beyond this object.
+   */
+  class SensorData
+  {
+    public:
+      // The number of points that readings have been appended for.
+      std::size_t size() const;
+
+      bool hasChannel(SensorChannel) const;
+
+      /* A reading for every point, NaN where a point has none; empty if no point has a reading on the
+       * channel.  Valid until the SensorData is next changed.
+       */
+      std::span<const double> channel(SensorChannel) const;
+
+      // Add the readings for the next point.
+      void append(const SensorReadings&);
+
+    private:
+      std::size_t pointCount = 0;
+      std::array<std::vector<double>, sensorChannelCount> columns;
+  };
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef GPS_THREAD_POOL_H
+#define GPS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace GPS
+{
+  /* A fixed set of worker threads that run submitted tasks.
+   *
+   * Each worker has its own queue.  Tasks submitted from outside the pool are dealt to the queues
+   * in turn, and tasks submitted by a running task go to its own worker's queue.  A worker runs the
+   * tasks in its queue in the order they were submitted; when its queue is empty it steals the most
+   * recently queued task from another worker, so uneven tasks do not leave threads idle.
+   */
+  class ThreadPool
+  {
+    public:
+      // By default, one thread per hardware thread.
+      explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+
+      // Waits for every task that has been submitted to finish.
+      ~ThreadPool();
+
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator=(const ThreadPool&) = delete;
+
+      unsigned int threadCount() const;
+
+      // The future holds the task's result, or the exception that it threw.
+      template <typename Task>
+      std::future<std::invoke_result_t<Task>> submit(Task task)
+      {
+          auto packagedTask = std::make_shared<std::packaged_task<std::invoke_result_t<Task>()>>(std::move(task));
+          std::future<std::invoke_result_t<Task>> result = packagedTask->get_future();
+          enqueue([packagedTask]{ (*packagedTask)(); });
+          return result;
+      }
+
+    private:
+      struct WorkerQueue
+      {
+          std::mutex mutex;
+          std::deque<std::function<void()>> tasks;
+      };
+      std::vector<std::unique_ptr<WorkerQueue>> queues;
+      std::atomic<unsigned int> nextQueue {0};
+
+      /* Guards the count of queued tasks, which idle workers wait on.  A task is counted just after it
+       * is queued, so it may be taken (and counted down) first; the count may then briefly be negative.
+       */
+      std::mutex mutex;
+      std::condition_variable taskAvailable;
+      long queuedTaskCount = 0;
+      bool stopping = false;
+
+      std::vector<std::thread> threads;
+
+      void enqueue(std::function<void()>);
+      bool takeTask(unsigned int worker, std::function<void()>& task);
+      void runTasks(unsigned int worker);
+  };
+}
+
+#endif
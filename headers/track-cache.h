@@ -0,0 +1,98 @@
+#ifndef GPS_TRACK_CACHE_H
+#define GPS_TRACK_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trackpoint.h"
+
+namespace GPS
+{
+  /* A 64-bit hash of the bytes, for telling documents apart (not for security).  This is XXH64 with
+   * a seed of zero, which runs at several GB/s.
+   */
+  std::uint64_t contentHash(std::string_view);
+
+  /* An on-disk cache of parsed tracks, and of any metrics computed from them, keyed by the contents
+   * of the GPX document that they came from.  A document that has been seen before (by this or any
+   * other process using the same directory) need be neither parsed nor analysed again.
+   *
+   * Each entry is held in the directory as a track file (see track-file.h) and, once stored, a file
+   * of named metric values.  Files are written under a temporary name and renamed into place, so
+   * that other processes only ever see complete entries; a damaged entry is treated as a miss.
+   *
+   * When the files in the directory exceed the size bound, the least recently used entries are
+   * removed until they are within three quarters of it.  Use is recorded in the files' modification
+   * times, so it is shared between processes.  The bound is approximate: this process re-measures
+   * the directory only once its own additions could have taken it over the bound.
+   *
+   * A TrackCache may be used from several threads at once.
+   */
+  class TrackCache
+  {
+    public:
+      using Metrics = std::map<std::string, double>;
+
+      /* Creates the directory if necessary.
+       * Throws a std::filesystem::filesystem_error if it cannot be created or read.
+       */
+      TrackCache(std::string directory, std::uintmax_t maxBytes = std::uintmax_t {1} << 30);
+
+      /* The key for a GPX document: its hash and length, the parser version and the track file format
+       * version, so that results from a different version of either are not reused.
+       */
+      static std::string keyFor(std::string_view gpxContents);
+
+      /* The points of the GPX file, from the cache if its contents have been seen before; otherwise
+       * the file is parsed and the points stored.  Throws as GPS::GPX::parseTrackFile() does.
+       */
+      std::vector<Trackpoint> parseTrackFile(const std::string& gpxFilePath);
+
+      // The stored points for the key, if any.
+      std::optional<std::vector<Trackpoint>> findTrack(const std::string& key);
+
+      // The stored metrics for the key, if any.
+      std::optional<Metrics> findMetrics(const std::string& key);
+
+      /* Store the points or metrics for the key, replacing any stored before.
+       * Failures to write (e.g. a full disk) are not reported: the entry is simply not cached.
+       * Throws a std::invalid_argument for a metric name that is empty, contains whitespace, or is "end".
+       */
+      void storeTrack(const std::string& key, std::span<const Trackpoint>);
+      void storeMetrics(const std::string& key, const Metrics&);
+
+      // Lookups (by find...() or parseTrackFile()) that did and did not find an entry.
+      std::size_t hits() const;
+      std::size_t misses() const;
+
+      // Entries removed by this TrackCache to stay within the size bound.
+      std::size_t evictions() const;
+
+    private:
+      std::string directory;
+      std::uintmax_t maxBytes;
+
+      std::atomic<std::size_t> hitCount {0};
+      std::atomic<std::size_t> missCount {0};
+      std::atomic<std::size_t> evictionCount {0};
+
+      // The size of the directory when last measured, plus what this process has added since.
+      std::atomic<std::uintmax_t> approximateBytes {0};
+      std::mutex evictionMutex;
+
+      std::string pathFor(const std::string& key, std::string_view extension) const;
+      void writeAtomically(const std::string& path, const std::function<void(const std::string& temporaryPath)>& write);
+      void recordLookup(bool hit, const std::string& path);
+      void evictIfFull();
+  };
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef GPS_TRACK_CODEC_H
+#define GPS_TRACK_CODEC_H
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trackpoint.h"
+
+namespace GPS
+{
+  /* A compact, lossy encoding of track points for archiving.
+   *
+   * Latitude and longitude are rounded to a fixed number of decimal places of a degree, and altitude
+   * to a fixed number of decimal places of a metre; time stamps are kept exactly, counted in the
+   * largest power-of-ten fraction of a second that divides all of them, so that a track logged once a
+   * second costs no more than it would in whole seconds.  Each field is then
+   * stored as its own column of differences between consecutive points, as zigzag varints: small
+   * steps in either direction take one or two bytes.
+   *
+   * The default 7 decimal places of a degree is about 1 cm on the ground.
+   */
+  struct TrackCodecOptions
+  {
+      unsigned int coordinateDecimalPlaces = 7; // At most 12.
+      unsigned int altitudeDecimalPlaces = 2;   // At most 6.
+  };
+
+  /* Throws a std::invalid_argument if the options are out of range, or if an altitude is too large
+   * to be represented at the requested precision.
+   */
+  std::string encodeTrack(std::span<const Trackpoint>, const TrackCodecOptions& = {});
+
+  /* Each field of each point is the decimal value nearest to the original at the chosen precision,
+   * e.g. 54.42204773426058 becomes the double nearest to 54.4220477.
+   * Throws a std::domain_error for data that was not produced by encodeTrack().
+   */
+  std::vector<Trackpoint> decodeTrack(std::string_view encoding);
+
+  // As above, appending the points to a vector (which may already have been reserved).
+  void decodeTrack(std::string_view encoding, std::vector<Trackpoint>&);
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef GPS_TRACK_DECIMATOR_H
+#define GPS_TRACK_DECIMATOR_H
+
+#include <functional>
+#include <optional>
+
+#include "trackpoint.h"
+#include "types.h"
+
+namespace GPS
+{
+  /* How a high-rate stream of track points (e.g. from a 10-100 Hz receiver) is thinned out.
+   *
+   * With an interval, the points are grouped by time into intervals of that length, counted from the
+   * first point, and each interval becomes a single point: its first point, or the mean of its points.
+   * With a minimum distance, a point is dropped if it is closer than that (taking into account both
+   * vertical and horizontal distance) to the last point kept.  Both may be used together, in which
+   * case the distance applies to the points that represent each interval.
+   *
+   * The defaults keep every point.
+   */
+  struct DecimationOptions
+  {
+      enum class Mode { FirstPoint, Average };
+
+      microseconds interval = 0;
+      Mode mode = Mode::FirstPoint;
+      metres minimumDistance = 0;
+  };
+
+  /* Applies DecimationOptions to track points as they arrive, passing the points that are kept to a
+   * sink, so that a track can be decimated as it is parsed without first holding every point.
+   *
+   * The last point of the track is always kept, so that the track's duration and end are unchanged.
+   * (With Mode::Average, it follows the mean of the final interval.)
+   */
+  class TrackDecimator
+  {
+    public:
+      using Sink = std::function<void(const Trackpoint&)>;
+
+      // Throws a std::invalid_argument if the interval or the minimum distance is negative.
+      TrackDecimator(Sink, DecimationOptions);
+
+      void add(const Trackpoint&);
+
+      // Call after the last point, to pass on any point that is still being held back.
+      void finish();
+
+    private:
+      Sink sink;
+      DecimationOptions options;
+
+      microseconds firstTime = 0;
+      std::optional<microseconds> currentInterval;
+
+      // The points of the current interval, summed relative to its first point (for Mode::Average).
+      Trackpoint intervalStart {Waypoint(0, 0, 0), 0};
+      double latitudeSum = 0, longitudeSum = 0, altitudeSum = 0;
+      microseconds timeSum = 0;
+      unsigned long pointCount = 0;
+      std::optional<Trackpoint> lastAveraged; // The latest point added to an interval (for Mode::Average).
+
+      std::optional<Trackpoint> lastKept;
+      std::optional<Trackpoint> lastDropped; // Since the last point kept.
+
+      void endInterval();
+      void keepIfDistant(const Trackpoint&);
+  };
+}
+
+#endif
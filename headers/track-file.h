@@ -0,0 +1,74 @@
+#ifndef GPS_TRACK_FILE_H
+#define GPS_TRACK_FILE_H
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "mapped-file.h"
+#include "trackpoint.h"
+
+namespace GPS
+{
+  /* A binary file format for track points, so that a track can be reopened without parsing GPX.
+   *
+   * All fields are little-endian.  A 32-byte header:
+   *   - the magic bytes "GPSTRACK",
+   *   - the format version (uint32, currently 2),
+   *   - the size of each record in bytes (uint32, currently 32),
+   *   - the number of points (uint64),
+   *   - a checksum of the records (uint64, see trackFileChecksum());
+   * followed by one 32-byte record per point:
+   *   - latitude, longitude and altitude (IEEE 754 binary64),
+   *   - the time stamp in microseconds since the Unix Epoch (int64).
+   *
+   * Version 1 files, whose time stamps are in whole seconds, can still be read.
+   */
+  namespace TrackFileFormat
+  {
+    const char magic[8] = {'G', 'P', 'S', 'T', 'R', 'A', 'C', 'K'};
+    const std::uint32_t version = 2;
+    const std::uint32_t wholeSecondsVersion = 1;
+    const std::size_t headerSize = 32;
+    const std::size_t recordSize = 32;
+  }
+
+  // Write the points to a file in the binary format.  Throws a std::system_error if the file cannot be written.
+  void writeTrackFile(const std::string& filePath, std::span<const Trackpoint>);
+  void writeTrackFile(std::ostream&, std::span<const Trackpoint>);
+
+  /* A track file opened for reading.  The file is memory-mapped, and where the platform's layout of
+   * Trackpoint matches the records (as on little-endian 64-bit platforms) the points are used in place;
+   * otherwise (or for a version 1 file) they are decoded once when the file is opened.
+   */
+  class TrackFile
+  {
+    public:
+      /* Throws a std::system_error if the file cannot be read, or a std::domain_error if it is not a
+       * track file of a supported version, is truncated, fails its checksum, or holds a point whose
+       * latitude, longitude or altitude is out of range.
+       */
+      explicit TrackFile(const std::string& filePath);
+
+      // Valid for the lifetime of this TrackFile.
+      std::span<const Trackpoint> trackPoints() const;
+
+    private:
+      GPS::MappedFile file;
+      std::span<const Trackpoint> points;
+      std::vector<Trackpoint> decodedPoints;
+  };
+
+  // Read all the points from a track file, e.g. to construct a Track.  Throws as TrackFile does.
+  std::vector<Trackpoint> readTrackFile(const std::string& filePath);
+
+  /* A 64-bit checksum of the encoded records, for detecting corruption (not tampering).  Each
+   * little-endian 64-bit word is combined with an xor and a multiplication, so any single corrupt
+   * word changes the result.
+   */
+  std::uint64_t trackFileChecksum(const unsigned char* records, std::size_t size);
+}
+
+#endif
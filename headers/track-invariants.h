@@ -0,0 +1,62 @@
+#ifndef GPS_TRACK_INVARIANTS_H
+#define GPS_TRACK_INVARIANTS_H
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "trackpoint.h"
+
+namespace GPS
+{
+  /* The properties of a track's points that the Track queries depend on, found in a single pass when
+   * the Track is built, so that each query checks them in constant time rather than scanning the
+   * points again.  Where a property does not hold, the first point that breaks it is recorded.
+   */
+  struct TrackInvariants
+  {
+      std::size_t pointCount = 0;
+
+      // The first point whose time is not after that of the point before it.
+      std::optional<std::size_t> firstNonIncreasingTime;
+
+      /* The first point whose altitude is infinite.  (A Waypoint is never below the centre of the
+       * Earth, but has no upper limit.)
+       */
+      std::optional<std::size_t> firstInfiniteAltitude;
+
+      explicit TrackInvariants(std::span<const Trackpoint>);
+
+      bool hasPoints() const;
+      bool hasLegs() const; // At least two points.
+      bool timesIncrease() const;
+      bool altitudesFinite() const;
+  };
+
+  /* Throw a std::domain_error if the track has no points, fewer than two, or times that do not increase.
+   * Used by both Track and TrackSummary, so that their queries fail with the same message.
+   */
+  void requireTrackPoints(const TrackInvariants&);
+  void requireLegs(const TrackInvariants&);
+  void requireIncreasingTimes(const TrackInvariants&);
+
+  // The first reason that a sequence of track points was rejected by Track::validated().
+  struct TrackViolation
+  {
+      enum Kind
+      {
+          NoPoints,
+          SensorCountMismatch, // The sensor readings are for a different number of points.
+          NonIncreasingTime,
+          InfiniteAltitude
+      };
+
+      Kind kind;
+      std::size_t pointIndex = 0; // The offending point, for NonIncreasingTime and InfiniteAltitude.
+
+      std::string description() const;
+  };
+}
+
+#endif
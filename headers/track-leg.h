@@ -0,0 +1,85 @@
+#ifndef GPS_TRACK_LEG_H
+#define GPS_TRACK_LEG_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "point-columns.h"
+#include "trackpoint.h"
+#include "types.h"
+#include "waypoint.h"
+
+namespace GPS
+{
+  /* The distance between two Waypoints, taking into account both vertical and horizontal distance,
+   * as used by every Track query that measures distance.
+   */
+  metres distanceBetween(const Waypoint&, const Waypoint&);
+
+  /* The values between two successive track points that the Track queries are built from.  Every
+   * query derives them in the same way, so that each gives the same result however it is computed.
+   */
+  struct Leg
+  {
+      metres horizontalDistance;
+      metres altitudeChange; // Positive for ascent.
+      microseconds duration;
+
+      Leg(const Trackpoint& from, const Trackpoint& to);
+      Leg(metres horizontalDistance, metres altitudeChange, microseconds duration);
+
+      // Taking into account both vertical and horizontal distance.
+      metres distance() const;
+
+      seconds durationInSeconds() const;
+
+      // Only meaningful when the duration is positive.
+      speed averageSpeed() const;
+
+      // The angle of ascent (positive) or descent (negative); zero if the points coincide.
+      degrees gradient() const;
+  };
+
+  /* The values of every Leg of a track, one column per value, so that queries over the legs are
+   * simple scans with no trigonometry.  Each value is exactly as the Leg gives it, but the work for
+   * each point (e.g. the cosine of its latitude) is only done once rather than for both its legs.
+   */
+  struct LegColumns
+  {
+      std::vector<metres> distances;
+      std::vector<metres> altitudeChanges;
+      std::vector<microseconds> durations;
+      std::vector<speed> speeds; // Only meaningful if the times increase.
+      std::vector<degrees> gradients;
+
+      explicit LegColumns(const PointColumns&);
+
+      std::size_t size() const;
+
+      // The heap memory held by the columns.
+      std::size_t capacityInBytes() const;
+  };
+
+  /* Totals over the periods of a track that meet a condition (e.g. resting), where successive legs
+   * that meet it count as a single period.  Legs are added in track order.
+   */
+  struct PeriodTotals
+  {
+      microseconds totalDuration = 0;
+      microseconds longestDuration = 0;
+      microseconds durationBeforeFirst = 0; // The time elapsed before the first period begins.
+      metres totalDistance = 0;
+      unsigned int count = 0;
+
+      microseconds currentDuration = 0; // Of the period that the last leg added belongs to, if it met the condition.
+      bool lastLegMet = false;
+
+      void add(microseconds duration, metres distance, bool meetsCondition);
+
+      // In seconds; throws a std::domain_error if there are no periods.
+      seconds averageDuration() const;
+  };
+}
+
+#endif
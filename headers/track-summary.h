@@ -0,0 +1,124 @@
+#ifndef GPS_TRACK_SUMMARY_H
+#define GPS_TRACK_SUMMARY_H
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "track.h"
+#include "track-invariants.h"
+#include "track-leg.h"
+#include "trackpoint.h"
+#include "types.h"
+#include "waypoint.h"
+
+namespace GPS
+{
+  // The parameters of the Track queries that take them, fixed for the whole summary.
+  struct TrackSummaryOptions
+  {
+      speed restingSpeedThreshold = 0;
+      speed travellingSpeedThreshold = 0;
+
+      // For the queries relative to a waypoint, which are only available if one is given.
+      std::optional<Waypoint> targetWaypoint;
+      metres nearDistance = 0;
+  };
+
+  /* The results of the Track queries, all computed in a single pass over the track points, with the
+   * distance between each pair of successive points computed only once.  This is much cheaper than
+   * calling the Track member functions one by one when several of them are needed.
+   *
+   * Each query returns exactly what the Track member function of the same name would return, and
+   * throws the same exceptions in the same circumstances, so a summary can be built for any track
+   * (even an empty one); a query that cannot be answered only throws when it is called.  The queries
+   * relative to a waypoint also throw a std::logic_error if the options gave no target waypoint.
+   * The queries for a time (lastWaypointBefore() and firstWaypointAfter()) are not summarised.
+   *
+   * A summary is independent of the track points once built.
+   */
+  class TrackSummary
+  {
+    public:
+      TrackSummary(std::span<const Trackpoint>, TrackSummaryOptions = {});
+      TrackSummary(const Track&, TrackSummaryOptions = {});
+
+      const TrackSummaryOptions& options() const;
+
+      unsigned int numberOfWaypoints() const;
+      seconds totalTime() const;
+      metres netHeightGain() const;
+      metres totalHeightGain() const;
+      metres netLength() const;
+      metres totalLength() const;
+      speed averageSpeed() const;
+      Waypoint highestWaypoint() const;
+      Waypoint lowestWaypoint() const;
+
+      Waypoint mostNorthelyWaypoint() const;
+      Waypoint mostSoutherlyWaypoint() const;
+      Waypoint mostEasterlyWaypoint() const;
+      Waypoint mostWesterlyWaypoint() const;
+      Waypoint mostEquatorialWaypoint() const;
+      Waypoint leastEquatorialWaypoint() const;
+      speed maxSpeed() const;
+      speed maxRateOfAscent() const;
+      speed maxRateOfDescent() const;
+      degrees maxGradient() const;
+      degrees minGradient() const;
+      degrees steepestGradient() const;
+
+      // Relative to the target waypoint, and within the near distance, given in the options.
+      Waypoint nearestWaypointTo() const;
+      Waypoint farthestWaypointFrom() const;
+      unsigned int numberOfWaypointsNear() const;
+      fraction proportionOfWaypointsNear() const;
+
+      // With the resting or travelling speed threshold given in the options.
+      seconds restingTime() const;
+      seconds travellingTime() const;
+      seconds longestRestingPeriod() const;
+      seconds longestTravellingPeriod() const;
+      seconds averageRestingPeriod() const;
+      seconds averageTravellingPeriod() const;
+      fraction proportionRestingTime() const;
+      fraction proportionTravellingTime() const;
+      speed averageTravellingSpeed() const;
+      seconds durationBeforeTravellingBegins() const;
+
+    private:
+      TrackSummaryOptions summaryOptions;
+
+      // Those of the Track, if the summary is made from one, so that the queries report the same violations.
+      TrackInvariants pointInvariants;
+
+      microseconds elapsed = 0;
+      metres heightGain = 0;
+      metres netHeightChange = 0;
+      metres startToFinish = 0;
+      metres length = 0;
+
+      // The waypoints found, indexed by Extreme; empty if the track is.
+      enum Extreme { Highest, Lowest, Northernmost, Southernmost, Easternmost, Westernmost,
+                     MostEquatorial, LeastEquatorial, Nearest, Farthest, extremeCount };
+      std::vector<Waypoint> extremes;
+      unsigned int nearCount = 0;
+
+      speed fastest = 0;
+      speed fastestAscent = 0;
+      speed fastestDescent = 0;
+      degrees maxLegGradient = 0;
+      degrees minLegGradient = 0;
+      degrees steepestLegGradient = 0;
+
+      PeriodTotals resting;
+      PeriodTotals travelling;
+
+      TrackSummary(std::span<const Trackpoint>, TrackInvariants, TrackSummaryOptions);
+
+      void requireTargetWaypoint() const;
+      Waypoint extreme(Extreme) const;
+  };
+}
+
+#endif
@@ -1,22 +1,95 @@
 #ifndef GPS_TRACK_H
 #define GPS_TRACK_H
 
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "point-columns.h"
+#include "sensor-data.h"
+#include "track-invariants.h"
+#include "track-leg.h"
 #include "types.h"
 #include "waypoint.h"
 #include "trackpoint.h"
 
 namespace GPS
 {
+  class ValidatedTrack;
+
   class Track
   {
     protected:
       const std::vector<Trackpoint> trackPoints;
+      const SensorData sensorData;
+      const TrackInvariants pointInvariants;
+
+      /* The track points stored by field, and the values of the legs between successive points, each
+       * built by the first query that needs them and shared by every later one (and by copies of the
+       * Track), until released.
+       */
+      std::shared_ptr<const PointColumns> columns() const;
+      std::shared_ptr<const LegColumns> legs() const;
 
     public:
-      Track(std::vector<Trackpoint>);
+      /* The sensor readings, if given, are for the track points in the same order.
+       * Throws a std::invalid_argument if there are readings for a different number of points.
+       */
+      Track(std::vector<Trackpoint>, SensorData = {});
+
+      Track(const Track&);
+
+      /* As the constructor, but for bulk ingest: points that are empty, whose times do not increase,
+       * or that have an infinite altitude, are rejected with the first violation rather than made into
+       * a Track, and nothing is thrown for them (or for mismatched sensor readings).
+       */
+      static ValidatedTrack validated(std::vector<Trackpoint>, SensorData = {});
+
+      // Whether the points meet each invariant, and if not which point first breaks it.
+      const TrackInvariants& invariants() const;
+
+      /* Free the memory held for the track points stored by field (about 32 bytes per point) and for
+       * the values of the legs between successive points (distances, durations, speeds and gradients,
+       * about 40 bytes per point); the next query that needs them builds them again.  Queries already
+       * under way in other threads are unaffected.
+       */
+      void releaseCaches() const;
+
+      // Whether the points stored by field, or the values of the legs, are currently held.
+      bool hasPointColumns() const;
+      bool hasLegCache() const;
+
+      // The track points, in order.
+      const std::vector<Trackpoint>& points() const;
+
+      // The sensor readings for the track points; empty if the track has none.
+      const SensorData& sensors() const;
+
+
+
+      /* The highest reading on the sensor channel.
+       * Throws a std::domain_error if no track point has a reading on that channel.
+       */
+      double maxSensorReading(SensorChannel) const;
+
+
+
+      /* The mean of the readings on the sensor channel, over the points that have one.
+       * Throws a std::domain_error if no track point has a reading on that channel.
+       */
+      double averageSensorReading(SensorChannel) const;
+
+
+
+      /* The highest mean of the readings on the sensor channel over any period of the specified
+       * duration (e.g. the best 20-minute power), taking the points whose times lie within the period.
+       * If the track is shorter than the period, this is the mean over the whole track.
+       * Throws a std::domain_error if no track point has a reading on that channel.
+       * Throws a std::invalid_argument exception if the specified duration is negative.
+       */
+      double maxAverageSensorReading(SensorChannel, seconds period) const;
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -228,19 +301,21 @@ namespace GPS
 
 
 
-      /* The waypoint on the track that comes immediately before the specified time.
+      /* The waypoint on the track that comes immediately before the specified time (in microseconds
+       * since the Unix Epoch, as for Trackpoint::timeStamp).
        * Throws a std::domain_error if there are no track points before that time.
        * Throws a std::domain_error if the time elapsed between any two adjacent points is zero or negative.
        */
-      Waypoint lastWaypointBefore(std::time_t targetTime) const;
+      Waypoint lastWaypointBefore(microseconds targetTime) const;
 
 
 
-      /* The waypoint on the track that comes immediately after the specified time.
+      /* The waypoint on the track that comes immediately after the specified time (in microseconds
+       * since the Unix Epoch, as for Trackpoint::timeStamp).
        * Throws a std::domain_error if there are no track points after that time.
        * Throws a std::domain_error if the time elapsed between any two adjacent points is zero or negative.
        */
-      Waypoint firstWaypointAfter(std::time_t targetTime) const;
+      Waypoint firstWaypointAfter(microseconds targetTime) const;
 
 
 
@@ -348,6 +423,37 @@ namespace GPS
        */
       seconds durationBeforeTravellingBegins(speed speedLimit) const;
 
+    private:
+      Track(std::vector<Trackpoint>, SensorData, TrackInvariants);
+
+      mutable std::mutex cacheMutex;
+      mutable std::shared_ptr<const PointColumns> pointColumns;
+      mutable std::shared_ptr<const LegColumns> legCache;
+
+      // Call while holding the cacheMutex.
+      const std::shared_ptr<const PointColumns>& buildPointColumns() const;
+  };
+
+  // A Track, or the reason that its points were rejected, in the manner of C++23's std::expected.
+  class ValidatedTrack
+  {
+    public:
+      explicit ValidatedTrack(std::unique_ptr<const Track>);
+      explicit ValidatedTrack(TrackViolation);
+
+      bool has_value() const;
+      explicit operator bool() const;
+
+      // Throws a std::logic_error if the points were rejected.
+      const Track& value() const;
+      const Track* operator->() const;
+
+      // Throws a std::logic_error if the points were accepted.
+      const TrackViolation& error() const;
+
+    private:
+      std::unique_ptr<const Track> track;
+      std::optional<TrackViolation> violation;
   };
 }
 
@@ -1,8 +1,7 @@
 #ifndef GPS_TRACKPOINT_H
 #define GPS_TRACKPOINT_H
 
-#include <ctime>
-
+#include "types.h"
 #include "waypoint.h"
 
 namespace GPS
@@ -10,7 +9,7 @@ namespace GPS
   struct Trackpoint
   {
      GPS::Waypoint waypoint;
-     std::time_t timeStamp;  // time_t is usually a long int denoting the Unix Epoch (number of seconds since 1st January 1970)
+     GPS::microseconds timeStamp;  // Microseconds since the Unix Epoch, so that points logged at 10-100 Hz have distinct times.
   };
 }
 
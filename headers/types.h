@@ -1,6 +1,8 @@
 #ifndef GPS_TYPES_H
 #define GPS_TYPES_H
 
+#include <cstdint>
+
 namespace GPS
 {
   using degrees  = double;
@@ -9,6 +11,9 @@ namespace GPS
   using seconds  = double;
   using speed    = double; // metres per second
   using fraction = double;
+
+  using microseconds = std::int64_t; // Time stamps are counted from the Unix Epoch (1st January 1970).
+  const microseconds microsecondsPerSecond = 1'000'000;
 }
 
 #endif
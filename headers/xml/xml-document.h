@@ -0,0 +1,181 @@
+#ifndef XML_DOCUMENT_H
+#define XML_DOCUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace XML
+{
+
+class Parser;
+
+/* A bump allocator.  Memory is released all at once, when the Arena is destroyed.
+ */
+class Arena
+{
+  public:
+    Arena() = default;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    void* allocate(std::size_t bytes, std::size_t alignment);
+
+    template <typename T>
+    T* allocateArray(std::size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Copy the text into the Arena.
+    std::string_view store(std::string_view);
+
+    // The total size of the blocks obtained from the heap.
+    std::size_t bytesReserved() const;
+
+  private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::byte* next = nullptr;
+    std::byte* limit = nullptr;
+    std::size_t blockSize = 64 * 1024;
+    std::size_t reserved = 0;
+};
+
+/* Each distinct name is stored once; interned names can be compared by their data() pointer.
+ */
+class NameTable
+{
+  public:
+    std::string_view intern(std::string_view, Arena&);
+
+    // The interned copy of the name, or a view with a null data() pointer if it has never been interned.
+    std::string_view find(std::string_view) const;
+
+  private:
+    std::unordered_set<std::string_view> names;
+};
+
+struct Attribute
+{
+    std::string_view name;  // Interned.
+    std::string_view value;
+};
+
+class Node;
+
+/* A forward range over sibling Nodes, optionally restricted to those with a given (interned) name.
+ */
+class NodeRange
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = Node;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const Node* node, const char* name);
+
+        const Node& operator*() const { return *node; }
+        const Node* operator->() const { return node; }
+        iterator& operator++();
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& other) const { return node == other.node; }
+
+      private:
+        const Node* node = nullptr;
+        const char* name = nullptr; // Null for unrestricted iteration.
+    };
+
+    NodeRange(const Node* first, const char* name) : first{first, name} {}
+
+    iterator begin() const { return first; }
+    iterator end() const { return {}; }
+    bool empty() const { return begin() == end(); }
+
+  private:
+    iterator first;
+};
+
+/* An element of a Document.  Nodes are owned by their Document and are immutable.
+ * Sub-elements are kept in document order.  Lookups by name mirror those of XML::Element,
+ * but return references and views rather than copies.
+ */
+class Node
+{
+  public:
+    std::string_view getName() const { return name; }
+    std::string_view getLeafContent() const { return leafContent; }
+    std::span<const Attribute> getAttributes() const { return {attributes, attributeCount}; }
+
+    // Throws a std::out_of_range exception if there is no such attribute.
+    std::string_view getAttribute(std::string_view attributeName) const;
+
+    // Throws a std::out_of_range exception if there is no such sub-element.
+    const Node& getSubElement(std::string_view subElementName, std::size_t subElementNum = 0) const;
+
+    // All sub-elements, in document order.
+    NodeRange getSubElements() const;
+
+    // The sub-elements with the given name, in document order.
+    NodeRange getSubElements(std::string_view subElementName) const;
+
+    bool containsAttribute(std::string_view) const;
+    bool containsSubElement(std::string_view) const;
+    unsigned int countSubElements(std::string_view) const;
+    bool isLeaf() const { return firstChild == nullptr; }
+
+  private:
+    friend class Document;
+    friend class NodeRange::iterator;
+
+    struct NameIndex;
+
+    std::string_view name;
+    std::string_view leafContent;
+    const Attribute* attributes = nullptr;
+    std::uint32_t attributeCount = 0;
+    std::uint32_t childCount = 0;
+    const Node* firstChild = nullptr;
+    const Node* nextSibling = nullptr;
+    const NameIndex* nameIndex = nullptr; // Only for Nodes with many sub-elements.
+    const NameTable* nameTable = nullptr;
+
+    const char* internedName(std::string_view) const;
+};
+
+/* A parsed XML document in which every node, attribute and leaf content lives in a single
+ * per-document Arena, and element/attribute names are interned.
+ */
+class Document
+{
+  public:
+    /* Build a Document from the Parser's events.
+     * Throws a std::domain_error for malformed XML.
+     */
+    explicit Document(Parser&);
+
+    Document(Document&&) = default;
+    Document& operator=(Document&&) = default;
+
+    const Node& getRootElement() const { return *root; }
+
+    // Memory obtained from the heap for nodes, attributes, names and text.
+    std::size_t bytesReserved() const { return arena.bytesReserved(); }
+
+  private:
+    std::unique_ptr<NameTable> names; // Heap-allocated so that Nodes can refer to it across moves.
+    Arena arena;
+    const Node* root = nullptr;
+
+    void buildNameIndexes(Node&);
+};
+
+}
+
+#endif
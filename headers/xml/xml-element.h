@@ -2,6 +2,7 @@
 #define XML_ELEMENT_H
 
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 
@@ -14,21 +15,29 @@ using RawXML = std::string;
 using ElementName = std::string;
 using AttributeName = std::string;
 using AttributeValue = std::string;
-using Attributes = std::map<AttributeName, AttributeValue>;
-using SubElements = std::map<ElementName, std::vector<Element>>;
+// Transparent comparators, so that lookups by std::string_view do not build temporary keys.
+using Attributes = std::map<AttributeName, AttributeValue, std::less<>>;
+using SubElements = std::map<ElementName, std::vector<Element>, std::less<>>;
 using LeafContent = std::string;
 
 class Element
 {
   public:
-    ElementName getName() const;
-    AttributeValue getAttribute(AttributeName) const;
-    Element getSubElement(ElementName, std::size_t subElementNum = 0) const;
-    LeafContent getLeafContent() const;
-
-    bool containsAttribute(AttributeName) const;
-    bool containsSubElement(ElementName) const;
-    unsigned int countSubElements(ElementName) const;
+    /* Accessors return references into the tree rather than copies.
+     * getAttribute() and getSubElement() throw a std::out_of_range exception if there is no such
+     * attribute or sub-element.
+     */
+    const ElementName& getName() const;
+    const AttributeValue& getAttribute(std::string_view) const;
+    const Element& getSubElement(std::string_view, std::size_t subElementNum = 0) const;
+    const LeafContent& getLeafContent() const;
+
+    // The sub-elements with the given name, in document order (empty if there are none).
+    const std::vector<Element>& getSubElements(std::string_view) const;
+
+    bool containsAttribute(std::string_view) const;
+    bool containsSubElement(std::string_view) const;
+    unsigned int countSubElements(std::string_view) const;
     bool isLeaf() const;
 
   protected:
@@ -0,0 +1,62 @@
+#ifndef XML_INCREMENTAL_PARSER_H
+#define XML_INCREMENTAL_PARSER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "xml-parser.h"
+
+namespace XML
+{
+
+/* Parses a document that arrives in chunks (e.g. from a socket or a decompressor), without
+ * waiting for the whole document.  Each call to feed() passes the handler an Event for every
+ * token that the new text completes; a token split across chunks is held back until the rest of
+ * it arrives.  Text is discarded once it has been consumed, so only the unfinished token and the
+ * latest chunk are buffered, however large the document.  An element that the filter skips is
+ * scanned a tag at a time as it arrives, so it is not held in full either.
+ *
+ * The events, and the documents accepted, are the same as for Parser::nextEvent().  The views in
+ * each Event are only valid during the call to the handler.
+ */
+class IncrementalParser
+{
+  public:
+    using EventHandler = std::function<void(const Event&)>;
+
+    explicit IncrementalParser(EventHandler, PathFilter = {});
+
+    // The Parser refers into the buffer, so an IncrementalParser cannot be copied or moved.
+    IncrementalParser(const IncrementalParser&) = delete;
+    IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+    /* Parse as much of the document as the text received so far allows.
+     * Throws a std::domain_error for malformed XML, after which the IncrementalParser cannot be used.
+     * Text after the end of the root element is ignored.
+     */
+    void feed(const char* data, std::size_t size);
+
+    /* Signal the end of the input.
+     * Throws a std::domain_error if the document is incomplete.
+     */
+    void finish();
+
+    // True once the root element has been closed.
+    bool isComplete() const;
+
+    // The text currently held: the unfinished token (or tag within a skipped element) and the latest chunk.
+    std::size_t bufferedSize() const;
+
+  private:
+    EventHandler handler;
+    std::string buffer;
+    Parser parser;
+    bool complete = false;
+
+    void parseAvailableText();
+};
+
+}
+
+#endif
@@ -2,54 +2,217 @@
 #define XML_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <istream>
-#include <set>
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 #include "xml-element.h"
+#include "xml-path-filter.h"
 
 namespace XML
 {
 
+struct AttributeView
+{
+    std::string_view name;
+    std::string_view value;
+};
+
+/* A single step through a document, as produced by Parser::nextEvent().
+ *
+ * Every non-self-closing element with no sub-elements is followed by exactly one Text event
+ * holding its leaf content (possibly empty).  As with the Element tree, text that precedes
+ * sub-elements is discarded.  The views (and the attribute span) are only valid until the
+ * next call to nextEvent().
+ */
+struct Event
+{
+    enum class Type { StartElement, Text, EndElement, EndOfDocument };
+
+    Type type;
+    std::string_view name;                     // StartElement, Text and EndElement: the element name.
+    std::span<const AttributeView> attributes; // StartElement: in document order, duplicates included.
+    std::string_view text;                     // Text: the leaf content.
+};
+
+/* Malformed XML.  The position is that of the character at which the problem was found:
+ * a byte offset from the start of the document, and a line and column counted from 1.
+ * The element path lists the names of the enclosing elements, e.g. "gpx/trk/trkpt".
+ */
+class ParseError : public std::domain_error
+{
+  public:
+    ParseError(const std::string& problem, std::size_t offset, std::size_t line, std::size_t column, std::string elementPath);
+
+    std::size_t offset() const { return errorOffset; }
+    std::size_t line() const { return errorLine; }
+    std::size_t column() const { return errorColumn; }
+    const std::string& elementPath() const { return path; }
+
+  private:
+    std::size_t errorOffset;
+    std::size_t errorLine;
+    std::size_t errorColumn;
+    std::string path;
+};
+
+/* The Parser works over a contiguous buffer of XML text.  All tokens (names, attribute values
+ * and leaf content) are std::string_views into that buffer; text is only copied when an Element
+ * is built from the tokens.
+ *
+ * The buffer must outlive the Parser.
+ */
 class Parser
 {
   public:
+    // Parse the entire contents of the stream.  The stream is read into a buffer owned by the Parser.
     Parser(std::istream&);
+
+    // Parse XML text held in memory (e.g. a std::string or a GPS::MappedFile).
+    Parser(std::string_view);
+
+    /* The positions refer into the text, which may be owned by the Parser, so a Parser cannot be
+     * copied or moved.
+     */
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+
+    /* Only build the elements that the filter keeps; anything else is skipped by scanning ahead to
+     * its closing tag, checking only that the tags within it are balanced.  This applies to both
+     * parseRootElement() and nextEvent(), and must be set before parsing starts.
+     */
+    void setFilter(PathFilter);
+
+    // Throws a ParseError (a std::domain_error) for malformed XML.
     Element parseRootElement();
 
+    /* Pull the next event from the document, without building any Elements.
+     * The same grammar is used as for parseRootElement(), so the same documents are accepted;
+     * malformed XML is reported with a ParseError when it is reached.
+     * Once the root element has been closed, every call returns an EndOfDocument event.
+     *
+     * A Parser should be used either for parseRootElement() or for nextEvent(), not both.
+     */
+    Event nextEvent();
+
+    /* A Parser for a run of sibling elements taken from the middle of a document, e.g. starting at a
+     * position found by scanning the text.  Instead of a single root element there may be any number
+     * of elements, separated by whitespace; nextEvent() reports EndOfDocument at the first closing tag
+     * or at the end of the text.
+     */
+    static Parser forElementSequence(std::string_view);
+
+    // The position, within the text, of the next character to be parsed.
+    const char* position() const { return cursor; }
+
+    /* Continue from a later position in the text, skipping sibling elements that have already been
+     * parsed elsewhere (e.g. with forElementSequence()).  Only valid straight after the EndElement
+     * event of an element other than the root; throws a std::logic_error otherwise.
+     */
+    void skipTo(const char* position);
+
   private:
-    std::istream& xmlSource;
+    friend class IncrementalParser;
+
+    std::string ownedSource;
+    const char* cursor;
+    const char* end;
+
+    /* Where positions in error reports are measured from, and its own position in the document
+     * (which is only beyond the start once an IncrementalParser has discarded text).
+     */
+    struct TextPosition
+    {
+        std::size_t offset, line, column;
+    };
+    const char* textStart;
+    TextPosition textStartPosition {0, 1, 1};
+
+    /* False while an IncrementalParser is still waiting for input.  Running out of text is then
+     * reported with an IncompleteInput exception, rather than as malformed XML.
+     */
+    bool inputIsComplete = true;
+    struct IncompleteInput {};
 
     struct OpeningTag;
 
-    Element parseElement();
+    enum class EventState { BeforeRootElement, BetweenSequenceElements, AfterOpeningTag, AfterSelfClosingTag, InSubElements,
+                            InSkippedElement, EndOfDocument };
+    EventState eventState = EventState::BeforeRootElement;
+    EventState afterTopLevelElement = EventState::EndOfDocument;
+
+    // For forElementSequence(), which returns the Parser without moving it.
+    Parser(std::string_view, EventState initialState, EventState afterTopLevelElement);
+    /* Copied, as an IncrementalParser discards consumed text.  The strings are reused, so only the
+     * first openElementCount are open.
+     */
+    std::vector<std::string> openElements;
+    std::size_t openElementCount = 0;
+    std::vector<AttributeView> parsedAttributes; // Reused by every opening tag.
+
+    PathFilter filter;
+    std::vector<PathFilter::Node> openFilterNodes;
+
+    /* The open elements within the element being skipped.  As for openElements, the names are copied
+     * and the strings reused, so that an IncrementalParser can discard the text scanned so far and
+     * continue the skip from skipResumePosition (in the InSkippedElement state) once more text arrives.
+     */
+    std::vector<std::string> skippedElements;
+    std::size_t skippedElementCount = 0;
+    const char* skipResumePosition = nullptr;
+
+    /* Just past the last whole element skipped by nextEvent() among sub-elements, where it can resume
+     * (in the InSubElements state) if it then runs out of input; null if none has been skipped since
+     * it was last cleared.  This lets an IncrementalParser keep its place in a long run of skipped
+     * siblings, rather than re-scanning the run as each chunk arrives.
+     */
+    const char* skippedUpTo = nullptr;
+
+    void openElement(std::string_view name);
+    std::string_view closeElement();
+    std::string_view currentElement() const;
+
+    Event startElementEvent();
+    Event endElementEvent();
+
+    Element parseElement(PathFilter::Node parent);
     OpeningTag parseOpeningTag();
-    Attributes parseAttributes();
-    std::string parseAttributeValue();
-    SubElements parseSubElements();
-    LeafContent parseLeafContent();
-    void parseClosingTag(ElementName);
-
-    std::string parseName();
+    void parseAttributes();
+    std::string_view parseAttributeValue();
+    SubElements parseSubElements(PathFilter::Node);
+    std::string_view parseLeafContent();
+    void parseClosingTag(std::string_view tagName);
+
+    bool nextElementIsSkipped(PathFilter::Node parent);
+    void skipElement();
+    void continueSkippedElement();
+    const char* findTagEnd();
+
+    std::string_view parseName();
     void parseWhitespace();
 
     void tryparseProlog(); // currently we discard the Prolog
 
     bool tryParseChar(char);
-    bool tryParseString(std::string);
+    bool tryParseString(std::string_view);
 
-    std::string parseBetweenDelimiters(char delimiter);
-    std::string parseUntil(char delimiter);
-    std::string parseUntilAnyOf(std::set<char> delimiters);
-    std::string parseWhileAnyOf(std::set<char> validChars);
+    std::string_view parseBetweenDelimiters(char delimiter);
+    std::string_view parseUntil(char delimiter);
 
     bool nameNext();
     bool closingTagNext();
 
-    void require(bool condition, std::string errorMessage);
+    void requireNotTruncated(const char* position);
+    void requireNotTruncated(std::string_view expected);
+
+    // The message is only built if the condition fails: the detail, if any, is appended in quotes.
+    void require(bool condition, const char* problem, std::string_view detail = {});
+    [[noreturn]] void fail(const char* problem, std::string_view detail = {});
 
-    const std::set<char> whitespaceChars {' ','\t','\n','\v','\f','\r'};
-    const std::set<char> nameDelimiters {' ','\t','\n','\v','\f','\r','/','>','=',endOfFileValueAsChar};
-    const char endOfFileValueAsChar = static_cast<char>(std::char_traits<char>::eof());
+    TextPosition positionOf(const char*) const;
+    void moveTextStart(const char*);
 };
 
 }
@@ -0,0 +1,59 @@
+#ifndef XML_PATH_FILTER_H
+#define XML_PATH_FILTER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace XML
+{
+
+/* Selects the elements of a document that a Parser should build; the rest are skipped.
+ *
+ * Paths list element names from the root, separated by '/'.  An element is kept if its path is
+ * one of the paths, or the start of one.  For example {"gpx/trk/trkpt"} keeps the root if it is
+ * a 'gpx', its 'trk' sub-elements, and their 'trkpt' sub-elements, but nothing within a 'trkpt'.
+ * The root element itself is always kept.
+ *
+ * A name of "*" matches any element, so a path made of "gpx", "trk" and "*" keeps every element
+ * directly within a 'trk'.  Where both a name and "*" match, the named path is followed.
+ */
+class PathFilter
+{
+  public:
+    // A position in the filter, one per open element.
+    using Node = std::size_t;
+
+    // Elements at this Node are skipped, along with everything within them.
+    static constexpr Node skipped = std::numeric_limits<Node>::max();
+
+    // Elements at this Node are kept, along with everything within them.
+    static constexpr Node keepAll = skipped - 1;
+
+    // A filter that keeps everything.
+    PathFilter() = default;
+
+    PathFilter(std::initializer_list<std::string_view> paths);
+
+    // The Node above the root element.
+    Node root() const;
+
+    // The Node for a sub-element with the given name.
+    Node child(Node parent, std::string_view name) const;
+
+  private:
+    struct Entry
+    {
+        std::string name;
+        std::vector<Node> children;
+    };
+
+    std::vector<Entry> entries; // Empty for a filter that keeps everything.
+};
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef XML_SCAN_H
+#define XML_SCAN_H
+
+#include <vector>
+
+/* Character-class scanning for the XML tokenizer.
+ *
+ * Each scan examines [begin,end) and returns a pointer to the first character that stops it,
+ * or end if there is none.  On x86-64 the scans process 16 (SSE2) or 32 (AVX2) bytes at a time;
+ * the widest implementation supported by the CPU is chosen at start-up.  Other platforms use the
+ * scalar implementation.
+ */
+namespace XML::Scan
+{
+  // The XML whitespace characters: space, \t, \n, \v, \f and \r.
+  bool isWhitespace(char);
+
+  // Whitespace, '/', '>' and '=' end a name.
+  bool isNameDelimiter(char);
+
+  struct Scanner
+  {
+      const char* name;
+      const char* (*findNameDelimiter)(const char* begin, const char* end);
+      const char* (*findChar)(const char* begin, const char* end, char target);
+      const char* (*skipWhitespace)(const char* begin, const char* end);
+  };
+
+  // The implementation used by the functions below.
+  const Scanner& selectedScanner();
+
+  // Every implementation that the CPU supports, narrowest first (for testing and benchmarking).
+  std::vector<Scanner> availableScanners();
+
+  inline const char* findNameDelimiter(const char* begin, const char* end)
+  {
+      return selectedScanner().findNameDelimiter(begin, end);
+  }
+
+  inline const char* findChar(const char* begin, const char* end, char target)
+  {
+      return selectedScanner().findChar(begin, end, target);
+  }
+
+  inline const char* skipWhitespace(const char* begin, const char* end)
+  {
+      return selectedScanner().skipWhitespace(begin, end);
+  }
+}
+
+#endif
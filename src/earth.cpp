@@ -54,6 +54,15 @@ namespace GPS
           }
       }
 
+      metres haversineDistance(radians lat1, radians lon1, double cosLat1, radians lat2, radians lon2, double cosLat2)
+      /* The Haversine Formula
+       * See: https://en.wikipedia.org/wiki/Haversine_formula
+       */
+      {
+          const double h = sinSqr((lat2-lat1)/2) + cosLat1*cosLat2*sinSqr((lon2-lon1)/2);
+          return 2 * meanRadius * std::asin(std::sqrt(h));
+      }
+
       bool isValidAltitude(metres altitude)
       {
           return altitude >= -meanRadius;
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <system_error>
+
+#include "mapped-file.h"
+
+#include "gpx-batch-parser.h"
+#include "gpx-parser.h"
+
+namespace GPS::GPX
+{
+  BatchCounters::BatchCounters()
+    : start{std::chrono::steady_clock::now()}
+  {}
+
+  std::size_t BatchCounters::documents() const
+  {
+      return documentCount;
+  }
+
+  std::size_t BatchCounters::failedDocuments() const
+  {
+      return failedDocumentCount;
+  }
+
+  std::size_t BatchCounters::bytes() const
+  {
+      return byteCount;
+  }
+
+  double BatchCounters::elapsedSeconds() const
+  {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  double BatchCounters::documentsPerSecond() const
+  {
+      return documents() / elapsedSeconds();
+  }
+
+  double BatchCounters::megabytesPerSecond() const
+  {
+      return bytes() / 1e6 / elapsedSeconds();
+  }
+
+  void BatchCounters::recordDocument(std::size_t bytes, bool failed)
+  {
+      ++documentCount;
+      if (failed) ++failedDocumentCount;
+      byteCount += bytes;
+  }
+
+  /* Admits documents while both limits allow.  The first document is always admitted, however
+   * large, so that one oversized document cannot stall the batch.
+   */
+  class BatchGate
+  {
+    public:
+      BatchGate(const BatchLimits& limits, unsigned int threadCount)
+        : maxDocuments{limits.maxDocumentsInFlight != 0 ? limits.maxDocumentsInFlight : threadCount},
+          maxBytes{limits.maxBytesInFlight}
+      {}
+
+      void enter(std::size_t bytes)
+      {
+          std::unique_lock<std::mutex> lock {mutex};
+          spaceAvailable.wait(lock, [&]{ return documents == 0 || (documents < maxDocuments && bytesInFlight + bytes <= maxBytes); });
+          ++documents;
+          bytesInFlight += bytes;
+      }
+
+      void leave(std::size_t bytes)
+      {
+          {
+              std::lock_guard<std::mutex> lock {mutex};
+              --documents;
+              bytesInFlight -= bytes;
+          }
+          spaceAvailable.notify_one();
+      }
+
+    private:
+      const unsigned int maxDocuments;
+      const std::size_t maxBytes;
+      std::mutex mutex;
+      std::condition_variable spaceAvailable;
+      unsigned int documents = 0;
+      std::size_t bytesInFlight = 0;
+  };
+
+  // Parse each document on the pool.  The sizes are needed for the limits before the documents are opened.
+  std::vector<BatchResult> parseBatch(std::size_t documentCount,
+                                      const std::function<std::size_t(std::size_t document)>& sizeOf,
+                                      const std::function<void(std::size_t document, std::vector<GPS::Trackpoint>&)>& parse,
+                                      GPS::ThreadPool& pool, const BatchLimits& limits, BatchCounters* counters)
+  {
+      std::vector<BatchResult> results(documentCount);
+      std::vector<std::future<void>> tasks;
+      tasks.reserve(documentCount);
+      BatchGate gate {limits, pool.threadCount()};
+
+      for (std::size_t document = 0; document < documentCount; ++document)
+      {
+          const std::size_t size = sizeOf(document);
+          gate.enter(size);
+          tasks.push_back(pool.submit([&, document, size]
+          {
+              BatchResult& result = results[document];
+              try
+              {
+                  parse(document, result.trackPoints);
+              }
+              catch (...)
+              {
+                  result.trackPoints = {};
+                  result.error = std::current_exception();
+              }
+              if (counters != nullptr) counters->recordDocument(size, ! result.succeeded());
+              gate.leave(size);
+          }));
+      }
+
+      for (std::future<void>& task : tasks)
+      {
+          task.get();
+      }
+      return results;
+  }
+
+  std::vector<BatchResult> parseTrackFiles(const std::vector<std::string>& filePaths, GPS::ThreadPool& pool,
+                                           const BatchLimits& limits, BatchCounters* counters)
+  {
+      // A file whose size cannot be read counts as empty here, and reports its error when it is opened.
+      const auto sizeOf = [&filePaths](std::size_t file)
+      {
+          std::error_code error;
+          const std::uintmax_t size = std::filesystem::file_size(filePaths[file], error);
+          return error ? std::size_t {0} : static_cast<std::size_t>(size);
+      };
+      const auto parse = [&filePaths](std::size_t file, std::vector<GPS::Trackpoint>& trackPoints)
+      {
+          GPS::MappedFile gpxFile {filePaths[file]};
+          parseTrackString(gpxFile.contents(), trackPoints);
+      };
+      return parseBatch(filePaths.size(), sizeOf, parse, pool, limits, counters);
+  }
+
+  std::vector<BatchResult> parseTrackStrings(const std::vector<std::string_view>& gpxTexts, GPS::ThreadPool& pool,
+                                             const BatchLimits& limits, BatchCounters* counters)
+  {
+      const auto sizeOf = [&gpxTexts](std::size_t text) { return gpxTexts[text].size(); };
+      const auto parse = [&gpxTexts](std::size_t text, std::vector<GPS::Trackpoint>& trackPoints)
+      {
+          parseTrackString(gpxTexts[text], trackPoints);
+      };
+      return parseBatch(gpxTexts.size(), sizeOf, parse, pool, limits, counters);
+  }
+}
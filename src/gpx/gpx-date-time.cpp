@@ -0,0 +1,215 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "gpx-date-time.h"
+
+namespace GPS::GPX
+{
+  const long long secondsPerDay = 24 * 60 * 60;
+
+  bool isLeapYear(int year)
+  {
+      return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  }
+
+  unsigned int daysInMonth(int year, unsigned int month)
+  {
+      const unsigned int monthLengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+      return month == 2 && isLeapYear(year) ? 29 : monthLengths[month - 1];
+  }
+
+  /* Read a fixed number of decimal digits, advancing the position.
+   * Returns false (leaving the position unspecified) if there are too few digits.
+   */
+  bool readDigits(std::string_view text, std::size_t& position, std::size_t count, unsigned int& value)
+  {
+      if (text.size() - position < count) return false;
+
+      value = 0;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+          const unsigned int digit = static_cast<unsigned char>(text[position + i]) - '0';
+          if (digit > 9) return false;
+          value = value * 10 + digit;
+      }
+      position += count;
+      return true;
+  }
+
+  bool readChar(std::string_view text, std::size_t& position, char expected)
+  {
+      if (position == text.size() || text[position] != expected) return false;
+      ++position;
+      return true;
+  }
+
+  std::string_view trimWhitespace(std::string_view text)
+  {
+      const char* whitespace = " \t\n\v\f\r";
+      const std::size_t first = text.find_first_not_of(whitespace);
+      if (first == std::string_view::npos) return {};
+      return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+  }
+
+  [[noreturn]] void malformedDateTime(std::string_view rawDateTime)
+  {
+      throw std::domain_error("Malformed date/time content: " + std::string{rawDateTime});
+  }
+
+  GPS::microseconds DateTimeDecoder::decodeMicroseconds(std::string_view rawDateTime)
+  {
+      const std::string_view text = trimWhitespace(rawDateTime);
+      const std::size_t dateLength = sizeof(cachedDate);
+      std::size_t position = 0;
+
+      if (text.size() >= dateLength && std::memcmp(text.data(), cachedDate, dateLength) == 0)
+      {
+          position = dateLength;
+      }
+      else
+      {
+          unsigned int year, month, day;
+          const bool isDate = readDigits(text, position, 4, year) && readChar(text, position, '-')
+                              && readDigits(text, position, 2, month) && readChar(text, position, '-')
+                              && readDigits(text, position, 2, day);
+          if (! isDate || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month))
+          {
+              malformedDateTime(rawDateTime);
+          }
+          std::memcpy(cachedDate, text.data(), dateLength);
+          cachedDateStart = daysFromCivil(year, month, day) * secondsPerDay;
+      }
+
+      unsigned int hours, minutes, seconds;
+      const bool isTime = readChar(text, position, 'T')
+                          && readDigits(text, position, 2, hours) && readChar(text, position, ':')
+                          && readDigits(text, position, 2, minutes) && readChar(text, position, ':')
+                          && readDigits(text, position, 2, seconds);
+      // A second of 60 is a leap second.
+      if (! isTime || hours > 23 || minutes > 59 || seconds > 60)
+      {
+          malformedDateTime(rawDateTime);
+      }
+
+      long long fraction = 0;
+      if (readChar(text, position, '.'))
+      {
+          const std::size_t fractionStart = position;
+          long long scale = GPS::microsecondsPerSecond;
+          for (; position < text.size() && text[position] >= '0' && text[position] <= '9'; ++position)
+          {
+              scale /= 10; // Zero beyond the sixth digit.
+              fraction += (text[position] - '0') * scale;
+          }
+          if (position == fractionStart) malformedDateTime(rawDateTime);
+      }
+
+      long long offsetSeconds = 0;
+      if (position < text.size() && (text[position] == '+' || text[position] == '-'))
+      {
+          const int sign = text[position++] == '+' ? 1 : -1;
+          unsigned int offsetHours, offsetMinutes = 0;
+          if (! readDigits(text, position, 2, offsetHours)) malformedDateTime(rawDateTime);
+          if (position < text.size())
+          {
+              readChar(text, position, ':');
+              if (! readDigits(text, position, 2, offsetMinutes)) malformedDateTime(rawDateTime);
+          }
+          if (offsetHours > 23 || offsetMinutes > 59) malformedDateTime(rawDateTime);
+          offsetSeconds = sign * (offsetHours * 3600LL + offsetMinutes * 60LL);
+      }
+      else
+      {
+          readChar(text, position, 'Z');
+      }
+
+      if (position != text.size()) malformedDateTime(rawDateTime);
+
+      const long long wholeSeconds = cachedDateStart + hours * 3600LL + minutes * 60LL + seconds - offsetSeconds;
+      return wholeSeconds * GPS::microsecondsPerSecond + fraction;
+  }
+
+  std::time_t DateTimeDecoder::decode(std::string_view rawDateTime)
+  {
+      const GPS::microseconds time = decodeMicroseconds(rawDateTime);
+      return time / GPS::microsecondsPerSecond - (time % GPS::microsecondsPerSecond < 0);
+  }
+
+  std::time_t parseDateTime(std::string_view rawDateTime)
+  {
+      DateTimeDecoder decoder;
+      return decoder.decode(rawDateTime);
+  }
+
+  struct CivilDate
+  {
+      long long year;
+      unsigned int month, day;
+  };
+
+  // The inverse of daysFromCivil(); see http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+  CivilDate civilFromDays(long long days)
+  {
+      days += 719468;
+      const long long era = (days >= 0 ? days : days - 146096) / 146097;
+      const unsigned int dayOfEra = static_cast<unsigned int>(days - era * 146097);
+      const unsigned int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+      const unsigned int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+      const unsigned int monthFromMarch = (5 * dayOfYear + 2) / 153;
+      const unsigned int day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+      const unsigned int month = monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9;
+      return {yearOfEra + era * 400 + (month <= 2), month, day};
+  }
+
+  char* writeDigits(char* output, unsigned int value, unsigned int count)
+  {
+      for (unsigned int i = count; i > 0; --i)
+      {
+          output[i - 1] = static_cast<char>('0' + value % 10);
+          value /= 10;
+      }
+      return output + count;
+  }
+
+  char* formatDateTime(std::time_t dateTime, char* output)
+  {
+      // Round towards negative infinity, so that times before 1970 fall on the right day.
+      const long long seconds = dateTime;
+      const long long days = seconds / secondsPerDay - (seconds % secondsPerDay < 0);
+      const long long secondOfDay = seconds - days * secondsPerDay;
+
+      const CivilDate date = civilFromDays(days);
+      if (date.year < 0 || date.year > 9999)
+      {
+          throw std::domain_error("Cannot format date/time " + std::to_string(seconds) + ": the year is outside 0000-9999.");
+      }
+
+      output = writeDigits(output, date.year, 4);
+      *output++ = '-';
+      output = writeDigits(output, date.month, 2);
+      *output++ = '-';
+      output = writeDigits(output, date.day, 2);
+      *output++ = 'T';
+      output = writeDigits(output, secondOfDay / 3600, 2);
+      *output++ = ':';
+      output = writeDigits(output, secondOfDay / 60 % 60, 2);
+      *output++ = ':';
+      output = writeDigits(output, secondOfDay % 60, 2);
+      *output++ = 'Z';
+      return output;
+  }
+
+  char* formatTimeStamp(GPS::microseconds timeStamp, char* output)
+  {
+      const long long fraction = (timeStamp % GPS::microsecondsPerSecond + GPS::microsecondsPerSecond) % GPS::microsecondsPerSecond;
+      output = formatDateTime((timeStamp - fraction) / GPS::microsecondsPerSecond, output);
+      if (fraction == 0) return output;
+
+      --output; // Overwrite the 'Z'.
+      *output++ = '.';
+      output = fraction % 1000 == 0 ? writeDigits(output, fraction / 1000, 3) : writeDigits(output, fraction, 6);
+      *output++ = 'Z';
+      return output;
+  }
+}
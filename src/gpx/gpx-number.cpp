@@ -0,0 +1,41 @@
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "xml-scan.h"
+
+#include "gpx-number.h"
+
+namespace GPS::GPX
+{
+  bool tryParseNumber(std::string_view text, double& value)
+  {
+      const char* begin = text.data();
+      const char* end = begin + text.size();
+      while (begin != end && XML::Scan::isWhitespace(*begin)) ++begin;
+      while (begin != end && XML::Scan::isWhitespace(end[-1])) --end;
+
+      // std::from_chars accepts a leading '-' but not a '+'.
+      if (begin != end && *begin == '+' && end - begin > 1 && begin[1] != '-') ++begin;
+
+      // The fixed and scientific formats exclude hexadecimal; "inf" and "nan" are excluded below.
+      double result;
+      const auto [parsedEnd, error] = std::from_chars(begin, end, result, std::chars_format::general);
+      if (error != std::errc {} || parsedEnd != end || begin == end || ! std::isfinite(result)) return false;
+
+      value = result;
+      return true;
+  }
+
+  double parseNumber(std::string_view text)
+  {
+      double value;
+      if (! tryParseNumber(text, value))
+      {
+          throw std::domain_error("Malformed number content: " + std::string{text});
+      }
+      return value;
+  }
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <future>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gzip.h"
+#include "mapped-file.h"
+#include "thread-pool.h"
+#include "xml-parser.h"
+#include "xml-scan.h"
+#include "gpx-track-reader.h"
+
+#include "gpx-parser.h"
+
+namespace GPS::GPX
+{
+  // Smaller documents are not worth splitting.
+  const std::size_t minPieceSize = 256 * 1024;
+
+  // More pieces than threads, so that the threads stay busy when pieces take different times.
+  const unsigned int piecesPerThread = 4;
+
+  /* The points from a run of sibling elements parsed by a worker thread.
+   * The run ends at 'end', just after the last element that was parsed without error.
+   */
+  struct PointRun
+  {
+      std::vector<GPS::Trackpoint> points;
+      const char* end;
+  };
+
+  /* Split points are just after a "</trkpt>" that is followed (after any whitespace) by a "<trkpt".
+   * They are only guesses: the text is not parsed, so the sequential driver checks each one.
+   */
+  std::vector<const char*> findSplitPoints(std::string_view gpx, unsigned int pieceCount)
+  {
+      const std::string_view closingTag = "</trkpt>";
+      const std::string_view openingTag = "<trkpt";
+
+      std::vector<const char*> splitPoints;
+      std::size_t searchFrom = 0;
+      for (unsigned int piece = 1; piece < pieceCount; ++piece)
+      {
+          searchFrom = std::max(searchFrom, gpx.size() / pieceCount * piece);
+          for (;;)
+          {
+              const std::size_t closingTagPosition = gpx.find(closingTag, searchFrom);
+              if (closingTagPosition == std::string_view::npos) return splitPoints;
+
+              searchFrom = closingTagPosition + closingTag.size();
+              const char* nextElement = XML::Scan::skipWhitespace(gpx.data() + searchFrom, gpx.data() + gpx.size());
+              const std::string_view rest {nextElement, static_cast<std::size_t>(gpx.data() + gpx.size() - nextElement)};
+              if (rest.starts_with(openingTag) && rest.size() > openingTag.size() && XML::Scan::isNameDelimiter(rest[openingTag.size()]))
+              {
+                  splitPoints.push_back(gpx.data() + searchFrom);
+                  break;
+              }
+          }
+      }
+      return splitPoints;
+  }
+
+  /* Parse the sibling 'trkpt' elements from 'start', stopping at the end of their parent, once 'limit'
+   * has been reached, before the first element that is not a 'trkpt' (e.g. a 'trkseg' after points
+   * directly within the 'trk', which the driver must see), or before the first element containing an
+   * error (which the driver will report).
+   */
+  PointRun parsePointRun(const char* start, const char* limit, const char* end)
+  {
+      PointRun run {{}, start};
+      TrackReader reader = TrackReader::forSegmentContents([&run](const GPS::Trackpoint& trackPoint) { run.points.push_back(trackPoint); });
+      XML::Parser parser = XML::Parser::forElementSequence({start, static_cast<std::size_t>(end - start)});
+      parser.setFilter(TrackReader::segmentContentsFilter());
+
+      try
+      {
+          unsigned int depth = 0;
+          for (XML::Event event = parser.nextEvent(); event.type != XML::Event::Type::EndOfDocument; event = parser.nextEvent())
+          {
+              if (event.type == XML::Event::Type::StartElement && depth == 0 && event.name != "trkpt") break;
+
+              reader.consume(event);
+              if (event.type == XML::Event::Type::StartElement)
+              {
+                  ++depth;
+              }
+              else if (event.type == XML::Event::Type::EndElement && --depth == 0)
+              {
+                  if (reader.hasFailed()) break;
+                  run.end = parser.position();
+                  if (run.end >= limit) break;
+              }
+          }
+      }
+      catch (const std::exception&)
+      {
+          // Malformed XML: the run ends before the element containing the error.
+      }
+      return run;
+  }
+
+  std::vector<GPS::Trackpoint> parseTrackInParallel(std::string_view gpx, GPS::ThreadPool& pool)
+  {
+      // Compressed text cannot be split, so it is decompressed and parsed in a single pipeline.
+      if (GPS::isGzipData(gpx)) return parseTrackString(gpx);
+
+      const unsigned int pieceCount = std::min<std::size_t>(gpx.size() / minPieceSize + 1, pool.threadCount() * piecesPerThread + 1);
+      const std::vector<const char*> splitPoints = findSplitPoints(gpx, pieceCount);
+      if (splitPoints.empty()) return parseTrackString(gpx);
+
+      // The driver parses the first piece itself; the others are parsed on the pool.
+      std::vector<std::future<PointRun>> pointRuns;
+      pointRuns.reserve(splitPoints.size());
+      for (std::size_t i = 0; i < splitPoints.size(); ++i)
+      {
+          const char* limit = i + 1 < splitPoints.size() ? splitPoints[i + 1] : gpx.data() + gpx.size();
+          pointRuns.push_back(pool.submit([start = splitPoints[i], limit, end = gpx.data() + gpx.size()]{
+              return parsePointRun(start, limit, end);
+          }));
+      }
+
+      // The tasks refer to the text, so they must finish before the text can go, even after an exception.
+      struct WaitForAll
+      {
+          std::vector<std::future<PointRun>>& futures;
+          ~WaitForAll() { for (auto& future : futures) if (future.valid()) future.wait(); }
+      } waitForAll {pointRuns};
+
+      /* The driver parses the whole document sequentially, except that, on reaching a split point
+       * straight after a 'trkpt' within a 'trkseg', it takes the points from that piece and skips over
+       * it.  A split point that is not reached in that way (e.g. because it falls within a different
+       * element, or after a 'trkpt' directly within the 'trk') is ignored, and its text is parsed by
+       * the driver.  So the result is exactly that of the sequential parser; errors are always found
+       * and reported by the driver.
+       */
+      std::vector<GPS::Trackpoint> trackPoints;
+      TrackReader reader {[&trackPoints](const GPS::Trackpoint& trackPoint) { trackPoints.push_back(trackPoint); }};
+      XML::Parser parser {gpx};
+      parser.setFilter(TrackReader::filter());
+      std::size_t nextSplitPoint = 0;
+      unsigned int depth = 0;
+
+      for (XML::Event event = parser.nextEvent(); event.type != XML::Event::Type::EndOfDocument; event = parser.nextEvent())
+      {
+          reader.consume(event);
+          if (event.type == XML::Event::Type::StartElement) ++depth;
+          if (event.type != XML::Event::Type::EndElement || --depth == 0 || event.name != "trkpt") continue;
+
+          while (nextSplitPoint < splitPoints.size() && splitPoints[nextSplitPoint] <= parser.position())
+          {
+              if (splitPoints[nextSplitPoint] == parser.position() && reader.isWithinSegment())
+              {
+                  PointRun run = pointRuns[nextSplitPoint].get();
+                  if (run.end != parser.position())
+                  {
+                      reader.consumePoints(run.points);
+                      parser.skipTo(run.end);
+                  }
+              }
+              ++nextSplitPoint;
+          }
+      }
+
+      reader.finish();
+      return trackPoints;
+  }
+
+  std::vector<GPS::Trackpoint> parseTrackStream(std::istream& gpxStream, GPS::ThreadPool& pool)
+  {
+      std::ostringstream gpxBuffer;
+      gpxBuffer << gpxStream.rdbuf();
+      const std::string gpxText = std::move(gpxBuffer).str();
+      return parseTrackInParallel(gpxText, pool);
+  }
+
+  std::vector<GPS::Trackpoint> parseTrackString(std::string_view gpxText, GPS::ThreadPool& pool)
+  {
+      return parseTrackInParallel(gpxText, pool);
+  }
+
+  std::vector<GPS::Trackpoint> parseTrackFile(const std::string& filePath, GPS::ThreadPool& pool)
+  {
+      GPS::MappedFile gpxFile {filePath};
+      return parseTrackInParallel(gpxFile.contents(), pool);
+  }
+}
@@ -1,141 +1,177 @@
 #include <string>
-#include <sstream>
-#include <iostream>
-#include <iomanip>
-#include <ctime>
-
-#include <boost/algorithm/string.hpp>
+#include <string_view>
+#include <utility>
 
+#include "gzip.h"
+#include "mapped-file.h"
 #include "xml-parser.h"
+#include "gpx-track-reader.h"
 
 #include "gpx-parser.h"
 
 namespace GPS::GPX
 {
-  void requireElementIs(const XML::Element& element, std::string elementName)
+  void parseTrackWith(XML::Parser& parser, const TrackpointSink& sink, GPS::SensorData* sensors)
   {
-      if (element.getName() != elementName)
+      parser.setFilter(sensors ? TrackReader::filterWithSensors() : TrackReader::filter());
+      TrackReader reader {sink, sensors};
+      XML::Event event;
+      do
       {
-          throw std::domain_error("Missing '" + elementName + "' element.");
+          event = parser.nextEvent();
+          reader.consume(event);
       }
+      while (event.type != XML::Event::Type::EndOfDocument);
+      reader.finish();
   }
 
-  void requireSubElementExists(const XML::Element& element, std::string subElementName)
+  // Decompression runs on a background thread, a few chunks ahead of the parser.
+  void parseCompressedTrack(GPS::BackgroundGzipReader::Source source, const TrackpointSink& sink, GPS::SensorData* sensors)
   {
-      if (! element.containsSubElement(subElementName) )
+      GPS::BackgroundGzipReader reader {std::move(source)};
+      IncrementalTrackParser parser {sink, sensors};
+      for (std::string_view chunk = reader.nextChunk(); ! chunk.empty(); chunk = reader.nextChunk())
       {
-          throw std::domain_error("Missing '" + subElementName + "' element.");
+          parser.feed(chunk.data(), chunk.size());
       }
+      parser.finish();
   }
 
-  void requireAttributeExists(const XML::Element& element, std::string attributeName)
+  void parseCompressedTrack(std::string_view compressed, const TrackpointSink& sink, GPS::SensorData* sensors)
   {
-      if (! element.containsAttribute(attributeName))
-      {
-          throw std::domain_error("Missing '" + attributeName + "' attribute.");
-      }
+      parseCompressedTrack([compressed](char* buffer, std::size_t size) mutable {
+          const std::size_t count = compressed.copy(buffer, size);
+          compressed.remove_prefix(count);
+          return count;
+      }, sink, sensors);
   }
 
-  GPS::Waypoint extractWaypointFromPt(const XML::Element& ptElement)
+  TrackpointSink appendTo(std::vector<GPS::Trackpoint>& trackPoints)
   {
-      requireAttributeExists(ptElement,"lat");
-      requireAttributeExists(ptElement,"lon");
-      degrees lat = std::stod(ptElement.getAttribute("lat"));
-      degrees lon = std::stod(ptElement.getAttribute("lon"));
+      return [&trackPoints](const GPS::Trackpoint& trackPoint) { trackPoints.push_back(trackPoint); };
+  }
 
-      metres ele = ptElement.containsSubElement("ele") ? std::stod(ptElement.getSubElement("ele").getLeafContent()) : 0;
+  void parseTrackStream(std::istream& gpxStream, const TrackpointSink& sink, GPS::SensorData* sensors)
+  {
+      // One byte is enough to tell: no XML document can start with the first gzip magic byte.
+      if (gpxStream.peek() == 0x1f)
+      {
+          parseCompressedTrack([&gpxStream](char* buffer, std::size_t size) {
+              gpxStream.read(buffer, size);
+              return static_cast<std::size_t>(gpxStream.gcount());
+          }, sink, sensors);
+          return;
+      }
 
-      return GPS::Waypoint(lat,lon,ele);
+      XML::Parser parser {gpxStream};
+      parseTrackWith(parser, sink, sensors);
   }
 
-  /* Parse a date/time stamp in the ISO 8601 Interchange Standard format.
-   * e.g. "2001-02-12T02:20:15Z"
-   */
-  std::time_t parseDateTime(const std::string& rawDateTime)
+  void parseTrackString(std::string_view gpxText, const TrackpointSink& sink, GPS::SensorData* sensors)
   {
-      // For documentation on the format specifiers, see: https://en.cppreference.com/w/cpp/io/manip/get_time
-      const std::string dateTimeFormat = "%Y-%m-%dT%H:%M:%SZ";
+      if (GPS::isGzipData(gpxText)) return parseCompressedTrack(gpxText, sink, sensors);
 
-      tm dateTime;
+      XML::Parser parser {gpxText};
+      parseTrackWith(parser, sink, sensors);
+  }
 
-      std::istringstream dateTimeStream{rawDateTime};
-      dateTimeStream >> std::get_time(&dateTime, dateTimeFormat.c_str());
+  void parseTrackFile(const std::string& filePath, const TrackpointSink& sink, GPS::SensorData* sensors)
+  {
+      GPS::MappedFile gpxFile {filePath};
+      if (GPS::isGzipData(gpxFile.contents())) return parseCompressedTrack(gpxFile.contents(), sink, sensors);
 
-      if (dateTimeStream.fail())
-      {
-          throw std::domain_error("Malformed date/time content: " + rawDateTime);
-      }
+      XML::Parser parser {gpxFile.contents()};
+      parseTrackWith(parser, sink, sensors);
+  }
 
-      return std::mktime(&dateTime);
+  void parseTrackStream(std::istream& gpxStream, const TrackpointSink& sink)
+  {
+      parseTrackStream(gpxStream, sink, nullptr);
   }
 
-  std::time_t extractTimeFromPt(const XML::Element& ptElement)
+  void parseTrackString(std::string_view gpxText, const TrackpointSink& sink)
   {
-      requireSubElementExists(ptElement,"time");
+      parseTrackString(gpxText, sink, nullptr);
+  }
 
-      std::string time = ptElement.getSubElement("time").getLeafContent();
+  void parseTrackFile(const std::string& filePath, const TrackpointSink& sink)
+  {
+      parseTrackFile(filePath, sink, nullptr);
+  }
 
-      return parseDateTime(time);
+  void parseTrackStream(std::istream& gpxStream, std::vector<GPS::Trackpoint>& trackPoints)
+  {
+      parseTrackStream(gpxStream, appendTo(trackPoints));
   }
 
-  GPS::Trackpoint extractTrackPointFromTrkpt(const XML::Element& trkpt)
+  void parseTrackString(std::string_view gpxText, std::vector<GPS::Trackpoint>& trackPoints)
   {
-      return { extractWaypointFromPt(trkpt),
-               extractTimeFromPt(trkpt)
-             };
+      parseTrackString(gpxText, appendTo(trackPoints));
   }
 
-  std::vector<GPS::Trackpoint> extractTrackPointsFrom(const XML::Element& element)
+  void parseTrackFile(const std::string& filePath, std::vector<GPS::Trackpoint>& trackPoints)
   {
-      std::vector<GPS::Trackpoint> trackPoints;
+      parseTrackFile(filePath, appendTo(trackPoints));
+  }
 
-      requireSubElementExists(element,"trkpt");
-      for (unsigned int i = 0; i < element.countSubElements("trkpt"); ++i)
-      {
-          XML::Element trkpt = element.getSubElement("trkpt",i);
-          trackPoints.push_back(extractTrackPointFromTrkpt(trkpt));
-      }
+  void parseTrackStream(std::istream& gpxStream, std::vector<GPS::Trackpoint>& trackPoints, GPS::SensorData& sensors)
+  {
+      parseTrackStream(gpxStream, appendTo(trackPoints), &sensors);
+  }
 
-      return trackPoints;
+  void parseTrackString(std::string_view gpxText, std::vector<GPS::Trackpoint>& trackPoints, GPS::SensorData& sensors)
+  {
+      parseTrackString(gpxText, appendTo(trackPoints), &sensors);
   }
 
-  std::vector<GPS::Trackpoint> extractTrackPointsFromTrk(const XML::Element& trk)
+  void parseTrackFile(const std::string& filePath, std::vector<GPS::Trackpoint>& trackPoints, GPS::SensorData& sensors)
   {
-      if (trk.containsSubElement("trkseg"))
-      {
-          std::vector<GPS::Trackpoint> trackPoints;
+      parseTrackFile(filePath, appendTo(trackPoints), &sensors);
+  }
 
-          for (unsigned int i = 0; i < trk.countSubElements("trkseg"); ++i)
-          {
-              XML::Element trkseg = trk.getSubElement("trkseg",i);
-              std::vector<GPS::Trackpoint> trackPointsInThisSegment = extractTrackPointsFrom(trkseg);
-              trackPoints.insert(trackPoints.end(), trackPointsInThisSegment.begin(), trackPointsInThisSegment.end());
-          }
+  std::vector<GPS::Trackpoint> parseTrackStream(std::istream& gpxStream)
+  {
+      std::vector<GPS::Trackpoint> trackPoints;
+      parseTrackStream(gpxStream, trackPoints);
+      return trackPoints;
+  }
 
-          return trackPoints;
-      }
-      else
-      {
-          return extractTrackPointsFrom(trk);
-      }
+  std::vector<GPS::Trackpoint> parseTrackString(std::string_view gpxText)
+  {
+      std::vector<GPS::Trackpoint> trackPoints;
+      parseTrackString(gpxText, trackPoints);
+      return trackPoints;
   }
 
-  std::vector<GPS::Trackpoint> parseTrackStream(std::istream& gpxStream)
+  std::vector<GPS::Trackpoint> parseTrackFile(const std::string& filePath)
   {
-      XML::Parser parser {gpxStream};
+      std::vector<GPS::Trackpoint> trackPoints;
+      parseTrackFile(filePath, trackPoints);
+      return trackPoints;
+  }
 
-      XML::Element gpx = parser.parseRootElement();
-      requireElementIs(gpx,"gpx");
+  template <typename Source>
+  std::vector<GPS::Trackpoint> parseDecimatedTrack(Source&& source, const GPS::DecimationOptions& options)
+  {
+      std::vector<GPS::Trackpoint> trackPoints;
+      GPS::TrackDecimator decimator {appendTo(trackPoints), options};
+      source([&decimator](const GPS::Trackpoint& trackPoint) { decimator.add(trackPoint); });
+      decimator.finish();
+      return trackPoints;
+  }
 
-      requireSubElementExists(gpx,"trk");
-      XML::Element trk = gpx.getSubElement("trk");
+  std::vector<GPS::Trackpoint> parseTrackStream(std::istream& gpxStream, const GPS::DecimationOptions& options)
+  {
+      return parseDecimatedTrack([&gpxStream](const TrackpointSink& sink) { parseTrackStream(gpxStream, sink); }, options);
+  }
 
-      return extractTrackPointsFromTrk(trk);
+  std::vector<GPS::Trackpoint> parseTrackString(std::string_view gpxText, const GPS::DecimationOptions& options)
+  {
+      return parseDecimatedTrack([gpxText](const TrackpointSink& sink) { parseTrackString(gpxText, sink); }, options);
   }
 
-  std::vector<GPS::Trackpoint> parseTrackString(const std::string& gpxText)
+  std::vector<GPS::Trackpoint> parseTrackFile(const std::string& filePath, const GPS::DecimationOptions& options)
   {
-      std::stringstream gpxStream {gpxText};
-      return parseTrackStream(gpxStream);
+      return parseDecimatedTrack([&filePath](const TrackpointSink& sink) { parseTrackFile(filePath, sink); }, options);
   }
 }
@@ -0,0 +1,363 @@
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "gpx-number.h"
+#include "gpx-track-reader.h"
+
+namespace GPS::GPX
+{
+  TrackReader::TrackReader(Sink sink, GPS::SensorData* sensors)
+    : sink{std::move(sink)},
+      sensors{sensors}
+  {}
+
+  void TrackReader::consume(const XML::Event& event)
+  {
+      switch (event.type)
+      {
+        case XML::Event::Type::StartElement:
+          ++depth;
+          startElement(event);
+          break;
+
+        case XML::Event::Type::Text:
+          if (depth == pointDepth + 1)
+          {
+              if (capturedContent == Content::Ele) point.ele.read(event.text);
+              else if (capturedContent == Content::Time) point.time.assign(event.text);
+          }
+          else if (inExtensions && depth > pointDepth + 1)
+          {
+              readSensor(event);
+          }
+          break;
+
+        case XML::Event::Type::EndElement:
+          endElement();
+          --depth;
+          break;
+
+        case XML::Event::Type::EndOfDocument:
+          break;
+      }
+  }
+
+  const XML::PathFilter& TrackReader::filter()
+  {
+      static const XML::PathFilter trackFilter {"gpx/trk/trkseg/trkpt/ele", "gpx/trk/trkseg/trkpt/time",
+                                                "gpx/trk/trkpt/ele", "gpx/trk/trkpt/time"};
+      return trackFilter;
+  }
+
+  const XML::PathFilter& TrackReader::filterWithSensors()
+  {
+      static const XML::PathFilter sensorFilter {"gpx/trk/trkseg/trkpt/ele", "gpx/trk/trkseg/trkpt/time",
+                                                 "gpx/trk/trkseg/trkpt/extensions/*/*",
+                                                 "gpx/trk/trkpt/ele", "gpx/trk/trkpt/time",
+                                                 "gpx/trk/trkpt/extensions/*/*"};
+      return sensorFilter;
+  }
+
+  void TrackReader::finish()
+  {
+      if (! trkFound) recordError("trk");
+      if (firstError) std::rethrow_exception(firstError);
+  }
+
+  TrackReader TrackReader::forSegmentContents(Sink sink)
+  {
+      TrackReader reader {std::move(sink)};
+      reader.depth = 3;
+      reader.trkFound = reader.inTrk = true;
+      reader.segmentsFound = reader.inSegment = true;
+      return reader;
+  }
+
+  const XML::PathFilter& TrackReader::segmentContentsFilter()
+  {
+      static const XML::PathFilter contentsFilter {"trkpt/ele", "trkpt/time"};
+      return contentsFilter;
+  }
+
+  bool TrackReader::hasFailed() const
+  {
+      return static_cast<bool>(firstError);
+  }
+
+  bool TrackReader::isWithinSegment() const
+  {
+      return inSegment && depth == 3;
+  }
+
+  void TrackReader::consumePoints(std::span<const GPS::Trackpoint> trackPoints)
+  {
+      if (firstError) return;
+
+      if (isWithinSegment())
+      {
+          segmentPointCount += trackPoints.size();
+          for (const GPS::Trackpoint& trackPoint : trackPoints)
+          {
+              sink(trackPoint);
+          }
+      }
+      else if (inTrk && depth == 2 && ! segmentsFound)
+      {
+          directPointCount += trackPoints.size();
+          if (! directPointError) directPoints.insert(directPoints.end(), trackPoints.begin(), trackPoints.end());
+      }
+  }
+
+  void TrackReader::startElement(const XML::Event& event)
+  {
+      if (depth == 1)
+      {
+          if (event.name != "gpx") recordError("gpx");
+      }
+      else if (firstError)
+      {
+          return;
+      }
+      else if (depth == 2)
+      {
+          if (event.name == "trk" && ! trkFound)
+          {
+              trkFound = true;
+              inTrk = true;
+          }
+      }
+      else if (! inTrk)
+      {
+          return;
+      }
+      else if (depth == 3)
+      {
+          if (event.name == "trkseg")
+          {
+              if (! segmentsFound)
+              {
+                  segmentsFound = true;
+                  directPoints.clear();
+                  directReadings.clear();
+                  directPointError = nullptr;
+              }
+              inSegment = true;
+              segmentPointCount = 0;
+          }
+          else if (event.name == "trkpt" && ! segmentsFound)
+          {
+              startPoint(event, false);
+          }
+      }
+      else if (depth == 4 && inSegment && event.name == "trkpt")
+      {
+          startPoint(event, true);
+      }
+      else if (pointDepth != 0 && depth == pointDepth + 1)
+      {
+          // As with the element tree, only the first 'ele' and 'time' elements are used.
+          if (event.name == "ele" && ! point.ele.present)
+          {
+              point.ele.read({}); // A self-closing 'ele' has no Text event.
+              capturedContent = Content::Ele;
+          }
+          else if (event.name == "time" && ! point.hasTime)
+          {
+              point.hasTime = true;
+              capturedContent = Content::Time;
+          }
+          else if (event.name == "extensions" && sensors)
+          {
+              inExtensions = true;
+          }
+      }
+  }
+
+  void TrackReader::endElement()
+  {
+      if (pointDepth != 0 && depth == pointDepth + 1)
+      {
+          capturedContent = Content::None;
+          inExtensions = false;
+      }
+      else if (pointDepth != 0 && depth == pointDepth)
+      {
+          endPoint();
+      }
+      else if (inSegment && depth == 3)
+      {
+          inSegment = false;
+          if (segmentPointCount == 0) recordError("trkpt");
+      }
+      else if (inTrk && depth == 2)
+      {
+          inTrk = false;
+          endTrack();
+      }
+  }
+
+  void TrackReader::startPoint(const XML::Event& trkpt, bool inSegment)
+  {
+      pointDepth = depth;
+      pointInSegment = inSegment;
+      point.lat.present = point.lon.present = point.ele.present = point.hasTime = false;
+      point.time.clear();
+      point.readings = {};
+
+      // As with the element tree, the last of any duplicated attributes wins.
+      for (const XML::AttributeView& attribute : trkpt.attributes)
+      {
+          if (attribute.name == "lat")
+          {
+              point.lat.read(attribute.value);
+          }
+          else if (attribute.name == "lon")
+          {
+              point.lon.read(attribute.value);
+          }
+      }
+  }
+
+  void TrackReader::endPoint()
+  {
+      pointDepth = 0;
+      capturedContent = Content::None;
+      inExtensions = false;
+
+      std::exception_ptr& pointError = pointInSegment ? firstError : directPointError;
+      if (pointInSegment) ++segmentPointCount; else ++directPointCount;
+      if (pointError) return;
+
+      std::optional<GPS::Trackpoint> trackPoint;
+      try
+      {
+          trackPoint.emplace(point.toTrackpoint(dateTimeDecoder));
+      }
+      catch (...)
+      {
+          recordError(pointError, std::current_exception());
+          return;
+      }
+
+      if (pointInSegment)
+      {
+          emit(*trackPoint, point.readings);
+      }
+      else
+      {
+          directPoints.push_back(*trackPoint);
+          if (sensors) directReadings.push_back(point.readings);
+      }
+  }
+
+  void TrackReader::endTrack()
+  {
+      if (segmentsFound) return;
+
+      if (directPointCount == 0)
+      {
+          recordError("trkpt");
+      }
+      else if (directPointError)
+      {
+          recordError(firstError, directPointError);
+      }
+      else
+      {
+          for (std::size_t i = 0; i < directPoints.size(); ++i)
+          {
+              emit(directPoints[i], sensors ? directReadings[i] : GPS::SensorReadings{});
+          }
+      }
+      directPoints.clear();
+      directReadings.clear();
+  }
+
+  namespace
+  {
+    bool sensorChannelNamed(std::string_view name, GPS::SensorChannel& channel)
+    {
+        const std::size_t prefixEnd = name.find(':');
+        if (prefixEnd != std::string_view::npos) name.remove_prefix(prefixEnd + 1);
+
+        if (name == "hr" || name == "heartrate") channel = GPS::SensorChannel::HeartRate;
+        else if (name == "cad" || name == "cadence") channel = GPS::SensorChannel::Cadence;
+        else if (name == "power" || name == "watts" || name == "PowerInWatts") channel = GPS::SensorChannel::Power;
+        else if (name == "atemp" || name == "temp") channel = GPS::SensorChannel::Temperature;
+        else return false;
+        return true;
+    }
+  }
+
+  void TrackReader::readSensor(const XML::Event& text)
+  {
+      GPS::SensorChannel channel;
+      double reading;
+      if (sensorChannelNamed(text.name, channel) && std::isnan(point.readings[channel]) && tryParseNumber(text.text, reading))
+      {
+          point.readings[channel] = reading;
+      }
+  }
+
+  void TrackReader::emit(const GPS::Trackpoint& trackPoint, const GPS::SensorReadings& readings)
+  {
+      sink(trackPoint);
+      if (sensors) sensors->append(readings);
+  }
+
+  void TrackReader::recordError(std::exception_ptr& error, std::exception_ptr newError)
+  {
+      if (! error) error = std::move(newError);
+  }
+
+  void TrackReader::recordError(std::string_view missing)
+  {
+      if (firstError) return;
+      recordError(firstError, std::make_exception_ptr(std::domain_error("Missing '" + std::string{missing} + "' element.")));
+  }
+
+  void TrackReader::NumberContent::read(std::string_view text)
+  {
+      present = true;
+      wellFormed = tryParseNumber(text, value);
+      if (! wellFormed) malformedText.assign(text);
+  }
+
+  double TrackReader::NumberContent::get() const
+  {
+      return wellFormed ? value : parseNumber(malformedText);
+  }
+
+  // The attributes are checked first, then the Waypoint is built, then the time is read.
+  GPS::Trackpoint TrackReader::PointContent::toTrackpoint(DateTimeDecoder& dateTimeDecoder) const
+  {
+      if (! lat.present) throw std::domain_error("Missing 'lat' attribute.");
+      if (! lon.present) throw std::domain_error("Missing 'lon' attribute.");
+      degrees latitude = lat.get();
+      degrees longitude = lon.get();
+      metres altitude = ele.present ? ele.get() : 0;
+      GPS::Waypoint waypoint {latitude, longitude, altitude};
+
+      if (! hasTime) throw std::domain_error("Missing 'time' element.");
+      return {waypoint, dateTimeDecoder.decodeMicroseconds(time)};
+  }
+
+  IncrementalTrackParser::IncrementalTrackParser(TrackReader::Sink sink, GPS::SensorData* sensors)
+    : reader{std::move(sink), sensors},
+      xmlParser{[this](const XML::Event& event) { reader.consume(event); },
+                sensors ? TrackReader::filterWithSensors() : TrackReader::filter()}
+  {}
+
+  void IncrementalTrackParser::feed(const char* data, std::size_t size)
+  {
+      xmlParser.feed(data, size);
+  }
+
+  void IncrementalTrackParser::finish()
+  {
+      xmlParser.finish();
+      reader.finish();
+  }
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "gzip.h"
+
+#include "gpx-date-time.h"
+
+#include "gpx-writer.h"
+
+namespace GPS::GPX
+{
+  // The buffer is passed on once it holds this much text.
+  const std::size_t writerChunkSize = 64 * 1024;
+
+  // Room for one point: the markup, three doubles of at most 24 characters each, and a time stamp.
+  const std::size_t maxPointLength = 256;
+
+  // Escape the characters that cannot appear literally in XML text or attribute values.
+  void appendEscaped(std::string& output, std::string_view text)
+  {
+      for (char c : text)
+      {
+          switch (c)
+          {
+            case '&': output += "&amp;"; break;
+            case '<': output += "&lt;"; break;
+            case '>': output += "&gt;"; break;
+            case '"': output += "&quot;"; break;
+            default: output += c;
+          }
+      }
+  }
+
+  char* appendString(char* output, std::string_view text)
+  {
+      return std::copy(text.begin(), text.end(), output);
+  }
+
+  char* appendNumber(char* output, double value)
+  {
+      // The shortest form that reads back as the same value; maxPointLength leaves room for it.
+      return std::to_chars(output, output + 32, value).ptr;
+  }
+
+  TrackWriter::TrackWriter(std::ostream& stream, WriterOptions options)
+    : output{[&stream](std::string_view text) { stream.write(text.data(), text.size()); }},
+      options{std::move(options)}
+  {
+      buffer.reserve(writerChunkSize + maxPointLength);
+  }
+
+  TrackWriter::TrackWriter(std::string& text, WriterOptions options)
+    : output{[&text](std::string_view chunk) { text += chunk; }},
+      options{std::move(options)}
+  {
+      buffer.reserve(writerChunkSize + maxPointLength);
+  }
+
+  void TrackWriter::writeHeader()
+  {
+      buffer += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<gpx version=\"1.1\" creator=\"";
+      appendEscaped(buffer, options.creator);
+      buffer += "\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+                "  <trk>\n";
+      if (! options.trackName.empty())
+      {
+          buffer += "    <name>";
+          appendEscaped(buffer, options.trackName);
+          buffer += "</name>\n";
+      }
+      buffer += "    <trkseg>\n";
+      headerWritten = true;
+  }
+
+  void TrackWriter::write(const GPS::Trackpoint& trackPoint)
+  {
+      if (finished) throw std::logic_error("GPX TrackWriter used after finish().");
+
+      // The time is formatted first, as it is the only part that can fail.
+      char time[maxFormattedTimeStampLength];
+      const char* timeEnd = formatTimeStamp(trackPoint.timeStamp, time);
+
+      if (! headerWritten) writeHeader();
+
+      char point[maxPointLength];
+      char* end = appendString(point, "      <trkpt lat=\"");
+      end = appendNumber(end, trackPoint.waypoint.latitude());
+      end = appendString(end, "\" lon=\"");
+      end = appendNumber(end, trackPoint.waypoint.longitude());
+      end = appendString(end, "\"><ele>");
+      end = appendNumber(end, trackPoint.waypoint.altitude());
+      end = appendString(end, "</ele><time>");
+      end = appendString(end, {time, static_cast<std::size_t>(timeEnd - time)});
+      end = appendString(end, "</time></trkpt>\n");
+      buffer.append(point, end);
+
+      segmentHasPoints = true;
+      flushIfFull();
+  }
+
+  void TrackWriter::startSegment()
+  {
+      if (finished) throw std::logic_error("GPX TrackWriter used after finish().");
+      if (! segmentHasPoints) return;
+
+      buffer += "    </trkseg>\n"
+                "    <trkseg>\n";
+      segmentHasPoints = false;
+      flushIfFull();
+  }
+
+  void TrackWriter::finish()
+  {
+      if (finished) throw std::logic_error("GPX TrackWriter used after finish().");
+      if (! headerWritten) writeHeader();
+
+      buffer += "    </trkseg>\n"
+                "  </trk>\n"
+                "</gpx>\n";
+      output(buffer);
+      buffer.clear();
+      finished = true;
+  }
+
+  void TrackWriter::flushIfFull()
+  {
+      if (buffer.size() >= writerChunkSize)
+      {
+          output(buffer);
+          buffer.clear();
+      }
+  }
+
+  void writeTrackWith(TrackWriter& writer, std::span<const GPS::Trackpoint> trackPoints, std::span<const std::size_t> segmentStarts)
+  {
+      auto nextSegmentStart = segmentStarts.begin();
+      for (std::size_t i = 0; i < trackPoints.size(); ++i)
+      {
+          while (nextSegmentStart != segmentStarts.end() && *nextSegmentStart <= i)
+          {
+              writer.startSegment();
+              ++nextSegmentStart;
+          }
+          writer.write(trackPoints[i]);
+      }
+      writer.finish();
+  }
+
+  void writeTrack(std::ostream& stream, std::span<const GPS::Trackpoint> trackPoints, const WriterOptions& options,
+                  std::span<const std::size_t> segmentStarts)
+  {
+      TrackWriter writer {stream, options};
+      writeTrackWith(writer, trackPoints, segmentStarts);
+  }
+
+  // A vector would otherwise convert to either a span or a Track.
+  void writeTrack(std::ostream& stream, const std::vector<GPS::Trackpoint>& trackPoints, const WriterOptions& options,
+                  std::span<const std::size_t> segmentStarts)
+  {
+      writeTrack(stream, std::span<const GPS::Trackpoint> {trackPoints}, options, segmentStarts);
+  }
+
+  void writeTrack(std::ostream& stream, const GPS::Track& track, const WriterOptions& options,
+                  std::span<const std::size_t> segmentStarts)
+  {
+      writeTrack(stream, track.points(), options, segmentStarts);
+  }
+
+  void writeTrackFile(const std::string& filePath, std::span<const GPS::Trackpoint> trackPoints, const WriterOptions& options,
+                      std::span<const std::size_t> segmentStarts)
+  {
+      std::ofstream file {filePath, std::ios::binary};
+      if (file)
+      {
+          if (filePath.ends_with(".gz"))
+          {
+              GPS::GzipOutputStream compressedFile {file};
+              writeTrack(compressedFile, trackPoints, options, segmentStarts);
+              compressedFile.close();
+          }
+          else
+          {
+              writeTrack(file, trackPoints, options, segmentStarts);
+          }
+      }
+      file.close();
+      if (! file)
+      {
+          throw std::system_error(errno, std::generic_category(), "Cannot write '" + filePath + "'");
+      }
+  }
+
+  std::string writeTrackString(std::span<const GPS::Trackpoint> trackPoints, const WriterOptions& options,
+                               std::span<const std::size_t> segmentStarts)
+  {
+      std::string gpx;
+      TrackWriter writer {gpx, options};
+      writeTrackWith(writer, trackPoints, segmentStarts);
+      return gpx;
+  }
+}
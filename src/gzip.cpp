@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <zlib.h>
+
+#include "gzip.h"
+
+namespace GPS
+{
+  // Bytes compressed in one deflate() call.
+  const std::size_t gzipInputChunkSize = 64 * 1024;
+
+  bool isGzipData(std::string_view data)
+  {
+      return data.size() >= 2 && data[0] == '\x1f' && data[1] == '\x8b';
+  }
+
+  [[noreturn]] void gzipError(const char* problem, const z_stream& stream)
+  {
+      throw std::domain_error(std::string {"Corrupt gzip data: "} + (stream.msg != nullptr ? stream.msg : problem) + ".");
+  }
+
+  struct GzipInflater::Stream
+  {
+      z_stream zlib {};
+  };
+
+  GzipInflater::GzipInflater(std::size_t chunkSize)
+    : stream{std::make_unique<Stream>()},
+      output(chunkSize, '\0')
+  {
+      // 32 added to the window bits detects a gzip or zlib header.
+      if (inflateInit2(&stream->zlib, 15 + 32) != Z_OK)
+      {
+          throw std::bad_alloc();
+      }
+  }
+
+  GzipInflater::~GzipInflater()
+  {
+      inflateEnd(&stream->zlib);
+  }
+
+  void GzipInflater::feed(std::string_view compressed, const ChunkHandler& handler)
+  {
+      z_stream& zlib = stream->zlib;
+      if (compressed.empty()) return;
+      zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+      zlib.avail_in = static_cast<uInt>(compressed.size());
+
+      // Continue while there is input, or while the output buffer was filled (so more may be pending).
+      do
+      {
+          if (atMemberEnd)
+          {
+              // Another gzip member follows the one that has ended.
+              inflateReset(&zlib);
+              atMemberEnd = false;
+          }
+
+          zlib.next_out = reinterpret_cast<Bytef*>(output.data());
+          zlib.avail_out = static_cast<uInt>(output.size());
+          const int result = inflate(&zlib, Z_NO_FLUSH);
+          if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+          {
+              gzipError("inflate failed", zlib);
+          }
+
+          const std::size_t produced = output.size() - zlib.avail_out;
+          if (produced > 0) handler({output.data(), produced});
+          atMemberEnd = result == Z_STREAM_END;
+          if (atMemberEnd && zlib.avail_in == 0) return;
+      }
+      while (zlib.avail_in > 0 || zlib.avail_out == 0);
+  }
+
+  void GzipInflater::finish()
+  {
+      if (! atMemberEnd)
+      {
+          throw std::domain_error("Corrupt gzip data: unexpected end of data.");
+      }
+  }
+
+  // Thrown on the background thread to abandon reading.
+  struct ReadingStopped {};
+
+  BackgroundGzipReader::BackgroundGzipReader(Source source, std::size_t chunkSize, unsigned int chunksAhead)
+    : source{std::move(source)},
+      chunkSize{chunkSize},
+      freeChunks(std::max(chunksAhead, 1u))
+  {
+      thread = std::thread([this]{ readAll(); });
+  }
+
+  BackgroundGzipReader::~BackgroundGzipReader()
+  {
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          stopping = true;
+      }
+      chunksChanged.notify_all();
+      thread.join();
+  }
+
+  void BackgroundGzipReader::readAll()
+  {
+      try
+      {
+          GzipInflater inflater {chunkSize};
+          std::string compressed(gzipInputChunkSize, '\0');
+          for (std::size_t size = source(compressed.data(), compressed.size()); size != 0; size = source(compressed.data(), compressed.size()))
+          {
+              inflater.feed({compressed.data(), size}, [this](std::string_view chunk) { deliver(chunk); });
+          }
+          inflater.finish();
+      }
+      catch (const ReadingStopped&)
+      {
+      }
+      catch (...)
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          error = std::current_exception();
+      }
+
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          ended = true;
+      }
+      chunksChanged.notify_all();
+  }
+
+  // Copy a chunk into a free buffer, waiting for one if the caller is too far behind.
+  void BackgroundGzipReader::deliver(std::string_view chunk)
+  {
+      std::string buffer;
+      {
+          std::unique_lock<std::mutex> lock {mutex};
+          chunksChanged.wait(lock, [this]{ return stopping || ! freeChunks.empty(); });
+          if (stopping) throw ReadingStopped {};
+          buffer = std::move(freeChunks.back());
+          freeChunks.pop_back();
+      }
+
+      buffer.assign(chunk);
+
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          readyChunks.push_back(std::move(buffer));
+      }
+      chunksChanged.notify_all();
+  }
+
+  std::string_view BackgroundGzipReader::nextChunk()
+  {
+      std::unique_lock<std::mutex> lock {mutex};
+      freeChunks.push_back(std::move(currentChunk));
+      chunksChanged.notify_all();
+
+      chunksChanged.wait(lock, [this]{ return ended || ! readyChunks.empty(); });
+      if (readyChunks.empty())
+      {
+          if (error) std::rethrow_exception(std::exchange(error, nullptr));
+          currentChunk.clear();
+          return {};
+      }
+      currentChunk = std::move(readyChunks.front());
+      readyChunks.pop_front();
+      return currentChunk;
+  }
+
+  struct GzipOutputStream::Buffer::Stream
+  {
+      z_stream zlib {};
+  };
+
+  GzipOutputStream::Buffer::Buffer(std::ostream& destination, int level)
+    : stream{std::make_unique<Stream>()},
+      destination{destination},
+      input(gzipInputChunkSize, '\0'),
+      output(gzipInputChunkSize, '\0')
+  {
+      // 16 added to the window bits writes a gzip header and trailer.
+      if (deflateInit2(&stream->zlib, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      {
+          throw std::invalid_argument("Invalid gzip compression level " + std::to_string(level) + ".");
+      }
+      setp(input.data(), input.data() + input.size());
+  }
+
+  GzipOutputStream::Buffer::~Buffer()
+  {
+      deflateEnd(&stream->zlib);
+  }
+
+  // Compress the buffered input, passing the output on to the destination.
+  bool GzipOutputStream::Buffer::compress(bool finish)
+  {
+      z_stream& zlib = stream->zlib;
+      zlib.next_in = reinterpret_cast<Bytef*>(pbase());
+      zlib.avail_in = static_cast<uInt>(pptr() - pbase());
+
+      int result;
+      do
+      {
+          zlib.next_out = reinterpret_cast<Bytef*>(output.data());
+          zlib.avail_out = static_cast<uInt>(output.size());
+          result = deflate(&zlib, finish ? Z_FINISH : Z_NO_FLUSH);
+          destination.write(output.data(), output.size() - zlib.avail_out);
+      }
+      while (zlib.avail_out == 0 || (finish && result != Z_STREAM_END));
+
+      setp(input.data(), input.data() + input.size());
+      return static_cast<bool>(destination);
+  }
+
+  GzipOutputStream::Buffer::int_type GzipOutputStream::Buffer::overflow(int_type c)
+  {
+      if (closed || ! compress(false)) return traits_type::eof();
+      if (! traits_type::eq_int_type(c, traits_type::eof()))
+      {
+          *pptr() = traits_type::to_char_type(c);
+          pbump(1);
+      }
+      return traits_type::not_eof(c);
+  }
+
+  // Compressed data is only passed on in whole chunks; flushing mid-stream would harm compression.
+  int GzipOutputStream::Buffer::sync()
+  {
+      return 0;
+  }
+
+  bool GzipOutputStream::Buffer::close()
+  {
+      if (closed) return true;
+      closed = true;
+      return compress(true);
+  }
+
+  GzipOutputStream::GzipOutputStream(std::ostream& destination, int level)
+    : std::ostream{nullptr},
+      buffer{destination, level}
+  {
+      rdbuf(&buffer);
+  }
+
+  GzipOutputStream::~GzipOutputStream()
+  {
+      buffer.close();
+  }
+
+  void GzipOutputStream::close()
+  {
+      if (! buffer.close()) setstate(std::ios::failbit);
+  }
+}
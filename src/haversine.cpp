@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define GPS_HAVERSINE_X86_64
+#endif
+
+#include "earth.h"
+#include "geometry.h"
+#include "haversine.h"
+
+namespace GPS::Haversine
+{
+  void scalarDistancesBetween(const degrees* latitudes1, const degrees* longitudes1,
+                              const degrees* latitudes2, const degrees* longitudes2,
+                              metres* distances, std::size_t count)
+  {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+          const radians lat1 = degToRad(latitudes1[i]);
+          const radians lat2 = degToRad(latitudes2[i]);
+          distances[i] = Earth::haversineDistance(lat1, degToRad(longitudes1[i]), std::cos(lat1),
+                                                  lat2, degToRad(longitudes2[i]), std::cos(lat2));
+      }
+  }
+
+  void scalarDistancesFrom(degrees latitude, degrees longitude,
+                           const degrees* latitudes, const degrees* longitudes,
+                           metres* distances, std::size_t count)
+  {
+      const radians originLatitude = degToRad(latitude);
+      const radians originLongitude = degToRad(longitude);
+      const double originCosine = std::cos(originLatitude);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+          const radians lat = degToRad(latitudes[i]);
+          distances[i] = Earth::haversineDistance(originLatitude, originLongitude, originCosine,
+                                                  lat, degToRad(longitudes[i]), std::cos(lat));
+      }
+  }
+
+#ifdef GPS_HAVERSINE_X86_64
+  /* sin(x) = x + x^3 S(x^2) on [-pi/2, pi/2]: the Taylor series to x^21, whose remainder there is
+   * below 2e-18.
+   */
+  constexpr std::array<double, 10> sineCoefficients = {
+      -0.16666666666666666, 0.008333333333333333, -0.0001984126984126984, 2.7557319223985893e-06,
+      -2.505210838544172e-08, 1.6059043836821613e-10, -7.647163731819816e-13, 2.8114572543455206e-15,
+      -8.22063524662433e-18, 1.9572941063391263e-20};
+
+  /* asin(x) = x + x^3 A(x^2) on [0, 1/2]: A interpolates the series at the Chebyshev nodes of [0, 1/4],
+   * with an error there below 1e-16 of asin(x).  Beyond 1/2, asin(x) = pi/2 - 2 asin(sqrt((1-x)/2)).
+   */
+  constexpr std::array<double, 12> arcsineCoefficients = {
+      0.1666666666666665, 0.07500000000020764, 0.044642857103423646, 0.03038194736709848,
+      0.02237204763174451, 0.017355259955786323, 0.013929652902326633, 0.011875494382636922,
+      0.007802949477353317, 0.016035514349148825, -0.01074905033969781, 0.028169218060881414};
+
+  constexpr double halfPi = 1.5707963267948966;
+
+  /* What halfPi falls short of pi/2 by.  Adding it back after subtracting from halfPi, in the range
+   * reductions below, keeps the relative accuracy when the difference is small (and so exact): near the
+   * poles, and for longitudes either side of the antimeridian.
+   */
+  constexpr double halfPiShortfall = 6.123233995736766e-17;
+
+  template <std::size_t size>
+  __attribute__((target("avx2,fma")))
+  __m256d avx2Polynomial(__m256d x, const std::array<double, size>& coefficients)
+  {
+      __m256d result = _mm256_set1_pd(coefficients[size - 1]);
+      for (std::size_t i = size - 1; i-- > 0;)
+      {
+          result = _mm256_fmadd_pd(result, x, _mm256_set1_pd(coefficients[i]));
+      }
+      return result;
+  }
+
+  // For x in [-pi/2, pi/2].
+  __attribute__((target("avx2,fma")))
+  __m256d avx2Sin(__m256d x)
+  {
+      const __m256d x2 = _mm256_mul_pd(x, x);
+      return _mm256_fmadd_pd(_mm256_mul_pd(x, x2), avx2Polynomial(x2, sineCoefficients), x);
+  }
+
+  // For x in [-pi, pi], using sin^2(x) = sin^2(pi - |x|).
+  __attribute__((target("avx2,fma")))
+  __m256d avx2SinSqr(__m256d x)
+  {
+      const __m256d magnitude = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+      const __m256d complement = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(2 * halfPi), magnitude), _mm256_set1_pd(2 * halfPiShortfall));
+      const __m256d sine = avx2Sin(_mm256_min_pd(magnitude, complement));
+      return _mm256_mul_pd(sine, sine);
+  }
+
+  // For latitudes, using cos(x) = sin(pi/2 - |x|).
+  __attribute__((target("avx2,fma")))
+  __m256d avx2Cos(__m256d x)
+  {
+      const __m256d complement = _mm256_sub_pd(_mm256_set1_pd(halfPi), _mm256_andnot_pd(_mm256_set1_pd(-0.0), x));
+      return avx2Sin(_mm256_add_pd(complement, _mm256_set1_pd(halfPiShortfall)));
+  }
+
+  // For x in [0, 1].
+  __attribute__((target("avx2,fma")))
+  __m256d avx2Asin(__m256d x)
+  {
+      const __m256d beyondHalf = _mm256_cmp_pd(x, _mm256_set1_pd(0.5), _CMP_GT_OQ);
+      const __m256d reduced = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(1), x), _mm256_set1_pd(0.5)));
+      const __m256d t = _mm256_blendv_pd(x, reduced, beyondHalf);
+      const __m256d t2 = _mm256_mul_pd(t, t);
+      const __m256d arcsine = _mm256_fmadd_pd(_mm256_mul_pd(t, t2), avx2Polynomial(t2, arcsineCoefficients), t);
+      const __m256d complement = _mm256_fnmadd_pd(_mm256_set1_pd(2), arcsine, _mm256_set1_pd(halfPi));
+      return _mm256_blendv_pd(arcsine, complement, beyondHalf);
+  }
+
+  // As degToRad().
+  __attribute__((target("avx2,fma")))
+  __m256d avx2Radians(__m256d x)
+  {
+      return _mm256_div_pd(_mm256_mul_pd(x, _mm256_set1_pd(pi)), _mm256_set1_pd(halfRotation));
+  }
+
+  // As Earth::haversineDistance().
+  __attribute__((target("avx2,fma")))
+  __m256d avx2Distance(__m256d lat1, __m256d lon1, __m256d cosLat1, __m256d lat2, __m256d lon2, __m256d cosLat2)
+  {
+      const __m256d half = _mm256_set1_pd(0.5);
+      const __m256d h = _mm256_fmadd_pd(_mm256_mul_pd(cosLat1, cosLat2),
+                                        avx2SinSqr(_mm256_mul_pd(_mm256_sub_pd(lon2, lon1), half)),
+                                        avx2SinSqr(_mm256_mul_pd(_mm256_sub_pd(lat2, lat1), half)));
+      const __m256d bounded = _mm256_min_pd(h, _mm256_set1_pd(1));
+      return _mm256_mul_pd(_mm256_set1_pd(2 * Earth::meanRadius), avx2Asin(_mm256_sqrt_pd(bounded)));
+  }
+
+  __attribute__((target("avx2,fma")))
+  void avx2DistancesBetween4(const degrees* latitudes1, const degrees* longitudes1,
+                             const degrees* latitudes2, const degrees* longitudes2, metres* distances)
+  {
+      const __m256d lat1 = avx2Radians(_mm256_loadu_pd(latitudes1));
+      const __m256d lat2 = avx2Radians(_mm256_loadu_pd(latitudes2));
+      const __m256d lon1 = avx2Radians(_mm256_loadu_pd(longitudes1));
+      const __m256d lon2 = avx2Radians(_mm256_loadu_pd(longitudes2));
+      _mm256_storeu_pd(distances, avx2Distance(lat1, lon1, avx2Cos(lat1), lat2, lon2, avx2Cos(lat2)));
+  }
+
+  __attribute__((target("avx2,fma")))
+  void avx2DistancesBetween(const degrees* latitudes1, const degrees* longitudes1,
+                            const degrees* latitudes2, const degrees* longitudes2,
+                            metres* distances, std::size_t count)
+  {
+      std::size_t i = 0;
+      for (; count - i >= 4; i += 4)
+      {
+          avx2DistancesBetween4(latitudes1 + i, longitudes1 + i, latitudes2 + i, longitudes2 + i, distances + i);
+      }
+      if (i == count) return;
+
+      // The remainder, padded out to a whole vector.
+      std::array<degrees, 4> lat1 {}, lon1 {}, lat2 {}, lon2 {};
+      std::array<metres, 4> remainder;
+      std::copy(latitudes1 + i, latitudes1 + count, lat1.begin());
+      std::copy(longitudes1 + i, longitudes1 + count, lon1.begin());
+      std::copy(latitudes2 + i, latitudes2 + count, lat2.begin());
+      std::copy(longitudes2 + i, longitudes2 + count, lon2.begin());
+      avx2DistancesBetween4(lat1.data(), lon1.data(), lat2.data(), lon2.data(), remainder.data());
+      std::copy(remainder.begin(), remainder.begin() + (count - i), distances + i);
+  }
+
+  __attribute__((target("avx2,fma")))
+  void avx2DistancesFrom4(__m256d lat1, __m256d lon1, __m256d cosLat1,
+                          const degrees* latitudes, const degrees* longitudes, metres* distances)
+  {
+      const __m256d lat2 = avx2Radians(_mm256_loadu_pd(latitudes));
+      const __m256d lon2 = avx2Radians(_mm256_loadu_pd(longitudes));
+      _mm256_storeu_pd(distances, avx2Distance(lat1, lon1, cosLat1, lat2, lon2, avx2Cos(lat2)));
+  }
+
+  __attribute__((target("avx2,fma")))
+  void avx2DistancesFrom(degrees latitude, degrees longitude,
+                         const degrees* latitudes, const degrees* longitudes,
+                         metres* distances, std::size_t count)
+  {
+      const radians originLatitude = degToRad(latitude);
+      const __m256d lat1 = _mm256_set1_pd(originLatitude);
+      const __m256d lon1 = _mm256_set1_pd(degToRad(longitude));
+      const __m256d cosLat1 = _mm256_set1_pd(std::cos(originLatitude));
+
+      std::size_t i = 0;
+      for (; count - i >= 4; i += 4)
+      {
+          avx2DistancesFrom4(lat1, lon1, cosLat1, latitudes + i, longitudes + i, distances + i);
+      }
+      if (i == count) return;
+
+      std::array<degrees, 4> lat2 {}, lon2 {};
+      std::array<metres, 4> remainder;
+      std::copy(latitudes + i, latitudes + count, lat2.begin());
+      std::copy(longitudes + i, longitudes + count, lon2.begin());
+      avx2DistancesFrom4(lat1, lon1, cosLat1, lat2.data(), lon2.data(), remainder.data());
+      std::copy(remainder.begin(), remainder.begin() + (count - i), distances + i);
+  }
+
+  // The zero-masking forms, as the plain forms of these trip a false -Wuninitialized in GCC 12's headers.
+  __attribute__((target("avx512f")))
+  __m512d avx512Sqrt(__m512d x)
+  {
+      return _mm512_maskz_sqrt_pd(0xFF, x);
+  }
+
+  __attribute__((target("avx512f")))
+  __m512d avx512Min(__m512d x, __m512d y)
+  {
+      return _mm512_maskz_min_pd(0xFF, x, y);
+  }
+
+  template <std::size_t size>
+  __attribute__((target("avx512f")))
+  __m512d avx512Polynomial(__m512d x, const std::array<double, size>& coefficients)
+  {
+      __m512d result = _mm512_set1_pd(coefficients[size - 1]);
+      for (std::size_t i = size - 1; i-- > 0;)
+      {
+          result = _mm512_fmadd_pd(result, x, _mm512_set1_pd(coefficients[i]));
+      }
+      return result;
+  }
+
+  __attribute__((target("avx512f")))
+  __m512d avx512Sin(__m512d x)
+  {
+      const __m512d x2 = _mm512_mul_pd(x, x);
+      return _mm512_fmadd_pd(_mm512_mul_pd(x, x2), avx512Polynomial(x2, sineCoefficients), x);
+  }
+
+  __attribute__((target("avx512f")))
+  __m512d avx512SinSqr(__m512d x)
+  {
+      const __m512d magnitude = _mm512_abs_pd(x);
+      const __m512d complement = _mm512_add_pd(_mm512_sub_pd(_mm512_set1_pd(2 * halfPi), magnitude), _mm512_set1_pd(2 * halfPiShortfall));
+      const __m512d sine = avx512Sin(avx512Min(magnitude, complement));
+      return _mm512_mul_pd(sine, sine);
+  }
+
+  __attribute__((target("avx512f")))
+  __m512d avx512Cos(__m512d x)
+  {
+      const __m512d complement = _mm512_sub_pd(_mm512_set1_pd(halfPi), _mm512_abs_pd(x));
+      return avx512Sin(_mm512_add_pd(complement, _mm512_set1_pd(halfPiShortfall)));
+  }
+
+  __attribute__((target("avx512f")))
+  __m512d avx512Asin(__m512d x)
+  {
+      const __mmask8 beyondHalf = _mm512_cmp_pd_mask(x, _mm512_set1_pd(0.5), _CMP_GT_OQ);
+      const __m512d reduced = avx512Sqrt(_mm512_mul_pd(_mm512_sub_pd(_mm512_set1_pd(1), x), _mm512_set1_pd(0.5)));
+      const __m512d t = _mm512_mask_blend_pd(beyondHalf, x, reduced);
+      const __m512d t2 = _mm512_mul_pd(t, t);
+      const __m512d arcsine = _mm512_fmadd_pd(_mm512_mul_pd(t, t2), avx512Polynomial(t2, arcsineCoefficients), t);
+      const __m512d complement = _mm512_fnmadd_pd(_mm512_set1_pd(2), arcsine, _mm512_set1_pd(halfPi));
+      return _mm512_mask_blend_pd(beyondHalf, arcsine, complement);
+  }
+
+  __attribute__((target("avx512f")))
+  __m512d avx512Radians(__m512d x)
+  {
+      return _mm512_div_pd(_mm512_mul_pd(x, _mm512_set1_pd(pi)), _mm512_set1_pd(halfRotation));
+  }
+
+  __attribute__((target("avx512f")))
+  __m512d avx512Distance(__m512d lat1, __m512d lon1, __m512d cosLat1, __m512d lat2, __m512d lon2, __m512d cosLat2)
+  {
+      const __m512d half = _mm512_set1_pd(0.5);
+      const __m512d h = _mm512_fmadd_pd(_mm512_mul_pd(cosLat1, cosLat2),
+                                        avx512SinSqr(_mm512_mul_pd(_mm512_sub_pd(lon2, lon1), half)),
+                                        avx512SinSqr(_mm512_mul_pd(_mm512_sub_pd(lat2, lat1), half)));
+      const __m512d bounded = avx512Min(h, _mm512_set1_pd(1));
+      return _mm512_mul_pd(_mm512_set1_pd(2 * Earth::meanRadius), avx512Asin(avx512Sqrt(bounded)));
+  }
+
+  // The final partial vector is handled with masked loads and stores.
+  __attribute__((target("avx512f")))
+  void avx512DistancesBetween(const degrees* latitudes1, const degrees* longitudes1,
+                              const degrees* latitudes2, const degrees* longitudes2,
+                              metres* distances, std::size_t count)
+  {
+      for (std::size_t i = 0; i < count; i += 8)
+      {
+          const __mmask8 lanes = count - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (count - i)) - 1);
+          const __m512d lat1 = avx512Radians(_mm512_maskz_loadu_pd(lanes, latitudes1 + i));
+          const __m512d lat2 = avx512Radians(_mm512_maskz_loadu_pd(lanes, latitudes2 + i));
+          const __m512d lon1 = avx512Radians(_mm512_maskz_loadu_pd(lanes, longitudes1 + i));
+          const __m512d lon2 = avx512Radians(_mm512_maskz_loadu_pd(lanes, longitudes2 + i));
+          _mm512_mask_storeu_pd(distances + i, lanes, avx512Distance(lat1, lon1, avx512Cos(lat1), lat2, lon2, avx512Cos(lat2)));
+      }
+  }
+
+  __attribute__((target("avx512f")))
+  void avx512DistancesFrom(degrees latitude, degrees longitude,
+                           const degrees* latitudes, const degrees* longitudes,
+                           metres* distances, std::size_t count)
+  {
+      const radians originLatitude = degToRad(latitude);
+      const __m512d lat1 = _mm512_set1_pd(originLatitude);
+      const __m512d lon1 = _mm512_set1_pd(degToRad(longitude));
+      const __m512d cosLat1 = _mm512_set1_pd(std::cos(originLatitude));
+      for (std::size_t i = 0; i < count; i += 8)
+      {
+          const __mmask8 lanes = count - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (count - i)) - 1);
+          const __m512d lat2 = avx512Radians(_mm512_maskz_loadu_pd(lanes, latitudes + i));
+          const __m512d lon2 = avx512Radians(_mm512_maskz_loadu_pd(lanes, longitudes + i));
+          _mm512_mask_storeu_pd(distances + i, lanes, avx512Distance(lat1, lon1, cosLat1, lat2, lon2, avx512Cos(lat2)));
+      }
+  }
+#endif
+
+  const Kernel scalarKernel {"scalar", scalarDistancesBetween, scalarDistancesFrom};
+#ifdef GPS_HAVERSINE_X86_64
+  const Kernel avx2Kernel {"avx2", avx2DistancesBetween, avx2DistancesFrom};
+  const Kernel avx512Kernel {"avx512", avx512DistancesBetween, avx512DistancesFrom};
+#endif
+
+  void requireSameSizes(std::initializer_list<std::size_t> sizes)
+  {
+      if (std::adjacent_find(sizes.begin(), sizes.end(), std::not_equal_to<>()) != sizes.end())
+      {
+          throw std::invalid_argument("The coordinates and distances must be the same in number.");
+      }
+  }
+
+  std::vector<Kernel> availableKernels()
+  {
+      std::vector<Kernel> kernels {scalarKernel};
+#ifdef GPS_HAVERSINE_X86_64
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      {
+          kernels.push_back(avx2Kernel);
+      }
+      if (__builtin_cpu_supports("avx512f"))
+      {
+          kernels.push_back(avx512Kernel);
+      }
+#endif
+      return kernels;
+  }
+
+  const Kernel& selectedKernel()
+  {
+      static const Kernel widestKernel = availableKernels().back();
+      return widestKernel;
+  }
+
+  void distancesBetween(std::span<const degrees> latitudes1, std::span<const degrees> longitudes1,
+                        std::span<const degrees> latitudes2, std::span<const degrees> longitudes2,
+                        std::span<metres> distances)
+  {
+      requireSameSizes({latitudes1.size(), longitudes1.size(), latitudes2.size(), longitudes2.size(), distances.size()});
+      selectedKernel().distancesBetween(latitudes1.data(), longitudes1.data(), latitudes2.data(), longitudes2.data(),
+                                        distances.data(), distances.size());
+  }
+
+  void distancesFrom(const Waypoint& origin, std::span<const degrees> latitudes, std::span<const degrees> longitudes,
+                     std::span<metres> distances)
+  {
+      requireSameSizes({latitudes.size(), longitudes.size(), distances.size()});
+      selectedKernel().distancesFrom(origin.latitude(), origin.longitude(), latitudes.data(), longitudes.data(),
+                                     distances.data(), distances.size());
+  }
+}
@@ -0,0 +1,106 @@
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GPS_HAVE_MMAP
+#endif
+
+#include "mapped-file.h"
+
+namespace GPS
+{
+  MappedFile::MappedFile(const std::string& filePath)
+  {
+#ifdef GPS_HAVE_MMAP
+      const int fd = ::open(filePath.c_str(), O_RDONLY);
+      if (fd == -1)
+      {
+          throw std::system_error(errno, std::generic_category(), "Cannot open '" + filePath + "'");
+      }
+
+      struct stat fileStatus;
+      if (::fstat(fd, &fileStatus) == -1)
+      {
+          const int error = errno;
+          ::close(fd);
+          throw std::system_error(error, std::generic_category(), "Cannot stat '" + filePath + "'");
+      }
+
+      size = static_cast<std::size_t>(fileStatus.st_size);
+      if (size > 0) // mmap() rejects zero-length mappings.
+      {
+          void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (mapping == MAP_FAILED)
+          {
+              const int error = errno;
+              ::close(fd);
+              throw std::system_error(error, std::generic_category(), "Cannot map '" + filePath + "'");
+          }
+          ::madvise(mapping, size, MADV_SEQUENTIAL);
+          data = static_cast<const char*>(mapping);
+          isMapped = true;
+      }
+      ::close(fd); // The mapping keeps its own reference to the file.
+#else
+      std::ifstream file {filePath, std::ios::binary};
+      if (! file)
+      {
+          throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "Cannot open '" + filePath + "'");
+      }
+      std::ostringstream contents;
+      contents << file.rdbuf();
+      fallbackBuffer = std::move(contents).str();
+      data = fallbackBuffer.data();
+      size = fallbackBuffer.size();
+#endif
+  }
+
+  MappedFile::~MappedFile()
+  {
+      release();
+  }
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+  {
+      *this = std::move(other);
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+  {
+      if (this != &other)
+      {
+          release();
+          isMapped = std::exchange(other.isMapped, false);
+          size = std::exchange(other.size, 0);
+          fallbackBuffer = std::move(other.fallbackBuffer);
+          data = isMapped ? std::exchange(other.data, nullptr) : fallbackBuffer.data();
+          other.data = nullptr;
+      }
+      return *this;
+  }
+
+  std::string_view MappedFile::contents() const
+  {
+      return {data == nullptr ? "" : data, size};
+  }
+
+  void MappedFile::release()
+  {
+#ifdef GPS_HAVE_MMAP
+      if (isMapped)
+      {
+          ::munmap(const_cast<char*>(data), size);
+      }
+#endif
+      isMapped = false;
+      data = nullptr;
+      size = 0;
+  }
+}
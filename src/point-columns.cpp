@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define GPS_COLUMNS_X86_64
+#endif
+
+#include "point-columns.h"
+
+namespace GPS
+{
+  PointColumns::PointColumns(std::span<const Trackpoint> trackPoints)
+  {
+      latitudes.reserve(trackPoints.size());
+      longitudes.reserve(trackPoints.size());
+      altitudes.reserve(trackPoints.size());
+      timeStamps.reserve(trackPoints.size());
+      for (const Trackpoint& trackPoint : trackPoints)
+      {
+          latitudes.push_back(trackPoint.waypoint.latitude());
+          longitudes.push_back(trackPoint.waypoint.longitude());
+          altitudes.push_back(trackPoint.waypoint.altitude());
+          timeStamps.push_back(trackPoint.timeStamp);
+      }
+  }
+
+  std::size_t PointColumns::size() const
+  {
+      return timeStamps.size();
+  }
+
+  Waypoint PointColumns::waypoint(std::size_t index) const
+  {
+      return Waypoint(latitudes[index], longitudes[index], altitudes[index]);
+  }
+
+  std::size_t PointColumns::capacityInBytes() const
+  {
+      return latitudes.capacity() * sizeof(degrees) + longitudes.capacity() * sizeof(degrees)
+           + altitudes.capacity() * sizeof(metres) + timeStamps.capacity() * sizeof(microseconds);
+  }
+
+  /* Each search makes two passes: one to find the extreme value, which can compare a vector of
+   * values at a time as the order of comparison does not matter, and one to find where it first
+   * occurs.  Both passes are limited by memory bandwidth rather than by comparisons.
+   */
+  enum class Extreme { Greatest, Least };
+
+  template <Extreme extreme, bool magnitude>
+  double scalarExtremeValue(const double* values, std::size_t count, double found)
+  {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+          const double value = magnitude ? std::abs(values[i]) : values[i];
+          found = extreme == Extreme::Greatest ? std::max(found, value) : std::min(found, value);
+      }
+      return found;
+  }
+
+  template <bool magnitude>
+  std::size_t scalarFirstIndexOfValue(const double* values, std::size_t count, double target)
+  {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+          if ((magnitude ? std::abs(values[i]) : values[i]) == target) return i;
+      }
+      return count;
+  }
+
+  template <Extreme extreme, bool magnitude>
+  std::size_t scalarFirstIndexOf(std::span<const double> column)
+  {
+      const double found = scalarExtremeValue<extreme, magnitude>(column.data(), column.size(), magnitude ? std::abs(column[0]) : column[0]);
+      return scalarFirstIndexOfValue<magnitude>(column.data(), column.size(), found);
+  }
+
+#ifdef GPS_COLUMNS_X86_64
+  template <bool magnitude>
+  __attribute__((target("avx2")))
+  __m256d load4(const double* values)
+  {
+      const __m256d loaded = _mm256_loadu_pd(values);
+      return magnitude ? _mm256_andnot_pd(_mm256_set1_pd(-0.0), loaded) : loaded;
+  }
+
+  template <Extreme extreme, bool magnitude>
+  __attribute__((target("avx2")))
+  std::size_t avx2FirstIndexOf(std::span<const double> column)
+  {
+      const double* values = column.data();
+      const std::size_t count = column.size();
+      const std::size_t vectorCount = count - count % 4;
+
+      double found = magnitude ? std::abs(values[0]) : values[0];
+      if (vectorCount != 0)
+      {
+          __m256d extremes = load4<magnitude>(values);
+          for (std::size_t i = 4; i < vectorCount; i += 4)
+          {
+              const __m256d next = load4<magnitude>(values + i);
+              extremes = extreme == Extreme::Greatest ? _mm256_max_pd(extremes, next) : _mm256_min_pd(extremes, next);
+          }
+          alignas(32) double lanes[4];
+          _mm256_store_pd(lanes, extremes);
+          found = scalarExtremeValue<extreme, false>(lanes, 4, lanes[0]);
+      }
+      found = scalarExtremeValue<extreme, magnitude>(values + vectorCount, count - vectorCount, found);
+
+      const __m256d targets = _mm256_set1_pd(found);
+      for (std::size_t i = 0; i < vectorCount; i += 4)
+      {
+          const int matches = _mm256_movemask_pd(_mm256_cmp_pd(load4<magnitude>(values + i), targets, _CMP_EQ_OQ));
+          if (matches != 0) return i + __builtin_ctz(matches);
+      }
+      return vectorCount + scalarFirstIndexOfValue<magnitude>(values + vectorCount, count - vectorCount, found);
+  }
+#endif
+
+  template <Extreme extreme, bool magnitude>
+  std::size_t firstIndexOf(std::span<const double> column)
+  {
+#ifdef GPS_COLUMNS_X86_64
+      static const bool avx2 = __builtin_cpu_supports("avx2");
+      if (avx2) return avx2FirstIndexOf<extreme, magnitude>(column);
+#endif
+      return scalarFirstIndexOf<extreme, magnitude>(column);
+  }
+
+  std::size_t firstIndexOfGreatest(std::span<const double> column)
+  {
+      return firstIndexOf<Extreme::Greatest, false>(column);
+  }
+
+  std::size_t firstIndexOfLeast(std::span<const double> column)
+  {
+      return firstIndexOf<Extreme::Least, false>(column);
+  }
+
+  std::size_t firstIndexOfGreatestMagnitude(std::span<const double> column)
+  {
+      return firstIndexOf<Extreme::Greatest, true>(column);
+  }
+
+  std::size_t firstIndexOfLeastMagnitude(std::span<const double> column)
+  {
+      return firstIndexOf<Extreme::Least, true>(column);
+  }
+}
@@ -0,0 +1,37 @@
+#include <cmath>
+
+#include "sensor-data.h"
+
+namespace GPS
+{
+  std::size_t SensorData::size() const
+  {
+      return pointCount;
+  }
+
+  bool SensorData::hasChannel(SensorChannel channel) const
+  {
+      return ! columns[static_cast<std::size_t>(channel)].empty();
+  }
+
+  std::span<const double> SensorData::channel(SensorChannel channel) const
+  {
+      return columns[static_cast<std::size_t>(channel)];
+  }
+
+  void SensorData::append(const SensorReadings& readings)
+  {
+      for (std::size_t channel = 0; channel < sensorChannelCount; ++channel)
+      {
+          std::vector<double>& column = columns[channel];
+          const double reading = readings.values[channel];
+          if (column.empty())
+          {
+              if (std::isnan(reading)) continue; // Still no readings on this channel.
+              column.assign(pointCount, SensorReadings::noReading());
+          }
+          column.push_back(reading);
+      }
+      ++pointCount;
+  }
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <utility>
+
+#include "thread-pool.h"
+
+namespace GPS
+{
+  namespace
+  {
+    // The pool and queue of the worker running on this thread, if any.
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local unsigned int currentWorker = 0;
+  }
+
+  ThreadPool::ThreadPool(unsigned int threadCount)
+  {
+      // hardware_concurrency() returns 0 if it cannot tell.
+      threadCount = std::max(threadCount, 1u);
+      queues.reserve(threadCount);
+      for (unsigned int i = 0; i < threadCount; ++i)
+      {
+          queues.push_back(std::make_unique<WorkerQueue>());
+      }
+      threads.reserve(threadCount);
+      for (unsigned int i = 0; i < threadCount; ++i)
+      {
+          threads.emplace_back([this, i]{ runTasks(i); });
+      }
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          stopping = true;
+      }
+      taskAvailable.notify_all();
+      for (std::thread& thread : threads)
+      {
+          thread.join();
+      }
+  }
+
+  unsigned int ThreadPool::threadCount() const
+  {
+      return threads.size();
+  }
+
+  void ThreadPool::enqueue(std::function<void()> task)
+  {
+      const unsigned int queue = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+      {
+          std::lock_guard<std::mutex> lock {queues[queue]->mutex};
+          queues[queue]->tasks.push_back(std::move(task));
+      }
+      {
+          std::lock_guard<std::mutex> lock {mutex};
+          ++queuedTaskCount;
+      }
+      taskAvailable.notify_one();
+  }
+
+  // Take the oldest task from the worker's own queue, or else the newest task from another queue.
+  bool ThreadPool::takeTask(unsigned int worker, std::function<void()>& task)
+  {
+      for (unsigned int i = 0; i < queues.size(); ++i)
+      {
+          WorkerQueue& queue = *queues[(worker + i) % queues.size()];
+          std::lock_guard<std::mutex> lock {queue.mutex};
+          if (queue.tasks.empty()) continue;
+
+          if (i == 0)
+          {
+              task = std::move(queue.tasks.front());
+              queue.tasks.pop_front();
+          }
+          else
+          {
+              task = std::move(queue.tasks.back());
+              queue.tasks.pop_back();
+          }
+          return true;
+      }
+      return false;
+  }
+
+  void ThreadPool::runTasks(unsigned int worker)
+  {
+      currentPool = this;
+      currentWorker = worker;
+      for (;;)
+      {
+          {
+              std::unique_lock<std::mutex> lock {mutex};
+              taskAvailable.wait(lock, [this]{ return stopping || queuedTaskCount > 0; });
+              if (queuedTaskCount <= 0) return; // Only once stopping, so queued tasks are always run.
+          }
+
+          // Another worker may have taken the counted task first; if so, look again.
+          std::function<void()> task;
+          if (! takeTask(worker, task)) continue;
+          {
+              std::lock_guard<std::mutex> lock {mutex};
+              --queuedTaskCount;
+          }
+          task();
+      }
+  }
+}
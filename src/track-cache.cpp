@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "gpx-parser.h"
+#include "mapped-file.h"
+#include "track-file.h"
+
+#include "track-cache.h"
+
+namespace GPS
+{
+  namespace
+  {
+    const std::uint64_t xxPrime1 = 0x9E3779B185EBCA87;
+    const std::uint64_t xxPrime2 = 0xC2B2AE3D27D4EB4F;
+    const std::uint64_t xxPrime3 = 0x165667B19E3779F9;
+    const std::uint64_t xxPrime4 = 0x85EBCA77C2B2AE63;
+    const std::uint64_t xxPrime5 = 0x27D4EB2F165667C5;
+
+    std::uint64_t loadWord64(const char* bytes)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, sizeof word);
+        if constexpr (std::endian::native == std::endian::big) word = __builtin_bswap64(word);
+        return word;
+    }
+
+    std::uint32_t loadWord32(const char* bytes)
+    {
+        std::uint32_t word;
+        std::memcpy(&word, bytes, sizeof word);
+        if constexpr (std::endian::native == std::endian::big) word = __builtin_bswap32(word);
+        return word;
+    }
+
+    std::uint64_t xxRound(std::uint64_t accumulator, std::uint64_t input)
+    {
+        return std::rotl(accumulator + input * xxPrime2, 31) * xxPrime1;
+    }
+
+    std::uint64_t xxMerge(std::uint64_t hash, std::uint64_t accumulator)
+    {
+        return (hash ^ xxRound(0, accumulator)) * xxPrime1 + xxPrime4;
+    }
+  }
+
+  // See https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+  std::uint64_t contentHash(std::string_view bytes)
+  {
+      const char* position = bytes.data();
+      const char* const end = position + bytes.size();
+      std::uint64_t hash;
+
+      if (bytes.size() >= 32)
+      {
+          // Four independent lanes, so that the multiplications can overlap.
+          std::uint64_t lanes[4] = {xxPrime1 + xxPrime2, xxPrime2, 0, 0 - xxPrime1};
+          for (; end - position >= 32; position += 32)
+          {
+              for (int lane = 0; lane < 4; ++lane)
+              {
+                  lanes[lane] = xxRound(lanes[lane], loadWord64(position + 8 * lane));
+              }
+          }
+          hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+          for (std::uint64_t lane : lanes) hash = xxMerge(hash, lane);
+      }
+      else
+      {
+          hash = xxPrime5;
+      }
+      hash += bytes.size();
+
+      for (; end - position >= 8; position += 8)
+      {
+          hash = std::rotl(hash ^ xxRound(0, loadWord64(position)), 27) * xxPrime1 + xxPrime4;
+      }
+      if (end - position >= 4)
+      {
+          hash = std::rotl(hash ^ (loadWord32(position) * xxPrime1), 23) * xxPrime2 + xxPrime3;
+          position += 4;
+      }
+      for (; position != end; ++position)
+      {
+          hash = std::rotl(hash ^ (static_cast<unsigned char>(*position) * xxPrime5), 11) * xxPrime1;
+      }
+
+      hash ^= hash >> 33;
+      hash *= xxPrime2;
+      hash ^= hash >> 29;
+      hash *= xxPrime3;
+      hash ^= hash >> 32;
+      return hash;
+  }
+
+  const std::string_view trackExtension = ".track";
+  const std::string_view metricsExtension = ".metrics";
+  const std::string_view temporaryMarker = ".tmp-";
+
+  // Temporary files left behind by a process that stopped mid-write are removed once this old.
+  const std::chrono::hours abandonedFileAge {1};
+
+  TrackCache::TrackCache(std::string directory, std::uintmax_t maxBytes)
+    : directory{std::move(directory)},
+      maxBytes{maxBytes}
+  {
+      std::filesystem::create_directories(this->directory);
+      std::uintmax_t bytes = 0;
+      for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator {this->directory})
+      {
+          std::error_code error;
+          const std::uintmax_t size = file.file_size(error);
+          if (! error) bytes += size;
+      }
+      approximateBytes = bytes;
+  }
+
+  std::string TrackCache::keyFor(std::string_view gpxContents)
+  {
+      char hash[16];
+      const auto [end, error] = std::to_chars(hash, hash + sizeof hash, contentHash(gpxContents), 16);
+      return std::string(sizeof hash - (end - hash), '0') + std::string(hash, end) + "-" + std::to_string(gpxContents.size())
+             + "-p" + std::to_string(GPX::parserVersion) + "-f" + std::to_string(TrackFileFormat::version);
+  }
+
+  std::vector<Trackpoint> TrackCache::parseTrackFile(const std::string& gpxFilePath)
+  {
+      const MappedFile gpxFile {gpxFilePath};
+      const std::string key = keyFor(gpxFile.contents());
+      if (std::optional<std::vector<Trackpoint>> trackPoints = findTrack(key)) return std::move(*trackPoints);
+
+      std::vector<Trackpoint> trackPoints = GPX::parseTrackString(gpxFile.contents());
+      storeTrack(key, trackPoints);
+      return trackPoints;
+  }
+
+  std::optional<std::vector<Trackpoint>> TrackCache::findTrack(const std::string& key)
+  {
+      const std::string path = pathFor(key, trackExtension);
+      std::optional<std::vector<Trackpoint>> trackPoints;
+      try
+      {
+          trackPoints = readTrackFile(path);
+      }
+      catch (const std::exception&)
+      {
+          // Missing (e.g. never stored, or evicted by another process) or damaged.
+      }
+      recordLookup(trackPoints.has_value(), path);
+      return trackPoints;
+  }
+
+  namespace
+  {
+    /* One "name value" line per metric, then an "end" line, so that a damaged file is noticed.
+     * Values are written in their shortest form that reads back exactly.
+     */
+    std::optional<TrackCache::Metrics> readMetrics(const std::string& path)
+    {
+        std::ifstream file {path};
+        if (! file) return std::nullopt;
+
+        TrackCache::Metrics metrics;
+        for (std::string line; std::getline(file, line); )
+        {
+            if (line == "end") return metrics;
+
+            const std::size_t separator = line.find(' ');
+            if (separator == std::string::npos) break;
+            double value;
+            const auto [end, error] = std::from_chars(line.data() + separator + 1, line.data() + line.size(), value);
+            if (error != std::errc {} || end != line.data() + line.size()) break;
+            metrics[line.substr(0, separator)] = value;
+        }
+        return std::nullopt;
+    }
+  }
+
+  std::optional<TrackCache::Metrics> TrackCache::findMetrics(const std::string& key)
+  {
+      const std::string path = pathFor(key, metricsExtension);
+      std::optional<Metrics> metrics = readMetrics(path);
+      recordLookup(metrics.has_value(), path);
+      return metrics;
+  }
+
+  void TrackCache::storeTrack(const std::string& key, std::span<const Trackpoint> trackPoints)
+  {
+      const std::string path = pathFor(key, trackExtension);
+      writeAtomically(path, [trackPoints](const std::string& temporaryPath) { writeTrackFile(temporaryPath, trackPoints); });
+  }
+
+  void TrackCache::storeMetrics(const std::string& key, const Metrics& metrics)
+  {
+      for (const auto& [name, value] : metrics)
+      {
+          if (name.empty() || name == "end" || std::any_of(name.begin(), name.end(), [](unsigned char c) { return std::isspace(c); }))
+          {
+              throw std::invalid_argument("Metric names must be single words other than 'end': '" + name + "'.");
+          }
+      }
+
+      const std::string path = pathFor(key, metricsExtension);
+      writeAtomically(path, [&metrics](const std::string& temporaryPath) {
+          std::ofstream file {temporaryPath};
+          char text[32];
+          for (const auto& [name, value] : metrics)
+          {
+              file << name << ' ';
+              file.write(text, std::to_chars(text, text + sizeof text, value).ptr - text) << '\n';
+          }
+          file << "end\n";
+          file.close();
+          if (! file) throw std::system_error(errno, std::generic_category(), "Cannot write '" + temporaryPath + "'");
+      });
+  }
+
+  std::size_t TrackCache::hits() const
+  {
+      return hitCount;
+  }
+
+  std::size_t TrackCache::misses() const
+  {
+      return missCount;
+  }
+
+  std::size_t TrackCache::evictions() const
+  {
+      return evictionCount;
+  }
+
+  std::string TrackCache::pathFor(const std::string& key, std::string_view extension) const
+  {
+      return (std::filesystem::path {directory} / (key + std::string {extension})).string();
+  }
+
+  void TrackCache::writeAtomically(const std::string& path, const std::function<void(const std::string&)>& write)
+  {
+      // Unique between processes, which cannot share a counter.
+      static thread_local std::mt19937_64 random {std::random_device {}()};
+      std::ostringstream temporaryPath;
+      temporaryPath << path << temporaryMarker << std::hex << random();
+
+      std::error_code error;
+      try
+      {
+          write(temporaryPath.str());
+          std::filesystem::rename(temporaryPath.str(), path, error);
+      }
+      catch (const std::exception&)
+      {
+          error = std::make_error_code(std::errc::io_error);
+      }
+      if (error)
+      {
+          std::filesystem::remove(temporaryPath.str(), error);
+          return;
+      }
+
+      const std::uintmax_t size = std::filesystem::file_size(path, error);
+      if (! error) approximateBytes += size;
+      evictIfFull();
+  }
+
+  // A hit marks the entry as recently used, for every process sharing the directory.
+  void TrackCache::recordLookup(bool hit, const std::string& path)
+  {
+      if (hit)
+      {
+          ++hitCount;
+          std::error_code ignored;
+          std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ignored);
+      }
+      else
+      {
+          ++missCount;
+      }
+  }
+
+  void TrackCache::evictIfFull()
+  {
+      if (approximateBytes <= maxBytes) return;
+      const std::lock_guard<std::mutex> lock {evictionMutex};
+      if (approximateBytes <= maxBytes) return;
+
+      // The files of each entry are grouped by key, and the entry was last used when its newest file was.
+      struct Entry
+      {
+          std::filesystem::file_time_type lastUsed = std::filesystem::file_time_type::min();
+          std::uintmax_t bytes = 0;
+          std::vector<std::filesystem::path> files;
+      };
+      std::map<std::string, Entry> entries;
+      std::uintmax_t totalBytes = 0;
+      const auto now = std::filesystem::file_time_type::clock::now();
+
+      std::error_code error;
+      for (std::filesystem::directory_iterator file {directory, error}, end; ! error && file != end; file.increment(error))
+      {
+          std::error_code fileError;
+          const std::uintmax_t size = file->file_size(fileError);
+          const std::filesystem::file_time_type modified = file->last_write_time(fileError);
+          if (fileError) continue; // Removed since the directory was read.
+
+          const std::string name = file->path().filename().string();
+          if (name.find(temporaryMarker) != std::string::npos)
+          {
+              if (now - modified > abandonedFileAge) std::filesystem::remove(file->path(), fileError);
+              continue;
+          }
+
+          Entry& entry = entries[name.substr(0, name.rfind('.'))];
+          entry.lastUsed = std::max(entry.lastUsed, modified);
+          entry.bytes += size;
+          entry.files.push_back(file->path());
+          totalBytes += size;
+      }
+
+      std::vector<const Entry*> leastRecentFirst;
+      for (const auto& [key, entry] : entries) leastRecentFirst.push_back(&entry);
+      std::sort(leastRecentFirst.begin(), leastRecentFirst.end(), [](const Entry* a, const Entry* b) { return a->lastUsed < b->lastUsed; });
+
+      const std::uintmax_t target = maxBytes / 4 * 3;
+      for (const Entry* entry : leastRecentFirst)
+      {
+          if (totalBytes <= target) break;
+          for (const std::filesystem::path& file : entry->files) std::filesystem::remove(file, error);
+          totalBytes -= entry->bytes;
+          ++evictionCount;
+      }
+      approximateBytes = totalBytes;
+  }
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include "track-codec.h"
+
+namespace GPS
+{
+  /* The encoding is:
+   *   - the magic bytes "GPSZ" and a format version byte,
+   *   - the number of points, the coordinate and altitude decimal places, and the time unit (as a
+   *     power of ten microseconds, at most 10^6), as varints,
+   *   - four columns (latitude, longitude, altitude and time stamp), each a varint byte length
+   *     followed by the zigzag varint differences from the previous point's value (zero for the first).
+   */
+  const std::string_view codecMagic = "GPSZ";
+  const char codecVersion = 2;
+  const char wholeSecondsCodecVersion = 1; // No time unit: time stamps are in whole seconds.
+
+  // Points are decoded in blocks, a column at a time, so that the column buffers stay in cache.
+  const std::size_t decodeBlockSize = 1024;
+
+  const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12};
+  const microseconds timeUnits[] = {1, 10, 100, 1000, 10'000, 100'000, microsecondsPerSecond};
+
+  void appendVarint(std::string& output, std::uint64_t value)
+  {
+      while (value >= 0x80)
+      {
+          output.push_back(static_cast<char>(value | 0x80));
+          value >>= 7;
+      }
+      output.push_back(static_cast<char>(value));
+  }
+
+  std::uint64_t zigzag(std::uint64_t difference)
+  {
+      return (difference << 1) ^ (0 - (difference >> 63));
+  }
+
+  std::uint64_t unzigzag(std::uint64_t value)
+  {
+      return (value >> 1) ^ (0 - (value & 1));
+  }
+
+  /* Differences are taken modulo 2^64, so every int64 sequence round-trips, including time stamps
+   * far apart.
+   */
+  template <typename QuantiseField>
+  void appendColumn(std::string& output, std::span<const Trackpoint> trackPoints, QuantiseField quantise)
+  {
+      std::string column;
+      column.reserve(trackPoints.size() * 2);
+      std::uint64_t previous = 0;
+      for (const Trackpoint& trackPoint : trackPoints)
+      {
+          const std::uint64_t value = static_cast<std::uint64_t>(quantise(trackPoint));
+          appendVarint(column, zigzag(value - previous));
+          previous = value;
+      }
+      appendVarint(output, column.size());
+      output += column;
+  }
+
+  std::int64_t quantise(double value, double scale)
+  {
+      const double scaled = std::round(value * scale);
+      if (! (std::abs(scaled) < 0x1p62))
+      {
+          throw std::invalid_argument("Cannot encode " + std::to_string(value) + " at the requested precision.");
+      }
+      return static_cast<std::int64_t>(scaled);
+  }
+
+  std::string encodeTrack(std::span<const Trackpoint> trackPoints, const TrackCodecOptions& options)
+  {
+      if (options.coordinateDecimalPlaces > 12 || options.altitudeDecimalPlaces > 6)
+      {
+          throw std::invalid_argument("Track codec precision out of range.");
+      }
+      const double coordinateScale = powersOfTen[options.coordinateDecimalPlaces];
+      const double altitudeScale = powersOfTen[options.altitudeDecimalPlaces];
+
+      unsigned int timeUnitExponent = 6;
+      for (const Trackpoint& trackPoint : trackPoints)
+      {
+          while (timeUnitExponent > 0 && trackPoint.timeStamp % timeUnits[timeUnitExponent] != 0) --timeUnitExponent;
+      }
+      const microseconds timeUnit = timeUnits[timeUnitExponent];
+
+      std::string encoding {codecMagic};
+      encoding.push_back(codecVersion);
+      appendVarint(encoding, trackPoints.size());
+      appendVarint(encoding, options.coordinateDecimalPlaces);
+      appendVarint(encoding, options.altitudeDecimalPlaces);
+      appendVarint(encoding, timeUnitExponent);
+
+      appendColumn(encoding, trackPoints, [=](const Trackpoint& p) { return quantise(p.waypoint.latitude(), coordinateScale); });
+      appendColumn(encoding, trackPoints, [=](const Trackpoint& p) { return quantise(p.waypoint.longitude(), coordinateScale); });
+      appendColumn(encoding, trackPoints, [=](const Trackpoint& p) { return quantise(p.waypoint.altitude(), altitudeScale); });
+      appendColumn(encoding, trackPoints, [=](const Trackpoint& p) { return p.timeStamp / timeUnit; });
+      return encoding;
+  }
+
+  [[noreturn]] void malformedTrackEncoding(const std::string& problem)
+  {
+      throw std::domain_error("Malformed track encoding: " + problem + ".");
+  }
+
+  /* Read a varint, advancing the position.  Where at least ten bytes remain (the longest varint),
+   * the loop needs no bounds checks.
+   */
+  std::uint64_t readVarint(const unsigned char*& position, const unsigned char* end)
+  {
+      std::uint64_t value = 0;
+      if (end - position >= 10)
+      {
+          for (unsigned int shift = 0; shift < 70; shift += 7)
+          {
+              const unsigned char byte = *position++;
+              value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+              if (byte < 0x80) return value;
+          }
+      }
+      else
+      {
+          for (unsigned int shift = 0; position != end && shift < 70; shift += 7)
+          {
+              const unsigned char byte = *position++;
+              value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+              if (byte < 0x80) return value;
+          }
+      }
+      malformedTrackEncoding("truncated or overlong varint");
+  }
+
+  // One column of differences, decoded a block at a time into running values.
+  struct ColumnReader
+  {
+      const unsigned char* position;
+      const unsigned char* end;
+      std::uint64_t value = 0;
+
+      void readBlock(std::int64_t* values, std::size_t count)
+      {
+          for (std::size_t i = 0; i < count; ++i)
+          {
+              value += unzigzag(readVarint(position, end));
+              values[i] = static_cast<std::int64_t>(value);
+          }
+      }
+  };
+
+  void decodeTrack(std::string_view encoding, std::vector<Trackpoint>& trackPoints)
+  {
+      if (! encoding.starts_with(codecMagic) || encoding.size() == codecMagic.size()) malformedTrackEncoding("missing header");
+      const char version = encoding[codecMagic.size()];
+      if (version != codecVersion && version != wholeSecondsCodecVersion) malformedTrackEncoding("unsupported version");
+
+      const unsigned char* position = reinterpret_cast<const unsigned char*>(encoding.data()) + codecMagic.size() + 1;
+      const unsigned char* const end = reinterpret_cast<const unsigned char*>(encoding.data()) + encoding.size();
+
+      const std::uint64_t pointCount = readVarint(position, end);
+      const std::uint64_t coordinateDecimalPlaces = readVarint(position, end);
+      const std::uint64_t altitudeDecimalPlaces = readVarint(position, end);
+      const std::uint64_t timeUnitExponent = version == codecVersion ? readVarint(position, end) : 6;
+      if (coordinateDecimalPlaces > 12 || altitudeDecimalPlaces > 6) malformedTrackEncoding("precision out of range");
+      if (timeUnitExponent > 6) malformedTrackEncoding("time unit out of range");
+      const microseconds timeUnit = timeUnits[timeUnitExponent];
+      const double coordinateScale = powersOfTen[coordinateDecimalPlaces];
+      const double altitudeScale = powersOfTen[altitudeDecimalPlaces];
+
+      ColumnReader columns[4];
+      for (ColumnReader& column : columns)
+      {
+          const std::uint64_t size = readVarint(position, end);
+          if (size > static_cast<std::uint64_t>(end - position)) malformedTrackEncoding("truncated column");
+          column.position = position;
+          column.end = position + size;
+          position += size;
+      }
+      if (position != end) malformedTrackEncoding("unexpected data after the columns");
+      // Every point takes at least one byte in each column.
+      if (pointCount > static_cast<std::uint64_t>(columns[0].end - columns[0].position)) malformedTrackEncoding("too few points");
+
+      trackPoints.reserve(trackPoints.size() + pointCount);
+      std::int64_t latitudes[decodeBlockSize], longitudes[decodeBlockSize], altitudes[decodeBlockSize], timeStamps[decodeBlockSize];
+      for (std::uint64_t first = 0; first < pointCount; first += decodeBlockSize)
+      {
+          const std::size_t count = std::min<std::uint64_t>(decodeBlockSize, pointCount - first);
+          columns[0].readBlock(latitudes, count);
+          columns[1].readBlock(longitudes, count);
+          columns[2].readBlock(altitudes, count);
+          columns[3].readBlock(timeStamps, count);
+
+          // Dividing by an exact power of ten gives the double nearest to the decimal value.
+          try
+          {
+              for (std::size_t i = 0; i < count; ++i)
+              {
+                  const Waypoint waypoint {latitudes[i] / coordinateScale, longitudes[i] / coordinateScale, altitudes[i] / altitudeScale};
+                  trackPoints.push_back({waypoint, static_cast<microseconds>(static_cast<std::uint64_t>(timeStamps[i]) * timeUnit)});
+              }
+          }
+          catch (const std::invalid_argument& e)
+          {
+              malformedTrackEncoding(e.what());
+          }
+      }
+
+      for (const ColumnReader& column : columns)
+      {
+          if (column.position != column.end) malformedTrackEncoding("unexpected data at the end of a column");
+      }
+  }
+
+  std::vector<Trackpoint> decodeTrack(std::string_view encoding)
+  {
+      std::vector<Trackpoint> trackPoints;
+      decodeTrack(encoding, trackPoints);
+      return trackPoints;
+  }
+}
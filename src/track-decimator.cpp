@@ -0,0 +1,112 @@
+#include <stdexcept>
+#include <utility>
+
+#include "geometry.h"
+
+#include "track-decimator.h"
+
+namespace GPS
+{
+  TrackDecimator::TrackDecimator(Sink sink, DecimationOptions options)
+    : sink{std::move(sink)},
+      options{options}
+  {
+      if (options.interval < 0) throw std::invalid_argument("The decimation interval must not be negative.");
+      if (options.minimumDistance < 0) throw std::invalid_argument("The decimation distance must not be negative.");
+  }
+
+  namespace
+  {
+    // Intervals are numbered by rounding down, so points before the first one fall in earlier intervals.
+    microseconds intervalNumber(microseconds timeSinceStart, microseconds interval)
+    {
+        return timeSinceStart / interval - (timeSinceStart % interval < 0);
+    }
+  }
+
+  void TrackDecimator::add(const Trackpoint& trackPoint)
+  {
+      if (options.interval == 0)
+      {
+          keepIfDistant(trackPoint);
+          return;
+      }
+
+      if (! currentInterval) firstTime = trackPoint.timeStamp;
+      const microseconds interval = intervalNumber(trackPoint.timeStamp - firstTime, options.interval);
+
+      if (currentInterval != interval)
+      {
+          if (currentInterval) endInterval();
+          currentInterval = interval;
+          intervalStart = trackPoint;
+          latitudeSum = longitudeSum = altitudeSum = 0;
+          timeSum = 0;
+          pointCount = 0;
+          if (options.mode == DecimationOptions::Mode::FirstPoint) keepIfDistant(trackPoint);
+      }
+      else if (options.mode == DecimationOptions::Mode::FirstPoint)
+      {
+          lastDropped = trackPoint;
+      }
+
+      if (options.mode == DecimationOptions::Mode::Average)
+      {
+          // Longitudes are taken relative to the first, so that an interval spanning the anti-meridian averages correctly.
+          latitudeSum += trackPoint.waypoint.latitude() - intervalStart.waypoint.latitude();
+          longitudeSum += normaliseDegrees(trackPoint.waypoint.longitude() - intervalStart.waypoint.longitude());
+          altitudeSum += trackPoint.waypoint.altitude() - intervalStart.waypoint.altitude();
+          timeSum += trackPoint.timeStamp - intervalStart.timeStamp;
+          ++pointCount;
+          lastAveraged = trackPoint;
+      }
+  }
+
+  void TrackDecimator::finish()
+  {
+      if (currentInterval) endInterval();
+      currentInterval.reset();
+
+      // The mean of the final interval is earlier than its last point, unless that was its only point.
+      if (lastAveraged && ! (lastKept && lastKept->timeStamp == lastAveraged->timeStamp))
+      {
+          lastDropped = lastAveraged;
+      }
+      lastAveraged.reset();
+
+      if (lastDropped)
+      {
+          sink(*lastDropped);
+          lastKept = lastDropped;
+          lastDropped.reset();
+      }
+  }
+
+  void TrackDecimator::endInterval()
+  {
+      if (options.mode != DecimationOptions::Mode::Average) return;
+
+      const Waypoint& start = intervalStart.waypoint;
+      const Waypoint mean {start.latitude() + latitudeSum / pointCount,
+                           normaliseDegrees(start.longitude() + longitudeSum / pointCount),
+                           start.altitude() + altitudeSum / pointCount};
+      keepIfDistant({mean, intervalStart.timeStamp + timeSum / static_cast<microseconds>(pointCount)});
+  }
+
+  void TrackDecimator::keepIfDistant(const Trackpoint& trackPoint)
+  {
+      if (options.minimumDistance > 0 && lastKept)
+      {
+          const metres distance = pythagoras(Waypoint::horizontalDistanceBetween(lastKept->waypoint, trackPoint.waypoint),
+                                             Waypoint::verticalDistanceBetween(lastKept->waypoint, trackPoint.waypoint));
+          if (distance < options.minimumDistance)
+          {
+              lastDropped = trackPoint;
+              return;
+          }
+      }
+      sink(trackPoint);
+      lastKept = trackPoint;
+      lastDropped.reset();
+  }
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include "earth.h"
+#include "geometry.h"
+#include "track-file.h"
+
+namespace GPS
+{
+  /* Whether the records can be used as Trackpoints in place.  Waypoint is standard-layout, so its
+   * latitude, longitude and altitude are laid out in that order.
+   */
+  constexpr bool trackpointMatchesRecord = std::endian::native == std::endian::little
+                                           && std::numeric_limits<double>::is_iec559
+                                           && std::is_trivially_copyable_v<Trackpoint> && std::is_standard_layout_v<Waypoint>
+                                           && sizeof(Waypoint) == 3 * sizeof(double) && sizeof(microseconds) == 8
+                                           && sizeof(Trackpoint) == TrackFileFormat::recordSize && alignof(Trackpoint) <= 8;
+
+  std::uint64_t loadLittleEndian64(const unsigned char* bytes)
+  {
+      std::uint64_t value;
+      std::memcpy(&value, bytes, sizeof value);
+      if constexpr (std::endian::native == std::endian::big) value = __builtin_bswap64(value);
+      return value;
+  }
+
+  void storeLittleEndian64(unsigned char* bytes, std::uint64_t value)
+  {
+      if constexpr (std::endian::native == std::endian::big) value = __builtin_bswap64(value);
+      std::memcpy(bytes, &value, sizeof value);
+  }
+
+  std::uint32_t loadLittleEndian32(const unsigned char* bytes)
+  {
+      std::uint32_t value;
+      std::memcpy(&value, bytes, sizeof value);
+      if constexpr (std::endian::native == std::endian::big) value = __builtin_bswap32(value);
+      return value;
+  }
+
+  void storeLittleEndian32(unsigned char* bytes, std::uint32_t value)
+  {
+      if constexpr (std::endian::native == std::endian::big) value = __builtin_bswap32(value);
+      std::memcpy(bytes, &value, sizeof value);
+  }
+
+  // The checksum is built up a whole number of words at a time.
+  class Checksum
+  {
+    public:
+      void add(const unsigned char* words, std::size_t size)
+      {
+          for (std::size_t i = 0; i + 8 <= size; i += 8)
+          {
+              state = (state ^ loadLittleEndian64(words + i)) * 0x100000001b3;
+          }
+      }
+
+      std::uint64_t value() const
+      {
+          return state ^ (state >> 32);
+      }
+
+    private:
+      std::uint64_t state = 0xcbf29ce484222325;
+  };
+
+  std::uint64_t trackFileChecksum(const unsigned char* records, std::size_t size)
+  {
+      Checksum checksum;
+      checksum.add(records, size);
+      return checksum.value();
+  }
+
+  void encodeRecord(unsigned char* record, const Trackpoint& trackPoint)
+  {
+      storeLittleEndian64(record, std::bit_cast<std::uint64_t>(trackPoint.waypoint.latitude()));
+      storeLittleEndian64(record + 8, std::bit_cast<std::uint64_t>(trackPoint.waypoint.longitude()));
+      storeLittleEndian64(record + 16, std::bit_cast<std::uint64_t>(trackPoint.waypoint.altitude()));
+      storeLittleEndian64(record + 24, static_cast<std::uint64_t>(trackPoint.timeStamp));
+  }
+
+  // Version 1 records hold whole seconds, which are scaled by the time unit.
+  Trackpoint decodeRecord(const unsigned char* record, microseconds timeUnit = 1)
+  {
+      const Waypoint waypoint {std::bit_cast<double>(loadLittleEndian64(record)),
+                               std::bit_cast<double>(loadLittleEndian64(record + 8)),
+                               std::bit_cast<double>(loadLittleEndian64(record + 16))};
+      return {waypoint, static_cast<std::int64_t>(loadLittleEndian64(record + 24)) * timeUnit};
+  }
+
+  // Whether a record's latitude, longitude and altitude are ones that a Waypoint accepts.
+  bool recordHasValidPosition(const unsigned char* record)
+  {
+      return isValidLatitude(std::bit_cast<double>(loadLittleEndian64(record)))
+             && isValidLongitude(std::bit_cast<double>(loadLittleEndian64(record + 8)))
+             && Earth::isValidAltitude(std::bit_cast<double>(loadLittleEndian64(record + 16)));
+  }
+
+  void writeTrackFile(std::ostream& output, std::span<const Trackpoint> trackPoints)
+  {
+      // Records are encoded in blocks, first to compute the checksum and then to write them.
+      const std::size_t blockSize = 4096;
+      std::vector<unsigned char> block(blockSize * TrackFileFormat::recordSize);
+      auto forEachBlock = [&](auto useBlock)
+      {
+          for (std::size_t first = 0; first < trackPoints.size(); first += blockSize)
+          {
+              const std::size_t count = std::min(blockSize, trackPoints.size() - first);
+              for (std::size_t i = 0; i < count; ++i)
+              {
+                  encodeRecord(block.data() + i * TrackFileFormat::recordSize, trackPoints[first + i]);
+              }
+              useBlock(count * TrackFileFormat::recordSize);
+          }
+      };
+
+      Checksum checksum;
+      forEachBlock([&](std::size_t size) { checksum.add(block.data(), size); });
+
+      unsigned char header[TrackFileFormat::headerSize];
+      std::memcpy(header, TrackFileFormat::magic, sizeof TrackFileFormat::magic);
+      storeLittleEndian32(header + 8, TrackFileFormat::version);
+      storeLittleEndian32(header + 12, TrackFileFormat::recordSize);
+      storeLittleEndian64(header + 16, trackPoints.size());
+      storeLittleEndian64(header + 24, checksum.value());
+      output.write(reinterpret_cast<const char*>(header), sizeof header);
+
+      forEachBlock([&](std::size_t size) { output.write(reinterpret_cast<const char*>(block.data()), size); });
+  }
+
+  void writeTrackFile(const std::string& filePath, std::span<const Trackpoint> trackPoints)
+  {
+      std::ofstream output {filePath, std::ios::binary};
+      if (output) writeTrackFile(output, trackPoints);
+      output.close();
+      if (! output)
+      {
+          throw std::system_error(errno, std::generic_category(), "Cannot write '" + filePath + "'");
+      }
+  }
+
+  TrackFile::TrackFile(const std::string& filePath)
+    : file{filePath}
+  {
+      const std::string_view contents = file.contents();
+      const auto bytes = reinterpret_cast<const unsigned char*>(contents.data());
+      auto require = [&filePath](bool condition, const std::string& problem)
+      {
+          if (! condition) throw std::domain_error("Invalid track file '" + filePath + "': " + problem + ".");
+      };
+
+      require(contents.size() >= TrackFileFormat::headerSize && std::memcmp(bytes, TrackFileFormat::magic, sizeof TrackFileFormat::magic) == 0,
+              "not a track file");
+      const std::uint32_t version = loadLittleEndian32(bytes + 8);
+      require(version == TrackFileFormat::version || version == TrackFileFormat::wholeSecondsVersion,
+              "unsupported version " + std::to_string(version));
+      require(loadLittleEndian32(bytes + 12) == TrackFileFormat::recordSize, "unexpected record size");
+
+      const std::uint64_t pointCount = loadLittleEndian64(bytes + 16);
+      const std::size_t recordBytes = contents.size() - TrackFileFormat::headerSize;
+      require(pointCount == recordBytes / TrackFileFormat::recordSize && recordBytes % TrackFileFormat::recordSize == 0,
+              "expected " + std::to_string(pointCount) + " points but found " + std::to_string(recordBytes) + " bytes of records");
+
+      const unsigned char* records = bytes + TrackFileFormat::headerSize;
+      require(trackFileChecksum(records, recordBytes) == loadLittleEndian64(bytes + 24), "checksum mismatch");
+
+      // Checked for both paths below, since the points used in place are never passed through a Waypoint constructor.
+      for (std::size_t i = 0; i < pointCount; ++i)
+      {
+          require(recordHasValidPosition(records + i * TrackFileFormat::recordSize),
+                  "track point " + std::to_string(i) + " has an out-of-range latitude, longitude or altitude");
+      }
+
+      // A mapping is page-aligned, so the records are suitably aligned if the buffer is.
+      if (trackpointMatchesRecord && version == TrackFileFormat::version && reinterpret_cast<std::uintptr_t>(records) % alignof(Trackpoint) == 0)
+      {
+          points = {reinterpret_cast<const Trackpoint*>(records), static_cast<std::size_t>(pointCount)};
+      }
+      else
+      {
+          const microseconds timeUnit = version == TrackFileFormat::version ? 1 : microsecondsPerSecond;
+          decodedPoints.reserve(pointCount);
+          for (std::size_t i = 0; i < pointCount; ++i)
+          {
+              decodedPoints.push_back(decodeRecord(records + i * TrackFileFormat::recordSize, timeUnit));
+          }
+          points = decodedPoints;
+      }
+  }
+
+  std::span<const Trackpoint> TrackFile::trackPoints() const
+  {
+      return points;
+  }
+
+  std::vector<Trackpoint> readTrackFile(const std::string& filePath)
+  {
+      const TrackFile trackFile {filePath};
+      return {trackFile.trackPoints().begin(), trackFile.trackPoints().end()};
+  }
+}
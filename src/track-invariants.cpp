@@ -0,0 +1,78 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "track-invariants.h"
+
+namespace GPS
+{
+  TrackInvariants::TrackInvariants(std::span<const Trackpoint> trackPoints)
+    : pointCount{trackPoints.size()}
+  {
+      for (std::size_t i = 0; i < trackPoints.size(); ++i)
+      {
+          if (! firstNonIncreasingTime && i > 0 && trackPoints[i].timeStamp <= trackPoints[i-1].timeStamp)
+          {
+              firstNonIncreasingTime = i;
+          }
+          if (! firstInfiniteAltitude && std::isinf(trackPoints[i].waypoint.altitude()))
+          {
+              firstInfiniteAltitude = i;
+          }
+      }
+  }
+
+  bool TrackInvariants::hasPoints() const
+  {
+      return pointCount != 0;
+  }
+
+  bool TrackInvariants::hasLegs() const
+  {
+      return pointCount >= 2;
+  }
+
+  bool TrackInvariants::timesIncrease() const
+  {
+      return ! firstNonIncreasingTime;
+  }
+
+  bool TrackInvariants::altitudesFinite() const
+  {
+      return ! firstInfiniteAltitude;
+  }
+
+  void requireTrackPoints(const TrackInvariants& invariants)
+  {
+      if (! invariants.hasPoints()) throw std::domain_error("The track contains no track points.");
+  }
+
+  void requireLegs(const TrackInvariants& invariants)
+  {
+      if (! invariants.hasLegs()) throw std::domain_error("The track contains fewer than two track points.");
+  }
+
+  void requireIncreasingTimes(const TrackInvariants& invariants)
+  {
+      if (! invariants.timesIncrease())
+      {
+          throw std::domain_error("The time elapsed between adjacent track points must be positive, but the time of track point "
+                                  + std::to_string(*invariants.firstNonIncreasingTime) + " is not after that of the point before it.");
+      }
+  }
+
+  std::string TrackViolation::description() const
+  {
+      switch (kind)
+      {
+        case NoPoints:
+          return "The track contains no track points.";
+        case SensorCountMismatch:
+          return "Sensor readings do not match the number of track points.";
+        case NonIncreasingTime:
+          return "The time of track point " + std::to_string(pointIndex) + " is not after that of the point before it.";
+        case InfiniteAltitude:
+          return "The altitude of track point " + std::to_string(pointIndex) + " is infinite.";
+      }
+      return "The track is invalid.";
+  }
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "earth.h"
+#include "geometry.h"
+
+#include "track-leg.h"
+
+namespace GPS
+{
+  metres distanceBetween(const Waypoint& from, const Waypoint& to)
+  {
+      return pythagoras(Waypoint::horizontalDistanceBetween(from, to), Waypoint::verticalDistanceBetween(from, to));
+  }
+
+  Leg::Leg(const Trackpoint& from, const Trackpoint& to)
+    : horizontalDistance{Waypoint::horizontalDistanceBetween(from.waypoint, to.waypoint)},
+      altitudeChange{to.waypoint.altitude() - from.waypoint.altitude()},
+      duration{to.timeStamp - from.timeStamp}
+  {}
+
+  Leg::Leg(metres horizontalDistance, metres altitudeChange, microseconds duration)
+    : horizontalDistance{horizontalDistance},
+      altitudeChange{altitudeChange},
+      duration{duration}
+  {}
+
+  metres Leg::distance() const
+  {
+      return pythagoras(horizontalDistance, std::abs(altitudeChange));
+  }
+
+  seconds Leg::durationInSeconds() const
+  {
+      return static_cast<seconds>(duration) / microsecondsPerSecond;
+  }
+
+  speed Leg::averageSpeed() const
+  {
+      return distance() / durationInSeconds();
+  }
+
+  degrees Leg::gradient() const
+  {
+      return radToDeg(std::atan2(altitudeChange, horizontalDistance));
+  }
+
+  LegColumns::LegColumns(const PointColumns& points)
+  {
+      const std::size_t pointCount = points.size();
+      const std::size_t legCount = pointCount == 0 ? 0 : pointCount - 1;
+
+      std::vector<radians> latitudes(pointCount), longitudes(pointCount), latitudeCosines(pointCount);
+      for (std::size_t i = 0; i < pointCount; ++i)
+      {
+          latitudes[i] = degToRad(points.latitudes[i]);
+          longitudes[i] = degToRad(points.longitudes[i]);
+          latitudeCosines[i] = std::cos(latitudes[i]);
+      }
+
+      distances.resize(legCount);
+      altitudeChanges.resize(legCount);
+      durations.resize(legCount);
+      speeds.resize(legCount);
+      gradients.resize(legCount);
+      for (std::size_t i = 0; i < legCount; ++i)
+      {
+          altitudeChanges[i] = points.altitudes[i+1] - points.altitudes[i];
+          durations[i] = points.timeStamps[i+1] - points.timeStamps[i];
+      }
+      for (std::size_t i = 0; i < legCount; ++i)
+      {
+          const metres horizontalDistance = Earth::haversineDistance(latitudes[i], longitudes[i], latitudeCosines[i],
+                                                                     latitudes[i+1], longitudes[i+1], latitudeCosines[i+1]);
+          const Leg leg {horizontalDistance, altitudeChanges[i], durations[i]};
+          distances[i] = leg.distance();
+          speeds[i] = leg.averageSpeed();
+          gradients[i] = leg.gradient();
+      }
+  }
+
+  std::size_t LegColumns::size() const
+  {
+      return durations.size();
+  }
+
+  std::size_t LegColumns::capacityInBytes() const
+  {
+      return distances.capacity() * sizeof(metres) + altitudeChanges.capacity() * sizeof(metres)
+           + durations.capacity() * sizeof(microseconds) + speeds.capacity() * sizeof(speed)
+           + gradients.capacity() * sizeof(degrees);
+  }
+
+  void PeriodTotals::add(microseconds duration, metres distance, bool meetsCondition)
+  {
+      if (meetsCondition)
+      {
+          if (! lastLegMet)
+          {
+              ++count;
+              currentDuration = 0;
+          }
+          currentDuration += duration;
+          totalDuration += duration;
+          totalDistance += distance;
+          longestDuration = std::max(longestDuration, currentDuration);
+      }
+      else if (count == 0)
+      {
+          durationBeforeFirst += duration;
+      }
+      lastLegMet = meetsCondition;
+  }
+
+  seconds PeriodTotals::averageDuration() const
+  {
+      if (count == 0) throw std::domain_error("The track contains no such periods.");
+      return static_cast<seconds>(totalDuration) / microsecondsPerSecond / count;
+  }
+}
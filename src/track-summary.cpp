@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "track-summary.h"
+
+namespace GPS
+{
+  TrackSummary::TrackSummary(std::span<const Trackpoint> trackPoints, TrackSummaryOptions options)
+    : TrackSummary(trackPoints, TrackInvariants {trackPoints}, std::move(options))
+  {}
+
+  TrackSummary::TrackSummary(const Track& track, TrackSummaryOptions options)
+    : TrackSummary(std::span<const Trackpoint> {track.points()}, track.invariants(), std::move(options))
+  {}
+
+  /* Every comparison mirrors the one in the corresponding Track member function (strictly greater
+   * where the earlier point wins a tie, greater-or-equal where the later one does), and every value is
+   * derived from a Leg as it is there, so that the results are identical rather than merely close.
+   */
+  TrackSummary::TrackSummary(std::span<const Trackpoint> trackPoints, TrackInvariants invariants, TrackSummaryOptions options)
+    : summaryOptions{std::move(options)},
+      pointInvariants{std::move(invariants)}
+  {
+      if (trackPoints.empty()) return;
+
+      const std::optional<Waypoint>& target = summaryOptions.targetWaypoint;
+      std::array<std::size_t, extremeCount> indices {};
+      metres nearestDistance = 0;
+      metres farthestDistance = -1;
+
+      for (std::size_t i = 0; i < trackPoints.size(); ++i)
+      {
+          const Waypoint& point = trackPoints[i].waypoint;
+          if (i != 0)
+          {
+              if (point.altitude() > trackPoints[indices[Highest]].waypoint.altitude()) indices[Highest] = i;
+              if (point.altitude() < trackPoints[indices[Lowest]].waypoint.altitude()) indices[Lowest] = i;
+              if (point.latitude() > trackPoints[indices[Northernmost]].waypoint.latitude()) indices[Northernmost] = i;
+              if (point.latitude() < trackPoints[indices[Southernmost]].waypoint.latitude()) indices[Southernmost] = i;
+              if (point.longitude() > trackPoints[indices[Easternmost]].waypoint.longitude()) indices[Easternmost] = i;
+              if (point.longitude() < trackPoints[indices[Westernmost]].waypoint.longitude()) indices[Westernmost] = i;
+              const degrees distanceFromEquator = std::abs(point.latitude());
+              if (distanceFromEquator < std::abs(trackPoints[indices[MostEquatorial]].waypoint.latitude())) indices[MostEquatorial] = i;
+              if (distanceFromEquator > std::abs(trackPoints[indices[LeastEquatorial]].waypoint.latitude())) indices[LeastEquatorial] = i;
+
+              const Leg leg {trackPoints[i-1], trackPoints[i]};
+              const metres legDistance = leg.distance();
+              heightGain += std::max(0.0, leg.altitudeChange);
+              length += legDistance;
+
+              const seconds duration = leg.durationInSeconds();
+              const speed legSpeed = leg.averageSpeed();
+              fastest = std::max(fastest, legSpeed);
+              fastestAscent = std::max(fastestAscent, leg.altitudeChange / duration);
+              fastestDescent = std::max(fastestDescent, -leg.altitudeChange / duration);
+
+              const degrees gradient = leg.gradient();
+              if (i == 1 || std::abs(gradient) > std::abs(steepestLegGradient)) steepestLegGradient = gradient;
+              maxLegGradient = i == 1 ? gradient : std::max(maxLegGradient, gradient);
+              minLegGradient = i == 1 ? gradient : std::min(minLegGradient, gradient);
+
+              resting.add(leg.duration, legDistance, legSpeed <= summaryOptions.restingSpeedThreshold);
+              travelling.add(leg.duration, legDistance, legSpeed >= summaryOptions.travellingSpeedThreshold);
+          }
+
+          if (target)
+          {
+              const metres distance = distanceBetween(point, *target);
+              if (i == 0 || distance < nearestDistance)
+              {
+                  indices[Nearest] = i;
+                  nearestDistance = distance;
+              }
+              if (distance >= farthestDistance)
+              {
+                  indices[Farthest] = i;
+                  farthestDistance = distance;
+              }
+              if (distance <= summaryOptions.nearDistance) ++nearCount;
+          }
+      }
+
+      const Trackpoint& start = trackPoints.front();
+      const Trackpoint& finish = trackPoints.back();
+      elapsed = finish.timeStamp - start.timeStamp;
+      netHeightChange = finish.waypoint.altitude() - start.waypoint.altitude();
+      startToFinish = distanceBetween(start.waypoint, finish.waypoint);
+
+      extremes.reserve(extremeCount);
+      for (std::size_t index : indices) extremes.push_back(trackPoints[index].waypoint);
+  }
+
+  const TrackSummaryOptions& TrackSummary::options() const
+  {
+      return summaryOptions;
+  }
+
+  void TrackSummary::requireTargetWaypoint() const
+  {
+      if (! summaryOptions.targetWaypoint) throw std::logic_error("The summary was made without a target waypoint.");
+  }
+
+  Waypoint TrackSummary::extreme(Extreme which) const
+  {
+      requireTrackPoints(pointInvariants);
+      return extremes[which];
+  }
+
+  unsigned int TrackSummary::numberOfWaypoints() const
+  {
+      return pointInvariants.pointCount;
+  }
+
+  seconds TrackSummary::totalTime() const
+  {
+      requireTrackPoints(pointInvariants);
+      if (elapsed < 0) throw std::domain_error("The track finishes before it starts.");
+      return static_cast<seconds>(elapsed) / microsecondsPerSecond;
+  }
+
+  metres TrackSummary::netHeightGain() const
+  {
+      requireTrackPoints(pointInvariants);
+      return std::max(0.0, netHeightChange);
+  }
+
+  metres TrackSummary::totalHeightGain() const
+  {
+      requireTrackPoints(pointInvariants);
+      return heightGain;
+  }
+
+  metres TrackSummary::netLength() const
+  {
+      requireTrackPoints(pointInvariants);
+      return startToFinish;
+  }
+
+  metres TrackSummary::totalLength() const
+  {
+      requireTrackPoints(pointInvariants);
+      return length;
+  }
+
+  speed TrackSummary::averageSpeed() const
+  {
+      requireLegs(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return length / totalTime();
+  }
+
+  Waypoint TrackSummary::highestWaypoint() const
+  {
+      return extreme(Highest);
+  }
+
+  Waypoint TrackSummary::lowestWaypoint() const
+  {
+      return extreme(Lowest);
+  }
+
+  Waypoint TrackSummary::mostNorthelyWaypoint() const
+  {
+      return extreme(Northernmost);
+  }
+
+  Waypoint TrackSummary::mostSoutherlyWaypoint() const
+  {
+      return extreme(Southernmost);
+  }
+
+  Waypoint TrackSummary::mostEasterlyWaypoint() const
+  {
+      return extreme(Easternmost);
+  }
+
+  Waypoint TrackSummary::mostWesterlyWaypoint() const
+  {
+      return extreme(Westernmost);
+  }
+
+  Waypoint TrackSummary::mostEquatorialWaypoint() const
+  {
+      return extreme(MostEquatorial);
+  }
+
+  Waypoint TrackSummary::leastEquatorialWaypoint() const
+  {
+      return extreme(LeastEquatorial);
+  }
+
+  speed TrackSummary::maxSpeed() const
+  {
+      requireLegs(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return fastest;
+  }
+
+  speed TrackSummary::maxRateOfAscent() const
+  {
+      requireLegs(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return fastestAscent;
+  }
+
+  speed TrackSummary::maxRateOfDescent() const
+  {
+      requireLegs(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return fastestDescent;
+  }
+
+  degrees TrackSummary::maxGradient() const
+  {
+      requireLegs(pointInvariants);
+      return maxLegGradient;
+  }
+
+  degrees TrackSummary::minGradient() const
+  {
+      requireLegs(pointInvariants);
+      return minLegGradient;
+  }
+
+  degrees TrackSummary::steepestGradient() const
+  {
+      requireLegs(pointInvariants);
+      return steepestLegGradient;
+  }
+
+  Waypoint TrackSummary::nearestWaypointTo() const
+  {
+      requireTargetWaypoint();
+      return extreme(Nearest);
+  }
+
+  Waypoint TrackSummary::farthestWaypointFrom() const
+  {
+      requireTargetWaypoint();
+      return extreme(Farthest);
+  }
+
+  unsigned int TrackSummary::numberOfWaypointsNear() const
+  {
+      requireTargetWaypoint();
+      if (summaryOptions.nearDistance < 0) throw std::invalid_argument("The distance must not be negative.");
+      return nearCount;
+  }
+
+  fraction TrackSummary::proportionOfWaypointsNear() const
+  {
+      requireTargetWaypoint();
+      requireTrackPoints(pointInvariants);
+      return static_cast<fraction>(numberOfWaypointsNear()) / pointInvariants.pointCount;
+  }
+
+  seconds TrackSummary::restingTime() const
+  {
+      requireTrackPoints(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return static_cast<seconds>(resting.totalDuration) / microsecondsPerSecond;
+  }
+
+  seconds TrackSummary::travellingTime() const
+  {
+      requireTrackPoints(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return static_cast<seconds>(travelling.totalDuration) / microsecondsPerSecond;
+  }
+
+  seconds TrackSummary::longestRestingPeriod() const
+  {
+      requireTrackPoints(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return static_cast<seconds>(resting.longestDuration) / microsecondsPerSecond;
+  }
+
+  seconds TrackSummary::longestTravellingPeriod() const
+  {
+      requireTrackPoints(pointInvariants);
+      requireIncreasingTimes(pointInvariants);
+      return static_cast<seconds>(travelling.longestDuration) / microsecondsPerSecond;
+  }
+
+  seconds TrackSummary::averageRestingPeriod() const
+  {
+      requireIncreasingTimes(pointInvariants);
+      return resting.averageDuration();
+  }
+
+  seconds TrackSummary::averageTravellingPeriod() const
+  {
+      requireIncreasingTimes(pointInvariants);
+      return travelling.averageDuration();
+  }
+
+  fraction TrackSummary::proportionRestingTime() const
+  {
+      requireLegs(pointInvariants);
+      return restingTime() / totalTime();
+  }
+
+  fraction TrackSummary::proportionTravellingTime() const
+  {
+      requireLegs(pointInvariants);
+      return travellingTime() / totalTime();
+  }
+
+  speed TrackSummary::averageTravellingSpeed() const
+  {
+      requireIncreasingTimes(pointInvariants);
+      if (travelling.count == 0) throw std::domain_error("The track contains no travelling periods.");
+      return travelling.totalDistance / (static_cast<seconds>(travelling.totalDuration) / microsecondsPerSecond);
+  }
+
+  seconds TrackSummary::durationBeforeTravellingBegins() const
+  {
+      requireIncreasingTimes(pointInvariants);
+      if (travelling.count == 0) throw std::domain_error("The track contains no travelling periods.");
+      return static_cast<seconds>(travelling.durationBeforeFirst) / microsecondsPerSecond;
+  }
+}
@@ -1,240 +1,568 @@
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "geometry.h"
+#include "track-leg.h"
 
 #include "track.h"
 
 namespace GPS
 {
 
-Track::Track(std::vector<Trackpoint> trackPoints) : trackPoints{trackPoints} {}
+bool sensorCountMatches(const std::vector<Trackpoint>& trackPoints, const SensorData& sensorData)
+{
+    return sensorData.size() == 0 || sensorData.size() == trackPoints.size();
+}
+
+Track::Track(std::vector<Trackpoint> trackPoints, SensorData sensorData)
+  : trackPoints{std::move(trackPoints)},
+    sensorData{std::move(sensorData)},
+    pointInvariants{this->trackPoints}
+{
+    if (! sensorCountMatches(this->trackPoints, this->sensorData))
+    {
+        throw std::invalid_argument("Sensor readings do not match the number of track points.");
+    }
+}
+
+Track::Track(std::vector<Trackpoint> trackPoints, SensorData sensorData, TrackInvariants invariants)
+  : trackPoints{std::move(trackPoints)},
+    sensorData{std::move(sensorData)},
+    pointInvariants{std::move(invariants)}
+{}
+
+Track::Track(const Track& other)
+  : trackPoints{other.trackPoints},
+    sensorData{other.sensorData},
+    pointInvariants{other.pointInvariants}
+{
+    const std::lock_guard<std::mutex> lock {other.cacheMutex};
+    pointColumns = other.pointColumns;
+    legCache = other.legCache;
+}
+
+const std::shared_ptr<const PointColumns>& Track::buildPointColumns() const
+{
+    if (! pointColumns) pointColumns = std::make_shared<const PointColumns>(trackPoints);
+    return pointColumns;
+}
+
+// Built while holding the lock, so that threads making their first queries at once share one build.
+std::shared_ptr<const PointColumns> Track::columns() const
+{
+    const std::lock_guard<std::mutex> lock {cacheMutex};
+    return buildPointColumns();
+}
+
+std::shared_ptr<const LegColumns> Track::legs() const
+{
+    const std::lock_guard<std::mutex> lock {cacheMutex};
+    if (! legCache) legCache = std::make_shared<const LegColumns>(*buildPointColumns());
+    return legCache;
+}
+
+void Track::releaseCaches() const
+{
+    std::shared_ptr<const PointColumns> releasedPoints;
+    std::shared_ptr<const LegColumns> releasedLegs;
+    {
+        const std::lock_guard<std::mutex> lock {cacheMutex};
+        releasedPoints = std::move(pointColumns);
+        releasedLegs = std::move(legCache);
+    }
+    // Freed here, outside the lock, unless a query elsewhere still holds the columns.
+}
+
+bool Track::hasPointColumns() const
+{
+    const std::lock_guard<std::mutex> lock {cacheMutex};
+    return pointColumns != nullptr;
+}
+
+bool Track::hasLegCache() const
+{
+    const std::lock_guard<std::mutex> lock {cacheMutex};
+    return legCache != nullptr;
+}
+
+// The invariants are found once, and the Track only built if they hold.
+ValidatedTrack Track::validated(std::vector<Trackpoint> trackPoints, SensorData sensorData)
+{
+    if (! sensorCountMatches(trackPoints, sensorData)) return ValidatedTrack {TrackViolation {TrackViolation::SensorCountMismatch}};
+
+    TrackInvariants invariants {trackPoints};
+    if (! invariants.hasPoints()) return ValidatedTrack {TrackViolation {TrackViolation::NoPoints}};
+
+    // Whichever violation comes first in the track.
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+    const std::size_t timeIndex = invariants.firstNonIncreasingTime.value_or(none);
+    const std::size_t altitudeIndex = invariants.firstInfiniteAltitude.value_or(none);
+    if (timeIndex != none && timeIndex <= altitudeIndex)
+    {
+        return ValidatedTrack {TrackViolation {TrackViolation::NonIncreasingTime, timeIndex}};
+    }
+    if (altitudeIndex != none) return ValidatedTrack {TrackViolation {TrackViolation::InfiniteAltitude, altitudeIndex}};
+
+    return ValidatedTrack {std::unique_ptr<const Track>(new Track(std::move(trackPoints), std::move(sensorData), std::move(invariants)))};
+}
+
+const TrackInvariants& Track::invariants() const
+{
+    return pointInvariants;
+}
+
+const std::vector<Trackpoint>& Track::points() const
+{
+    return trackPoints;
+}
+
+const SensorData& Track::sensors() const
+{
+    return sensorData;
+}
+
+seconds secondsBetween(const Trackpoint& earlier, const Trackpoint& later)
+{
+    return static_cast<seconds>(later.timeStamp - earlier.timeStamp) / microsecondsPerSecond;
+}
+
+std::span<const double> requireReadings(const SensorData& sensorData, SensorChannel channel)
+{
+    if (! sensorData.hasChannel(channel)) throw std::domain_error("No sensor readings on the channel.");
+    return sensorData.channel(channel);
+}
+
+double Track::maxSensorReading(SensorChannel channel) const
+{
+    double maxReading = -std::numeric_limits<double>::infinity();
+    for (double reading : requireReadings(sensorData, channel))
+    {
+        if (reading > maxReading) maxReading = reading; // False for NaN.
+    }
+    return maxReading;
+}
+
+double Track::averageSensorReading(SensorChannel channel) const
+{
+    double total = 0;
+    std::size_t count = 0;
+    for (double reading : requireReadings(sensorData, channel))
+    {
+        if (std::isnan(reading)) continue;
+        total += reading;
+        ++count;
+    }
+    return total / count;
+}
+
+// The period's start trails its end through the points, so each reading is added and removed once.
+double Track::maxAverageSensorReading(SensorChannel channel, seconds period) const
+{
+    if (period < 0) throw std::invalid_argument("The period must not be negative.");
+    const std::span<const double> readings = requireReadings(sensorData, channel);
+
+    double maxAverage = -std::numeric_limits<double>::infinity();
+    double total = 0;
+    std::size_t count = 0;
+    std::size_t start = 0;
+    for (std::size_t end = 0; end < readings.size(); ++end)
+    {
+        if (! std::isnan(readings[end]))
+        {
+            total += readings[end];
+            ++count;
+        }
+        for (; secondsBetween(trackPoints[start], trackPoints[end]) > period; ++start)
+        {
+            if (std::isnan(readings[start])) continue;
+            total -= readings[start];
+            --count;
+        }
+        // Only periods that take in every point they can, so not the shorter ones at the start of the track.
+        const bool periodIsFull = end + 1 == readings.size()
+                               || secondsBetween(trackPoints[start], trackPoints[end + 1]) > period;
+        if (periodIsFull && count != 0) maxAverage = std::max(maxAverage, total / count);
+    }
+    return maxAverage;
+}
 
 
-// TODO: Stub definition needs implementing
 unsigned int Track::numberOfWaypoints() const
 {
-    return 0;
+    return trackPoints.size();
+}
+
+seconds legDurationInSeconds(const LegColumns& legs, std::size_t leg)
+{
+    return static_cast<seconds>(legs.durations[leg]) / microsecondsPerSecond;
+}
+
+// The times must increase, for the speeds to be meaningful.
+PeriodTotals restingPeriods(const LegColumns& legs, speed restingSpeedThreshold)
+{
+    PeriodTotals periods;
+    for (std::size_t i = 0; i < legs.size(); ++i)
+    {
+        periods.add(legs.durations[i], legs.distances[i], legs.speeds[i] <= restingSpeedThreshold);
+    }
+    return periods;
+}
+
+PeriodTotals travellingPeriods(const LegColumns& legs, speed travellingSpeedThreshold)
+{
+    PeriodTotals periods;
+    for (std::size_t i = 0; i < legs.size(); ++i)
+    {
+        periods.add(legs.durations[i], legs.distances[i], legs.speeds[i] >= travellingSpeedThreshold);
+    }
+    return periods;
+}
+
+// The earliest point for which the key is greatest.
+template <typename Key>
+Waypoint earliestWithGreatest(std::span<const Trackpoint> trackPoints, Key key)
+{
+    std::size_t best = 0;
+    double bestKey = key(trackPoints[0].waypoint);
+    for (std::size_t i = 1; i < trackPoints.size(); ++i)
+    {
+        const double pointKey = key(trackPoints[i].waypoint);
+        if (pointKey > bestKey)
+        {
+            best = i;
+            bestKey = pointKey;
+        }
+    }
+    return trackPoints[best].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 seconds Track::totalTime() const
 {
-    return 0;
+    requireTrackPoints(pointInvariants);
+    const seconds elapsed = secondsBetween(trackPoints.front(), trackPoints.back());
+    if (elapsed < 0) throw std::domain_error("The track finishes before it starts.");
+    return elapsed;
 }
 
-// TODO: Stub definition needs implementing
 metres Track::netHeightGain() const
 {
-    return 0;
+    requireTrackPoints(pointInvariants);
+    return std::max(0.0, trackPoints.back().waypoint.altitude() - trackPoints.front().waypoint.altitude());
 }
 
-// TODO: Stub definition needs implementing
 metres Track::totalHeightGain() const
 {
-    return 0;
+    requireTrackPoints(pointInvariants);
+    metres gain = 0;
+    for (metres altitudeChange : legs()->altitudeChanges) gain += std::max(0.0, altitudeChange);
+    return gain;
 }
 
-// TODO: Stub definition needs implementing
 metres Track::netLength() const
 {
-    return 0;
+    requireTrackPoints(pointInvariants);
+    return distanceBetween(trackPoints.front().waypoint, trackPoints.back().waypoint);
 }
 
-// TODO: Stub definition needs implementing
 metres Track::totalLength() const
 {
-    return 0;
+    requireTrackPoints(pointInvariants);
+    metres length = 0;
+    for (metres distance : legs()->distances) length += distance;
+    return length;
 }
 
-// TODO: Stub definition needs implementing
 speed Track::averageSpeed() const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    const std::shared_ptr<const LegColumns> legColumns = legs();
+    metres length = 0;
+    for (metres distance : legColumns->distances) length += distance;
+    return length / totalTime();
 }
 
-// TODO: Stub definition needs implementing
 Waypoint Track::highestWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfGreatest(columns()->altitudes)].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 Waypoint Track::lowestWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfLeast(columns()->altitudes)].waypoint;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// TODO: Stub definition needs implementing
 Waypoint Track::mostNorthelyWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfGreatest(columns()->latitudes)].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 Waypoint Track::mostSoutherlyWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfLeast(columns()->latitudes)].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 Waypoint Track::mostEasterlyWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfGreatest(columns()->longitudes)].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 Waypoint Track::mostWesterlyWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfLeast(columns()->longitudes)].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 Waypoint Track::mostEquatorialWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfLeastMagnitude(columns()->latitudes)].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 Waypoint Track::leastEquatorialWaypoint() const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return trackPoints[firstIndexOfGreatestMagnitude(columns()->latitudes)].waypoint;
 }
 
-// TODO: Stub definition needs implementing
 speed Track::maxSpeed() const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    const std::shared_ptr<const LegColumns> legColumns = legs();
+    return std::ranges::max(legColumns->speeds);
 }
 
-// TODO: Stub definition needs implementing
 speed Track::maxRateOfAscent() const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    const std::shared_ptr<const LegColumns> legColumns = legs();
+    speed fastest = 0;
+    for (std::size_t i = 0; i < legColumns->size(); ++i)
+    {
+        fastest = std::max(fastest, legColumns->altitudeChanges[i] / legDurationInSeconds(*legColumns, i));
+    }
+    return fastest;
 }
 
-// TODO: Stub definition needs implementing
 speed Track::maxRateOfDescent() const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    const std::shared_ptr<const LegColumns> legColumns = legs();
+    speed fastest = 0;
+    for (std::size_t i = 0; i < legColumns->size(); ++i)
+    {
+        fastest = std::max(fastest, -legColumns->altitudeChanges[i] / legDurationInSeconds(*legColumns, i));
+    }
+    return fastest;
 }
 
-// TODO: Stub definition needs implementing
 degrees Track::maxGradient() const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    return std::ranges::max(legs()->gradients);
 }
 
-// TODO: Stub definition needs implementing
 degrees Track::minGradient() const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    return std::ranges::min(legs()->gradients);
 }
 
-// TODO: Stub definition needs implementing
+// If an upwards and a downwards gradient are equally steep, the earlier one is returned.
 degrees Track::steepestGradient() const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    const std::shared_ptr<const LegColumns> legColumns = legs();
+    degrees steepest = legColumns->gradients.front();
+    for (degrees gradient : legColumns->gradients)
+    {
+        if (std::abs(gradient) > std::abs(steepest)) steepest = gradient;
+    }
+    return steepest;
+}
+
+Waypoint Track::nearestWaypointTo(Waypoint targetWaypoint) const
+{
+    requireTrackPoints(pointInvariants);
+    return earliestWithGreatest(trackPoints, [&](const Waypoint& waypoint) { return -distanceBetween(waypoint, targetWaypoint); });
+}
+
+Waypoint Track::farthestWaypointFrom(Waypoint targetWaypoint) const
+{
+    requireTrackPoints(pointInvariants);
+    std::size_t farthest = 0;
+    metres farthestDistance = -1;
+    for (std::size_t i = 0; i < trackPoints.size(); ++i)
+    {
+        const metres distance = distanceBetween(trackPoints[i].waypoint, targetWaypoint);
+        if (distance >= farthestDistance)
+        {
+            farthest = i;
+            farthestDistance = distance;
+        }
+    }
+    return trackPoints[farthest].waypoint;
+}
+
+void requireNearDistance(metres nearDistance)
+{
+    if (nearDistance < 0) throw std::invalid_argument("The distance must not be negative.");
 }
 
-// TODO: Stub definition needs implementing
-Waypoint Track::nearestWaypointTo(Waypoint) const
+unsigned int Track::numberOfWaypointsNear(Waypoint targetWaypoint, metres nearDistance) const
 {
-    return Waypoint(0,0,0);
+    requireNearDistance(nearDistance);
+    return std::count_if(trackPoints.begin(), trackPoints.end(), [&](const Trackpoint& trackPoint) {
+        return distanceBetween(trackPoint.waypoint, targetWaypoint) <= nearDistance;
+    });
 }
 
-// TODO: Stub definition needs implementing
-Waypoint Track::farthestWaypointFrom(Waypoint) const
+fraction Track::proportionOfWaypointsNear(Waypoint targetWaypoint, metres nearDistance) const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    return static_cast<fraction>(numberOfWaypointsNear(targetWaypoint, nearDistance)) / trackPoints.size();
 }
 
-// TODO: Stub definition needs implementing
-unsigned int Track::numberOfWaypointsNear(Waypoint, metres) const
+Waypoint Track::lastWaypointBefore(microseconds targetTime) const
 {
-    return 0;
+    requireIncreasingTimes(pointInvariants);
+    // The times increase, so the points before the target time are a prefix of the track.
+    const auto after = std::partition_point(trackPoints.begin(), trackPoints.end(), [targetTime](const Trackpoint& trackPoint) {
+        return trackPoint.timeStamp < targetTime;
+    });
+    if (after == trackPoints.begin()) throw std::domain_error("There are no track points before that time.");
+    return std::prev(after)->waypoint;
 }
 
-// TODO: Stub definition needs implementing
-fraction Track::proportionOfWaypointsNear(Waypoint, metres) const
+Waypoint Track::firstWaypointAfter(microseconds targetTime) const
 {
-    return 0;
+    requireIncreasingTimes(pointInvariants);
+    const auto after = std::partition_point(trackPoints.begin(), trackPoints.end(), [targetTime](const Trackpoint& trackPoint) {
+        return trackPoint.timeStamp <= targetTime;
+    });
+    if (after == trackPoints.end()) throw std::domain_error("There are no track points after that time.");
+    return after->waypoint;
 }
 
-// TODO: Stub definition needs implementing
-Waypoint Track::lastWaypointBefore(std::time_t) const
+seconds Track::restingTime(speed restingSpeedThreshold) const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    return static_cast<seconds>(restingPeriods(*legs(), restingSpeedThreshold).totalDuration) / microsecondsPerSecond;
 }
 
-// TODO: Stub definition needs implementing
-Waypoint Track::firstWaypointAfter(std::time_t) const
+seconds Track::travellingTime(speed travellingSpeedThreshold) const
 {
-    return Waypoint(0,0,0);
+    requireTrackPoints(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    return static_cast<seconds>(travellingPeriods(*legs(), travellingSpeedThreshold).totalDuration) / microsecondsPerSecond;
 }
 
-// TODO: Stub definition needs implementing
-seconds Track::restingTime(speed) const
+seconds Track::longestRestingPeriod(speed restingSpeedThreshold) const
 {
-    return 0;
+    requireTrackPoints(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    return static_cast<seconds>(restingPeriods(*legs(), restingSpeedThreshold).longestDuration) / microsecondsPerSecond;
 }
 
-// TODO: Stub definition needs implementing
-seconds Track::travellingTime(speed) const
+seconds Track::longestTravellingPeriod(speed travellingSpeedThreshold) const
 {
-    return 0;
+    requireTrackPoints(pointInvariants);
+    requireIncreasingTimes(pointInvariants);
+    return static_cast<seconds>(travellingPeriods(*legs(), travellingSpeedThreshold).longestDuration) / microsecondsPerSecond;
 }
 
-// TODO: Stub definition needs implementing
-seconds Track::longestRestingPeriod(speed) const
+seconds Track::averageRestingPeriod(speed restingSpeedThreshold) const
 {
-    return 0;
+    requireIncreasingTimes(pointInvariants);
+    return restingPeriods(*legs(), restingSpeedThreshold).averageDuration();
 }
 
-// TODO: Stub definition needs implementing
-seconds Track::longestTravellingPeriod(speed) const
+seconds Track::averageTravellingPeriod(speed travellingSpeedThreshold) const
 {
-    return 0;
+    requireIncreasingTimes(pointInvariants);
+    return travellingPeriods(*legs(), travellingSpeedThreshold).averageDuration();
 }
 
-// TODO: Stub definition needs implementing
-seconds Track::averageRestingPeriod(speed) const
+fraction Track::proportionRestingTime(speed restingSpeedThreshold) const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    return restingTime(restingSpeedThreshold) / totalTime();
 }
 
-// TODO: Stub definition needs implementing
-seconds Track::averageTravellingPeriod(speed) const
+fraction Track::proportionTravellingTime(speed travellingSpeedThreshold) const
 {
-    return 0;
+    requireLegs(pointInvariants);
+    return travellingTime(travellingSpeedThreshold) / totalTime();
 }
 
-// TODO: Stub definition needs implementing
-fraction Track::proportionRestingTime(speed) const
+speed Track::averageTravellingSpeed(speed travellingSpeedThreshold) const
 {
-    return 0;
+    requireIncreasingTimes(pointInvariants);
+    const PeriodTotals periods = travellingPeriods(*legs(), travellingSpeedThreshold);
+    if (periods.count == 0) throw std::domain_error("The track contains no travelling periods.");
+    return periods.totalDistance / (static_cast<seconds>(periods.totalDuration) / microsecondsPerSecond);
 }
 
-// TODO: Stub definition needs implementing
-fraction Track::proportionTravellingTime(speed) const
+seconds Track::durationBeforeTravellingBegins(speed travellingSpeedThreshold) const
 {
-    return 0;
+    requireIncreasingTimes(pointInvariants);
+    const PeriodTotals periods = travellingPeriods(*legs(), travellingSpeedThreshold);
+    if (periods.count == 0) throw std::domain_error("The track contains no travelling periods.");
+    return static_cast<seconds>(periods.durationBeforeFirst) / microsecondsPerSecond;
 }
 
-// TODO: Stub definition needs implementing
-speed Track::averageTravellingSpeed(speed) const
+
+ValidatedTrack::ValidatedTrack(std::unique_ptr<const Track> track)
+  : track{std::move(track)}
+{}
+
+ValidatedTrack::ValidatedTrack(TrackViolation violation)
+  : violation{violation}
+{}
+
+bool ValidatedTrack::has_value() const
+{
+    return track != nullptr;
+}
+
+ValidatedTrack::operator bool() const
 {
-    return 0;
+    return has_value();
 }
 
-// TODO: Stub definition needs implementing
-seconds Track::durationBeforeTravellingBegins(speed) const
+const Track& ValidatedTrack::value() const
 {
-    return 0;
+    if (! track) throw std::logic_error("The track points were rejected: " + violation->description());
+    return *track;
 }
 
+const Track* ValidatedTrack::operator->() const
+{
+    return &value();
+}
+
+const TrackViolation& ValidatedTrack::error() const
+{
+    if (! violation) throw std::logic_error("The track points were accepted.");
+    return *violation;
+}
 
 }
@@ -40,17 +40,13 @@ namespace GPS
   }
 
   metres Waypoint::horizontalDistanceBetween(Waypoint p1, Waypoint p2)
-  /* The Haversine Formula
-   * See: https://en.wikipedia.org/wiki/Haversine_formula
-   */
   {
       const radians lat1 = degToRad(p1.latitude());
       const radians lat2 = degToRad(p2.latitude());
       const radians lon1 = degToRad(p1.longitude());
       const radians lon2 = degToRad(p2.longitude());
 
-      const double h = sinSqr((lat2-lat1)/2) + std::cos(lat1)*std::cos(lat2)*sinSqr((lon2-lon1)/2);
-      return 2 * Earth::meanRadius * std::asin(std::sqrt(h));
+      return Earth::haversineDistance(lat1, lon1, std::cos(lat1), lat2, lon2, std::cos(lat2));
   }
 
   metres Waypoint::verticalDistanceBetween(Waypoint p1, Waypoint p2)
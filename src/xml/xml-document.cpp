@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "xml-parser.h"
+
+#include "xml-document.h"
+
+namespace XML
+{
+
+// Nodes, Attributes and the name index are never destroyed individually.
+static_assert(std::is_trivially_destructible_v<Node>);
+static_assert(std::is_trivially_destructible_v<Attribute>);
+
+const std::size_t maxArenaBlockSize = 4 * 1024 * 1024;
+
+// Sub-elements of Nodes with more children than this are indexed by name.
+const std::uint32_t nameIndexThreshold = 16;
+
+void* Arena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    auto alignUp = [alignment](std::byte* pointer) {
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
+        return reinterpret_cast<std::byte*>((address + alignment - 1) & ~(alignment - 1));
+    };
+
+    std::byte* allocation = alignUp(next);
+    if (next == nullptr || allocation > limit || static_cast<std::size_t>(limit - allocation) < bytes)
+    {
+        const std::size_t newBlockSize = std::max(blockSize, bytes + alignment);
+        blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(newBlockSize));
+        reserved += newBlockSize;
+        next = blocks.back().get();
+        limit = next + newBlockSize;
+        blockSize = std::min(blockSize * 2, maxArenaBlockSize);
+        allocation = alignUp(next);
+    }
+    next = allocation + bytes;
+    return allocation;
+}
+
+std::string_view Arena::store(std::string_view text)
+{
+    if (text.empty()) return {};
+
+    char* copy = allocateArray<char>(text.size());
+    std::memcpy(copy, text.data(), text.size());
+    return {copy, text.size()};
+}
+
+std::size_t Arena::bytesReserved() const
+{
+    return reserved;
+}
+
+std::string_view NameTable::intern(std::string_view name, Arena& arena)
+{
+    auto existing = names.find(name);
+    if (existing != names.end()) return *existing;
+
+    // Names are stored with a terminating null so that even an empty name has a unique data() pointer.
+    char* copy = arena.allocateArray<char>(name.size() + 1);
+    std::memcpy(copy, name.data(), name.size());
+    copy[name.size()] = '\0';
+    return *names.insert({copy, name.size()}).first;
+}
+
+std::string_view NameTable::find(std::string_view name) const
+{
+    auto existing = names.find(name);
+    return existing != names.end() ? *existing : std::string_view{};
+}
+
+struct Node::NameIndex
+{
+    struct Entry
+    {
+        const char* name;
+        const Node* const* subElements;
+        std::uint32_t count;
+    };
+
+    const Entry* entries;
+    std::uint32_t entryCount;
+
+    const Entry* find(const char* name) const
+    {
+        for (const Entry* entry = entries; entry != entries + entryCount; ++entry)
+        {
+            if (entry->name == name) return entry;
+        }
+        return nullptr;
+    }
+};
+
+NodeRange::iterator::iterator(const Node* node, const char* name)
+    : node{node}, name{name}
+{
+    while (this->node != nullptr && name != nullptr && this->node->name.data() != name)
+    {
+        this->node = this->node->nextSibling;
+    }
+}
+
+NodeRange::iterator& NodeRange::iterator::operator++()
+{
+    *this = iterator(node->nextSibling, name);
+    return *this;
+}
+
+const char* Node::internedName(std::string_view name) const
+{
+    return nameTable->find(name).data();
+}
+
+std::string_view Node::getAttribute(std::string_view attributeName) const
+{
+    const char* interned = internedName(attributeName);
+    for (const Attribute& attribute : getAttributes())
+    {
+        if (attribute.name.data() == interned) return attribute.value;
+    }
+    throw std::out_of_range("No '" + std::string{attributeName} + "' attribute.");
+}
+
+bool Node::containsAttribute(std::string_view attributeName) const
+{
+    const char* interned = internedName(attributeName);
+    return std::ranges::any_of(getAttributes(), [interned](const Attribute& attribute) { return attribute.name.data() == interned; });
+}
+
+const Node& Node::getSubElement(std::string_view subElementName, std::size_t subElementNum) const
+{
+    const char* interned = internedName(subElementName);
+    if (interned != nullptr)
+    {
+        if (nameIndex != nullptr)
+        {
+            const NameIndex::Entry* entry = nameIndex->find(interned);
+            if (entry != nullptr && subElementNum < entry->count) return *entry->subElements[subElementNum];
+        }
+        else
+        {
+            std::size_t index = 0;
+            for (const Node& subElement : NodeRange(firstChild, interned))
+            {
+                if (index++ == subElementNum) return subElement;
+            }
+        }
+    }
+    throw std::out_of_range("No '" + std::string{subElementName} + "' element number " + std::to_string(subElementNum) + ".");
+}
+
+NodeRange Node::getSubElements() const
+{
+    return {firstChild, nullptr};
+}
+
+NodeRange Node::getSubElements(std::string_view subElementName) const
+{
+    const char* interned = internedName(subElementName);
+    return {interned != nullptr ? firstChild : nullptr, interned};
+}
+
+bool Node::containsSubElement(std::string_view subElementName) const
+{
+    return ! getSubElements(subElementName).empty();
+}
+
+unsigned int Node::countSubElements(std::string_view subElementName) const
+{
+    const char* interned = internedName(subElementName);
+    if (interned == nullptr) return 0;
+
+    if (nameIndex != nullptr)
+    {
+        const NameIndex::Entry* entry = nameIndex->find(interned);
+        return entry != nullptr ? entry->count : 0;
+    }
+
+    auto subElements = NodeRange(firstChild, interned);
+    return std::distance(subElements.begin(), subElements.end());
+}
+
+Document::Document(Parser& parser)
+    : names{std::make_unique<NameTable>()}
+{
+    std::vector<Node*> openNodes;
+    std::vector<Node*> lastSubElements;
+
+    for (Event event = parser.nextEvent(); event.type != Event::Type::EndOfDocument; event = parser.nextEvent())
+    {
+        switch (event.type)
+        {
+          case Event::Type::StartElement:
+          {
+            Node* node = new (arena.allocateArray<Node>(1)) Node;
+            node->name = names->intern(event.name, arena);
+            node->nameTable = names.get();
+
+            // As with XML::Element, the last of any duplicated attributes wins.
+            Attribute* attributes = arena.allocateArray<Attribute>(event.attributes.size());
+            std::uint32_t attributeCount = 0;
+            for (const AttributeView& attributeView : event.attributes)
+            {
+                std::string_view name = names->intern(attributeView.name, arena);
+                std::string_view value = arena.store(attributeView.value);
+                Attribute* duplicate = std::find_if(attributes, attributes + attributeCount,
+                                                    [&name](const Attribute& attribute) { return attribute.name.data() == name.data(); });
+                if (duplicate != attributes + attributeCount)
+                {
+                    duplicate->value = value;
+                }
+                else
+                {
+                    new (attributes + attributeCount++) Attribute{name, value};
+                }
+            }
+            node->attributes = attributes;
+            node->attributeCount = attributeCount;
+
+            if (openNodes.empty())
+            {
+                root = node;
+            }
+            else
+            {
+                Node* parent = openNodes.back();
+                if (parent->firstChild == nullptr)
+                {
+                    parent->firstChild = node;
+                }
+                else
+                {
+                    lastSubElements.back()->nextSibling = node;
+                }
+                lastSubElements.back() = node;
+                ++parent->childCount;
+            }
+            openNodes.push_back(node);
+            lastSubElements.push_back(nullptr);
+            break;
+          }
+
+          case Event::Type::Text:
+            openNodes.back()->leafContent = arena.store(event.text);
+            break;
+
+          case Event::Type::EndElement:
+            if (openNodes.back()->childCount > nameIndexThreshold)
+            {
+                buildNameIndexes(*openNodes.back());
+            }
+            openNodes.pop_back();
+            lastSubElements.pop_back();
+            break;
+
+          case Event::Type::EndOfDocument:
+            break;
+        }
+    }
+}
+
+void Document::buildNameIndexes(Node& node)
+{
+    // Group the sub-elements by name, preserving document order within each group.
+    std::vector<const Node*> subElements;
+    subElements.reserve(node.childCount);
+    for (const Node& subElement : node.getSubElements())
+    {
+        subElements.push_back(&subElement);
+    }
+    std::ranges::stable_sort(subElements, {}, [](const Node* subElement) { return subElement->name.data(); });
+
+    const Node** groupedSubElements = arena.allocateArray<const Node*>(subElements.size());
+    std::uninitialized_copy(subElements.begin(), subElements.end(), groupedSubElements);
+
+    std::vector<Node::NameIndex::Entry> entries;
+    for (std::size_t i = 0; i < subElements.size(); ++i)
+    {
+        if (entries.empty() || entries.back().name != subElements[i]->name.data())
+        {
+            entries.push_back({subElements[i]->name.data(), groupedSubElements + i, 0});
+        }
+        ++entries.back().count;
+    }
+
+    Node::NameIndex::Entry* storedEntries = arena.allocateArray<Node::NameIndex::Entry>(entries.size());
+    std::uninitialized_copy(entries.begin(), entries.end(), storedEntries);
+
+    node.nameIndex = new (arena.allocateArray<Node::NameIndex>(1)) Node::NameIndex{storedEntries, static_cast<std::uint32_t>(entries.size())};
+}
+
+}
@@ -1,5 +1,7 @@
 #include <map>
 #include <vector>
+#include <utility>
+#include <stdexcept>
 
 #include "xml-element.h"
 
@@ -7,50 +9,43 @@ namespace XML
 {
 
 Element::Element(ElementName name, Attributes attributes)
-    : name{name}, attributes{attributes}
+    : name{std::move(name)}, attributes{std::move(attributes)}
 {}
 
 InternalNodeElement::InternalNodeElement(ElementName name, Attributes attributes, SubElements subElements)
-    : Element(name, attributes)
+    : Element(std::move(name), std::move(attributes))
 {
-    this->subElements = subElements;
+    this->subElements = std::move(subElements);
 }
 
 LeafElement::LeafElement(ElementName name, Attributes attributes, LeafContent leafContent)
-    : Element(name,attributes)
+    : Element(std::move(name), std::move(attributes))
 {
-    this->leafContent = leafContent;
+    this->leafContent = std::move(leafContent);
 }
 
 SelfClosingElement::SelfClosingElement(ElementName name, Attributes attributes)
-    : LeafElement(name,attributes,"")
+    : LeafElement(std::move(name), std::move(attributes), "")
 {}
 
-ElementName Element::getName() const
+const ElementName& Element::getName() const
 {
     return name;
 }
 
-bool Element::containsAttribute(AttributeName attributeName) const
+bool Element::containsAttribute(std::string_view attributeName) const
 {
     return attributes.contains(attributeName);
 }
 
-bool Element::containsSubElement(ElementName subElementName) const
+bool Element::containsSubElement(std::string_view subElementName) const
 {
     return subElements.contains(subElementName);
 }
 
-unsigned int Element::countSubElements(ElementName subElementName) const
+unsigned int Element::countSubElements(std::string_view subElementName) const
 {
-    if (containsSubElement(subElementName))
-    {
-        return subElements.at(subElementName).size();
-    }
-    else
-    {
-        return 0;
-    }
+    return getSubElements(subElementName).size();
 }
 
 bool Element::isLeaf() const
@@ -58,17 +53,30 @@ bool Element::isLeaf() const
     return subElements.empty();
 }
 
-AttributeValue Element::getAttribute(AttributeName attributeName) const
+const AttributeValue& Element::getAttribute(std::string_view attributeName) const
+{
+    auto attribute = attributes.find(attributeName);
+    if (attribute == attributes.end())
+    {
+        throw std::out_of_range("No '" + std::string{attributeName} + "' attribute.");
+    }
+    return attribute->second;
+}
+
+const Element& Element::getSubElement(std::string_view subElementName, size_t index) const
 {
-    return attributes.at(attributeName);
+    return getSubElements(subElementName).at(index);
 }
 
-Element Element::getSubElement(ElementName subElementName, size_t index) const
+const std::vector<Element>& Element::getSubElements(std::string_view subElementName) const
 {
-    return subElements.at(subElementName).at(index);
+    static const std::vector<Element> none;
+
+    auto namedSubElements = subElements.find(subElementName);
+    return namedSubElements != subElements.end() ? namedSubElements->second : none;
 }
 
-LeafContent Element::getLeafContent() const
+const LeafContent& Element::getLeafContent() const
 {
     return leafContent;
 }
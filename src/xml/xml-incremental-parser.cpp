@@ -0,0 +1,88 @@
+#include <utility>
+
+#include "xml-incremental-parser.h"
+
+namespace XML
+{
+
+IncrementalParser::IncrementalParser(EventHandler handler, PathFilter filter)
+    : handler{std::move(handler)}, parser{std::string_view{buffer}}
+{
+    parser.inputIsComplete = false;
+    parser.setFilter(std::move(filter));
+}
+
+void IncrementalParser::feed(const char* data, std::size_t size)
+{
+    if (complete) return;
+
+    // Discard the consumed text, keeping any unfinished token, then re-point the Parser at the buffer.
+    parser.moveTextStart(parser.cursor);
+    buffer.erase(0, parser.cursor - buffer.data());
+    buffer.append(data, size);
+    parser.cursor = buffer.data();
+    parser.end = buffer.data() + buffer.size();
+    parser.textStart = buffer.data();
+
+    parseAvailableText();
+}
+
+void IncrementalParser::finish()
+{
+    parser.inputIsComplete = true;
+    parseAvailableText();
+}
+
+bool IncrementalParser::isComplete() const
+{
+    return complete;
+}
+
+std::size_t IncrementalParser::bufferedSize() const
+{
+    return buffer.size();
+}
+
+void IncrementalParser::parseAvailableText()
+{
+    while (! complete)
+    {
+        /* A token that runs off the end of the buffer is re-parsed from the start once more text arrives.
+         * Skipped elements are not: the text up to the last tag scanned within an unfinished one, or
+         * else up to the last whole one, is consumed, and discarded by the next feed().
+         */
+        const char* resumePosition = parser.cursor;
+        const Parser::EventState resumeState = parser.eventState;
+        parser.skippedUpTo = nullptr;
+
+        Event event;
+        try
+        {
+            event = parser.nextEvent();
+        }
+        catch (const Parser::IncompleteInput&)
+        {
+            if (parser.skippedElementCount != 0)
+            {
+                parser.cursor = parser.skipResumePosition;
+                parser.eventState = Parser::EventState::InSkippedElement;
+            }
+            else if (parser.skippedUpTo)
+            {
+                parser.cursor = parser.skippedUpTo;
+                parser.eventState = Parser::EventState::InSubElements;
+            }
+            else
+            {
+                parser.cursor = resumePosition;
+                parser.eventState = resumeState;
+            }
+            return;
+        }
+
+        complete = event.type == Event::Type::EndOfDocument;
+        handler(event);
+    }
+}
+
+}
@@ -1,34 +1,73 @@
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <vector>
 #include <cctype>
-#include <iterator>
-#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "xml-element.h"
+#include "xml-scan.h"
 
 #include "xml-parser.h"
 
 namespace XML
 {
 
+ParseError::ParseError(const std::string& problem, std::size_t offset, std::size_t line, std::size_t column, std::string elementPath)
+    : std::domain_error("Malformed XML: " + problem + " at line " + std::to_string(line) + ", column " + std::to_string(column)
+                        + (elementPath.empty() ? "" : " within " + elementPath) + "."),
+      errorOffset{offset}, errorLine{line}, errorColumn{column}, path{std::move(elementPath)}
+{}
+
 Parser::Parser(std::istream& xml)
-    : xmlSource{xml}
+{
+    // Read the stream in large blocks rather than character-by-character.
+    const std::streamsize blockSize = 1 << 16;
+    std::streamsize charsRead;
+    do
+    {
+        const std::size_t oldSize = ownedSource.size();
+        ownedSource.resize(oldSize + blockSize);
+        charsRead = xml.rdbuf()->sgetn(ownedSource.data() + oldSize, blockSize);
+        ownedSource.resize(oldSize + charsRead);
+    }
+    while (charsRead == blockSize);
+
+    cursor = ownedSource.data();
+    end = cursor + ownedSource.size();
+    textStart = cursor;
+}
+
+Parser::Parser(std::string_view xml)
+    : cursor{xml.data()}, end{xml.data() + xml.size()}, textStart{xml.data()}
 {}
 
+Parser::Parser(std::string_view xml, EventState initialState, EventState afterTopLevelElement)
+    : Parser{xml}
+{
+    eventState = initialState;
+    this->afterTopLevelElement = afterTopLevelElement;
+}
+
 struct Parser::OpeningTag
 {
-    ElementName name;
-    std::map<AttributeName, AttributeValue> attributes;
+    std::string_view name;
     bool isSelfClosing;
 };
 
+void Parser::setFilter(PathFilter newFilter)
+{
+    filter = std::move(newFilter);
+}
+
 Element Parser::parseRootElement()
 {
     parseWhitespace();
     tryparseProlog();
     parseWhitespace();
-    return parseElement();
+    return parseElement(filter.root());
 }
 
 void Parser::tryparseProlog()
@@ -38,41 +77,161 @@ void Parser::tryparseProlog()
         parseWhitespace();
         parseAttributes();
         parseWhitespace();
-        require(tryParseString("?>"), "prolog not terminated correctly.");
+        require(tryParseString("?>"), "prolog not terminated correctly");
+    }
+}
+
+Event Parser::nextEvent()
+{
+    switch (eventState)
+    {
+      case EventState::BeforeRootElement:
+        parseWhitespace();
+        tryparseProlog();
+        parseWhitespace();
+        return startElementEvent();
+
+      case EventState::BetweenSequenceElements:
+        parseWhitespace();
+        if (cursor != end && ! closingTagNext())
+        {
+            return startElementEvent();
+        }
+        eventState = EventState::EndOfDocument;
+        break;
+
+      case EventState::AfterOpeningTag:
+      {
+        std::string_view potentialLeafContent = parseLeafContent();
+        eventState = EventState::InSubElements;
+        if (closingTagNext())
+        {
+            return {Event::Type::Text, currentElement(), {}, potentialLeafContent};
+        }
+        return nextEvent(); // Not a leaf, so the content is discarded.
+      }
+
+      case EventState::AfterSelfClosingTag:
+        return endElementEvent();
+
+      case EventState::InSubElements:
+        for (;;)
+        {
+            parseWhitespace();
+            if (closingTagNext())
+            {
+                parseClosingTag(currentElement());
+                return endElementEvent();
+            }
+            if (! nextElementIsSkipped(openFilterNodes.back()))
+            {
+                return startElementEvent();
+            }
+            skipElement();
+            skippedUpTo = cursor;
+        }
+
+      case EventState::InSkippedElement:
+        continueSkippedElement();
+        skippedUpTo = cursor;
+        eventState = EventState::InSubElements;
+        return nextEvent();
+
+      case EventState::EndOfDocument:
+        break;
     }
+    return {Event::Type::EndOfDocument, {}, {}, {}};
+}
+
+Parser Parser::forElementSequence(std::string_view xml)
+{
+    return {xml, EventState::BetweenSequenceElements, EventState::BetweenSequenceElements};
+}
+
+void Parser::skipTo(const char* position)
+{
+    if (eventState != EventState::InSubElements || position < cursor || position > end)
+    {
+        throw std::logic_error("Parser::skipTo() must follow the end of a sub-element, and move forwards within the text.");
+    }
+    cursor = position;
+}
+
+void Parser::openElement(std::string_view name)
+{
+    if (openElementCount == openElements.size()) openElements.emplace_back();
+    openElements[openElementCount++].assign(name);
+}
+
+std::string_view Parser::closeElement()
+{
+    // The string is left intact, so the view stays valid until another element is opened.
+    return openElements[--openElementCount];
+}
+
+std::string_view Parser::currentElement() const
+{
+    return openElements[openElementCount - 1];
 }
 
-Element Parser::parseElement()
+Event Parser::startElementEvent()
 {
     OpeningTag openingTag = parseOpeningTag();
+    openElement(openingTag.name);
+    openFilterNodes.push_back(filter.child(openFilterNodes.empty() ? filter.root() : openFilterNodes.back(), openingTag.name));
+    eventState = openingTag.isSelfClosing ? EventState::AfterSelfClosingTag : EventState::AfterOpeningTag;
+    return {Event::Type::StartElement, openingTag.name, parsedAttributes, {}};
+}
+
+Event Parser::endElementEvent()
+{
+    std::string_view name = closeElement();
+    openFilterNodes.pop_back();
+    eventState = openElementCount == 0 ? afterTopLevelElement : EventState::InSubElements;
+    return {Event::Type::EndElement, name, {}, {}};
+}
+
+Element Parser::parseElement(PathFilter::Node parent)
+{
+    OpeningTag openingTag = parseOpeningTag();
+    const PathFilter::Node filterNode = filter.child(parent, openingTag.name);
+
+    Attributes attributes;
+    for (const AttributeView& attribute : parsedAttributes)
+    {
+        attributes.insert_or_assign(AttributeName{attribute.name}, AttributeValue{attribute.value});
+    }
 
     if (openingTag.isSelfClosing)
     {
-        return SelfClosingElement(openingTag.name,openingTag.attributes);
+        return SelfClosingElement(ElementName{openingTag.name},std::move(attributes));
     }
 
-    LeafContent potentialLeafContent = parseLeafContent();
+    openElement(openingTag.name); // For error reports.
+    std::string_view potentialLeafContent = parseLeafContent();
 
     if (closingTagNext())
     {
         parseClosingTag(openingTag.name);
-        return LeafElement(openingTag.name,openingTag.attributes,potentialLeafContent);
+        closeElement();
+        return LeafElement(ElementName{openingTag.name},std::move(attributes),LeafContent{potentialLeafContent});
     }
     else
     {
-        SubElements subElements = parseSubElements();
+        SubElements subElements = parseSubElements(filterNode);
         parseClosingTag(openingTag.name);
-        return InternalNodeElement(openingTag.name,openingTag.attributes,subElements);
+        closeElement();
+        return InternalNodeElement(ElementName{openingTag.name},std::move(attributes),std::move(subElements));
     }
 }
 
 Parser::OpeningTag Parser::parseOpeningTag()
 {
     OpeningTag tag;
-    require(tryParseChar('<'), "opening tag not started correctly.");
+    require(tryParseChar('<'), "opening tag not started correctly");
     tag.name = parseName();
     parseWhitespace();
-    tag.attributes = parseAttributes();
+    parseAttributes();
 
     if (tryParseChar('>'))
     {
@@ -80,44 +239,54 @@ Parser::OpeningTag Parser::parseOpeningTag()
     }
     else
     {
-        require(tryParseString("/>"), "opening tag not terminated correctly.");
+        require(tryParseString("/>"), "opening tag not terminated correctly");
         tag.isSelfClosing = true;
     }
 
     return tag;
 }
 
-void Parser::parseClosingTag(ElementName tagName)
+void Parser::parseClosingTag(std::string_view tagName)
 {
-    std::string closingTag = "</" + tagName + ">";
-    require(tryParseString(closingTag), "missing closing tag: " + closingTag);
+    const char* closingTagStart = cursor;
+    if (! (tryParseString("</") && tryParseString(tagName) && tryParseChar('>')))
+    {
+        cursor = closingTagStart;
+        fail("missing closing tag for", tagName);
+    }
 }
 
-Attributes Parser::parseAttributes()
+void Parser::parseAttributes()
 {
-    std::map<AttributeName, AttributeValue> attributes;
+    parsedAttributes.clear();
     while (nameNext())
     {
-        AttributeName name = parseName();
+        std::string_view name = parseName();
         parseWhitespace();
-        require(tryParseChar('='), "attribute missing '='");
+        require(tryParseChar('='), "attribute missing '='", name);
         parseWhitespace();
-        AttributeValue value = parseAttributeValue();
+        std::string_view value = parseAttributeValue();
         parseWhitespace();
-        attributes[name] = value;
+        parsedAttributes.push_back({name, value});
     }
-    return attributes;
 }
 
-SubElements Parser::parseSubElements()
+SubElements Parser::parseSubElements(PathFilter::Node filterNode)
 {
-    std::map<ElementName, std::vector<Element>> subElements;
+    SubElements subElements;
 
     parseWhitespace();
     while (! closingTagNext())
     {
-        Element element = parseElement();
-        subElements[element.getName()].push_back(element);
+        if (nextElementIsSkipped(filterNode))
+        {
+            skipElement();
+        }
+        else
+        {
+            Element element = parseElement(filterNode);
+            subElements[element.getName()].push_back(std::move(element));
+        }
 
         parseWhitespace();
     }
@@ -125,117 +294,220 @@ SubElements Parser::parseSubElements()
     return subElements;
 }
 
-AttributeValue Parser::parseAttributeValue()
+std::string_view Parser::parseAttributeValue()
 {
     return parseBetweenDelimiters('\"');
 }
 
-LeafContent Parser::parseLeafContent()
+std::string_view Parser::parseLeafContent()
 {
     return parseUntil('<');
 }
 
-std::string Parser::parseName()
+bool Parser::nextElementIsSkipped(PathFilter::Node parent)
+{
+    if (parent == PathFilter::keepAll) return false;
+
+    // Anything other than an opening tag is left for parseOpeningTag() to report.
+    requireNotTruncated(cursor);
+    if (cursor == end || *cursor != '<') return false;
+
+    const char* nameEnd = Scan::findNameDelimiter(cursor + 1, end);
+    requireNotTruncated(nameEnd);
+    return filter.child(parent, {cursor + 1, static_cast<std::size_t>(nameEnd - (cursor + 1))}) == PathFilter::skipped;
+}
+
+void Parser::skipElement()
+{
+    skippedElementCount = 0;
+    continueSkippedElement();
+}
+
+// Scan to the end of the element being skipped, from the start of its opening tag or from within it.
+void Parser::continueSkippedElement()
+{
+    do
+    {
+        if (skippedElementCount != 0)
+        {
+            // The text before the next tag needs no further scanning, even if that tag has not yet arrived.
+            cursor = Scan::findChar(cursor, end, '<');
+            skipResumePosition = cursor;
+            requireNotTruncated(cursor);
+            require(cursor != end, "missing closing tag for", skippedElements[skippedElementCount - 1]);
+        }
+
+        if (tryParseString("</"))
+        {
+            const char* closingTagStart = cursor - 2;
+            if (! (nameNext() && parseName() == skippedElements[skippedElementCount - 1] && tryParseChar('>')))
+            {
+                cursor = closingTagStart;
+                fail("missing closing tag for", skippedElements[skippedElementCount - 1]);
+            }
+            --skippedElementCount;
+        }
+        else
+        {
+            require(tryParseChar('<') && nameNext(), "opening tag not started correctly");
+            std::string_view name = parseName();
+            const char* tagEnd = findTagEnd();
+            cursor = tagEnd + 1;
+            if (tagEnd[-1] != '/')
+            {
+                if (skippedElementCount == skippedElements.size()) skippedElements.emplace_back();
+                skippedElements[skippedElementCount++].assign(name);
+            }
+        }
+    }
+    while (skippedElementCount != 0);
+}
+
+// The '>' that ends the tag at the cursor, allowing for '>' within attribute values.
+const char* Parser::findTagEnd()
+{
+    const char* tagEnd = Scan::findChar(cursor, end, '>');
+    const char* quote = Scan::findChar(cursor, tagEnd, '\"');
+    while (quote != tagEnd)
+    {
+        const char* closingQuote = Scan::findChar(quote + 1, end, '\"');
+        requireNotTruncated(closingQuote);
+        require(closingQuote != end, "missing closing delimiter", "\"");
+        tagEnd = Scan::findChar(closingQuote + 1, end, '>');
+        quote = Scan::findChar(closingQuote + 1, tagEnd, '\"');
+    }
+    requireNotTruncated(tagEnd);
+    require(tagEnd != end, "opening tag not terminated correctly");
+    return tagEnd;
+}
+
+std::string_view Parser::parseName()
 {
     assert (nameNext());
-    return parseUntilAnyOf(nameDelimiters);
+    const char* start = cursor;
+    cursor = Scan::findNameDelimiter(cursor, end);
+    requireNotTruncated(cursor);
+    return {start, static_cast<std::size_t>(cursor - start)};
 }
 
 void Parser::parseWhitespace()
 {
-    parseWhileAnyOf(whitespaceChars);
+    cursor = Scan::skipWhitespace(cursor, end);
+    requireNotTruncated(cursor);
 }
 
 bool Parser::tryParseChar(char charToMatch)
 {
-    if (xmlSource.get() == charToMatch)
+    requireNotTruncated(cursor);
+    if (cursor != end && *cursor == charToMatch)
     {
+        ++cursor;
         return true;
     }
     else
     {
-        xmlSource.unget();
         return false;
     }
 }
 
-bool Parser::tryParseString(std::string stringToMatch)
+bool Parser::tryParseString(std::string_view stringToMatch)
 {
-    for (std::string::const_iterator it = stringToMatch.begin(); it != stringToMatch.end(); ++it)
+    requireNotTruncated(stringToMatch);
+    if (std::string_view(cursor, end - cursor).starts_with(stringToMatch))
     {
-        if (xmlSource.get() != *it)
-        {
-             // Rewind the XML stream back to the start of the string.
-             for (; it != std::prev(stringToMatch.begin()); --it)
-             {
-                 xmlSource.unget();
-             }
-             return false;
-        }
+        cursor += stringToMatch.size();
+        return true;
+    }
+    else
+    {
+        return false;
     }
-    return true;
 }
 
-std::string Parser::parseBetweenDelimiters(char delimiter)
+std::string_view Parser::parseBetweenDelimiters(char delimiter)
 {
-    const std::string delimiterAsText = std::string(1,delimiter) + " delimiter.";
+    const std::string_view delimiterAsText {&delimiter, 1};
 
-    require(tryParseChar('\"'), "missing opening " + delimiterAsText);
+    require(tryParseChar('\"'), "missing opening delimiter", delimiterAsText);
 
-    std::string xmlBetweenDelimiters;
-    std::getline(xmlSource, xmlBetweenDelimiters, delimiter);
-    require(! xmlSource.eof(), "missing closing " + delimiterAsText);
+    const char* closingDelimiter = Scan::findChar(cursor, end, delimiter);
+    requireNotTruncated(closingDelimiter);
+    require(closingDelimiter != end, "missing closing delimiter", delimiterAsText);
 
+    std::string_view xmlBetweenDelimiters {cursor, static_cast<std::size_t>(closingDelimiter - cursor)};
+    cursor = closingDelimiter + 1;
     return xmlBetweenDelimiters;
 }
 
-std::string Parser::parseUntil(char delimiter)
+std::string_view Parser::parseUntil(char delimiter)
 {
-    std::string xmlUptoDelimiter;
-    std::getline(xmlSource, xmlUptoDelimiter, delimiter);
-    xmlSource.unget(); // The delimiter or end-of-file character.
+    const char* delimiterPosition = Scan::findChar(cursor, end, delimiter);
+    requireNotTruncated(delimiterPosition);
+
+    std::string_view xmlUptoDelimiter {cursor, static_cast<std::size_t>(delimiterPosition - cursor)};
+    cursor = delimiterPosition; // The delimiter is not consumed.
     return xmlUptoDelimiter;
 }
 
-std::string Parser::parseUntilAnyOf(std::set<char> delimiters)
+bool Parser::nameNext()
 {
-    std::ostringstream parsedText;
-    while (! delimiters.contains(xmlSource.peek()))
-    {
-        parsedText << char(xmlSource.get());
-    }
-    return parsedText.str();
+    requireNotTruncated(cursor);
+    return cursor != end && isalpha(static_cast<unsigned char>(*cursor));
 }
 
-std::string Parser::parseWhileAnyOf(std::set<char> validChars)
+bool Parser::closingTagNext()
 {
-    std::ostringstream parsedText;
-    for (char nextChar = xmlSource.peek(); validChars.contains(nextChar); nextChar = xmlSource.peek())
-    {
-        parsedText << xmlSource.get();
-    }
-    return parsedText.str();
+    requireNotTruncated("</");
+    return std::string_view(cursor, end - cursor).starts_with("</");
 }
 
-bool Parser::nameNext()
+void Parser::requireNotTruncated(const char* position)
 {
-    return isalpha(xmlSource.peek());
+    if (position == end && ! inputIsComplete) throw IncompleteInput{};
 }
 
-bool Parser::closingTagNext()
+void Parser::requireNotTruncated(std::string_view expected)
 {
-    if (tryParseString("</"))
-    {
-        xmlSource.unget();
-        xmlSource.unget();
-        return true;
-    }
-    return false;
+    // Only the start of the expected text has arrived; the rest may be in the next chunk.
+    const std::string_view remaining {cursor, static_cast<std::size_t>(end - cursor)};
+    if (remaining.size() < expected.size() && expected.starts_with(remaining) && ! inputIsComplete) throw IncompleteInput{};
+}
+
+void Parser::require(bool condition, const char* problem, std::string_view detail)
+{
+    if (! condition) fail(problem, detail);
+}
+
+void Parser::fail(const char* problem, std::string_view detail)
+{
+    std::string message = problem;
+    if (! detail.empty()) message += " '" + std::string{detail} + "'";
+
+    std::string elementPath;
+    auto appendToPath = [&elementPath](std::string_view name) {
+        if (! elementPath.empty()) elementPath += '/';
+        elementPath += name;
+    };
+    std::for_each(openElements.begin(), openElements.begin() + openElementCount, appendToPath);
+    std::for_each(skippedElements.begin(), skippedElements.begin() + skippedElementCount, appendToPath);
+
+    const TextPosition position = positionOf(cursor);
+    throw ParseError(message, position.offset, position.line, position.column, std::move(elementPath));
+}
+
+Parser::TextPosition Parser::positionOf(const char* position) const
+{
+    const std::string_view passedText {textStart, static_cast<std::size_t>(position - textStart)};
+    const std::size_t newlines = std::count(passedText.begin(), passedText.end(), '\n');
+    return {textStartPosition.offset + passedText.size(),
+            textStartPosition.line + newlines,
+            newlines == 0 ? textStartPosition.column + passedText.size() : passedText.size() - passedText.rfind('\n')};
 }
 
-void Parser::require(bool condition, std::string errorMessage)
+void Parser::moveTextStart(const char* position)
 {
-    if (! condition) throw std::domain_error("Malformed XML: " + errorMessage);
+    textStartPosition = positionOf(position);
+    textStart = position;
 }
 
 }
@@ -0,0 +1,53 @@
+#include "xml-path-filter.h"
+
+namespace XML
+{
+
+PathFilter::PathFilter(std::initializer_list<std::string_view> paths)
+    : entries{Entry{}}
+{
+    for (std::string_view path : paths)
+    {
+        Node node = 0;
+        while (! path.empty())
+        {
+            const std::size_t separator = path.find('/');
+            const std::string_view name = path.substr(0, separator);
+            path = separator == std::string_view::npos ? std::string_view{} : path.substr(separator + 1);
+
+            // Matched by name alone, so that a named path is not merged into a wildcard.
+            Node next = skipped;
+            for (Node existing : entries[node].children)
+            {
+                if (entries[existing].name == name) next = existing;
+            }
+            if (next == skipped)
+            {
+                next = entries.size();
+                entries.push_back({std::string{name}, {}});
+                entries[node].children.push_back(next);
+            }
+            node = next;
+        }
+    }
+}
+
+PathFilter::Node PathFilter::root() const
+{
+    return entries.empty() ? keepAll : 0;
+}
+
+PathFilter::Node PathFilter::child(Node parent, std::string_view name) const
+{
+    if (parent == keepAll || parent == skipped) return parent;
+
+    Node wildcard = skipped;
+    for (Node node : entries[parent].children)
+    {
+        if (entries[node].name == name) return node;
+        if (entries[node].name == "*") wildcard = node;
+    }
+    return wildcard;
+}
+
+}
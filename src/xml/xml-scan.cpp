@@ -0,0 +1,196 @@
+#include <array>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define XML_SCAN_X86_64
+#endif
+
+#include "xml-scan.h"
+
+namespace XML::Scan
+{
+
+namespace
+{
+  enum CharClass : unsigned char { Whitespace = 1, NameDelimiter = 2 };
+
+  constexpr std::array<unsigned char, 256> charClasses = []{
+      std::array<unsigned char, 256> classes {};
+      for (unsigned char c : {' ','\t','\n','\v','\f','\r'}) classes[c] = Whitespace | NameDelimiter;
+      for (unsigned char c : {'/','>','='}) classes[c] = NameDelimiter;
+      return classes;
+  }();
+
+  bool hasClass(char c, CharClass charClass)
+  {
+      return charClasses[static_cast<unsigned char>(c)] & charClass;
+  }
+
+  const char* scalarFindNameDelimiter(const char* begin, const char* end)
+  {
+      while (begin != end && ! hasClass(*begin, NameDelimiter)) ++begin;
+      return begin;
+  }
+
+  const char* scalarFindChar(const char* begin, const char* end, char target)
+  {
+      while (begin != end && *begin != target) ++begin;
+      return begin;
+  }
+
+  const char* scalarSkipWhitespace(const char* begin, const char* end)
+  {
+      while (begin != end && hasClass(*begin, Whitespace)) ++begin;
+      return begin;
+  }
+
+#ifdef XML_SCAN_X86_64
+  /* \t, \n, \v, \f and \r are the contiguous range 0x09-0x0D.  Signed comparisons are safe
+   * because bytes >= 0x80 compare as negative, i.e. below the range.
+   */
+  __m128i whitespaceMask(__m128i chars)
+  {
+      const __m128i inControlRange = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('\t' - 1)),
+                                                   _mm_cmplt_epi8(chars, _mm_set1_epi8('\r' + 1)));
+      return _mm_or_si128(inControlRange, _mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')));
+  }
+
+  __m128i nameDelimiterMask(__m128i chars)
+  {
+      const __m128i punctuation = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('/')),
+                                                            _mm_cmpeq_epi8(chars, _mm_set1_epi8('>'))),
+                                               _mm_cmpeq_epi8(chars, _mm_set1_epi8('=')));
+      return _mm_or_si128(whitespaceMask(chars), punctuation);
+  }
+
+  __m128i load16(const char* p)
+  {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+
+  const char* sse2FindNameDelimiter(const char* begin, const char* end)
+  {
+      for (; end - begin >= 16; begin += 16)
+      {
+          const int found = _mm_movemask_epi8(nameDelimiterMask(load16(begin)));
+          if (found != 0) return begin + __builtin_ctz(found);
+      }
+      return scalarFindNameDelimiter(begin, end);
+  }
+
+  const char* sse2FindChar(const char* begin, const char* end, char target)
+  {
+      const __m128i targets = _mm_set1_epi8(target);
+      for (; end - begin >= 16; begin += 16)
+      {
+          const int found = _mm_movemask_epi8(_mm_cmpeq_epi8(load16(begin), targets));
+          if (found != 0) return begin + __builtin_ctz(found);
+      }
+      return scalarFindChar(begin, end, target);
+  }
+
+  const char* sse2SkipWhitespace(const char* begin, const char* end)
+  {
+      for (; end - begin >= 16; begin += 16)
+      {
+          const int notWhitespace = ~_mm_movemask_epi8(whitespaceMask(load16(begin))) & 0xFFFF;
+          if (notWhitespace != 0) return begin + __builtin_ctz(notWhitespace);
+      }
+      return scalarSkipWhitespace(begin, end);
+  }
+
+  __attribute__((target("avx2")))
+  __m256i whitespaceMask(__m256i chars)
+  {
+      const __m256i inControlRange = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('\t' - 1)),
+                                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), chars));
+      return _mm256_or_si256(inControlRange, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')));
+  }
+
+  __attribute__((target("avx2")))
+  __m256i nameDelimiterMask(__m256i chars)
+  {
+      const __m256i punctuation = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/')),
+                                                                  _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('>'))),
+                                                  _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('=')));
+      return _mm256_or_si256(whitespaceMask(chars), punctuation);
+  }
+
+  __attribute__((target("avx2")))
+  __m256i load32(const char* p)
+  {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+
+  __attribute__((target("avx2")))
+  const char* avx2FindNameDelimiter(const char* begin, const char* end)
+  {
+      for (; end - begin >= 32; begin += 32)
+      {
+          const unsigned int found = _mm256_movemask_epi8(nameDelimiterMask(load32(begin)));
+          if (found != 0) return begin + __builtin_ctz(found);
+      }
+      return sse2FindNameDelimiter(begin, end);
+  }
+
+  __attribute__((target("avx2")))
+  const char* avx2FindChar(const char* begin, const char* end, char target)
+  {
+      const __m256i targets = _mm256_set1_epi8(target);
+      for (; end - begin >= 32; begin += 32)
+      {
+          const unsigned int found = _mm256_movemask_epi8(_mm256_cmpeq_epi8(load32(begin), targets));
+          if (found != 0) return begin + __builtin_ctz(found);
+      }
+      return sse2FindChar(begin, end, target);
+  }
+
+  __attribute__((target("avx2")))
+  const char* avx2SkipWhitespace(const char* begin, const char* end)
+  {
+      for (; end - begin >= 32; begin += 32)
+      {
+          const unsigned int notWhitespace = ~static_cast<unsigned int>(_mm256_movemask_epi8(whitespaceMask(load32(begin))));
+          if (notWhitespace != 0) return begin + __builtin_ctz(notWhitespace);
+      }
+      return sse2SkipWhitespace(begin, end);
+  }
+#endif
+
+  const Scanner scalarScanner {"scalar", scalarFindNameDelimiter, scalarFindChar, scalarSkipWhitespace};
+#ifdef XML_SCAN_X86_64
+  const Scanner sse2Scanner {"sse2", sse2FindNameDelimiter, sse2FindChar, sse2SkipWhitespace};
+  const Scanner avx2Scanner {"avx2", avx2FindNameDelimiter, avx2FindChar, avx2SkipWhitespace};
+#endif
+}
+
+bool isWhitespace(char c)
+{
+    return hasClass(c, Whitespace);
+}
+
+bool isNameDelimiter(char c)
+{
+    return hasClass(c, NameDelimiter);
+}
+
+std::vector<Scanner> availableScanners()
+{
+    std::vector<Scanner> scanners {scalarScanner};
+#ifdef XML_SCAN_X86_64
+    scanners.push_back(sse2Scanner); // SSE2 is part of the x86-64 baseline.
+    if (__builtin_cpu_supports("avx2"))
+    {
+        scanners.push_back(avx2Scanner);
+    }
+#endif
+    return scanners;
+}
+
+const Scanner& selectedScanner()
+{
+    static const Scanner widestScanner = availableScanners().back();
+    return widestScanner;
+}
+
+}
@@ -0,0 +1,91 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "gpx-batch-parser.h"
+#include "thread-pool.h"
+
+
+BOOST_AUTO_TEST_SUITE(GPXBatchParserTests)
+
+std::string trackOf(int pointCount)
+{
+    std::string gpx = "<gpx><trk><trkseg>";
+    for (int i = 0; i < pointCount; ++i)
+    {
+        gpx += "<trkpt lat=\"" + std::to_string(pointCount) + "\" lon=\"" + std::to_string(i) + "\"><time>2000-01-01T00:00:10Z</time></trkpt>";
+    }
+    return gpx + "</trkseg></trk></gpx>";
+}
+
+BOOST_AUTO_TEST_CASE(ResultsInDocumentOrder){
+    std::vector<std::string> gpxTexts;
+    for (int i = 1; i <= 40; ++i)
+    {
+        gpxTexts.push_back(i % 10 == 0 ? "<gpx><trk/></gpx>" : trackOf(i));
+    }
+    const std::vector<std::string_view> gpxViews (gpxTexts.begin(), gpxTexts.end());
+
+    GPS::ThreadPool pool {4};
+    GPS::GPX::BatchCounters counters;
+    const std::vector<GPS::GPX::BatchResult> results = GPS::GPX::parseTrackStrings(gpxViews, pool, {}, &counters);
+
+    // Ensure each document has its own points, or error, and that the counters include every document
+    BOOST_REQUIRE_EQUAL(results.size(), 40u);
+    for (int i = 1; i <= 40; ++i)
+    {
+        const GPS::GPX::BatchResult& result = results[i - 1];
+        if (i % 10 == 0)
+        {
+            BOOST_CHECK(! result.succeeded());
+            BOOST_CHECK_THROW(std::rethrow_exception(result.error), std::domain_error);
+        }
+        else
+        {
+            BOOST_REQUIRE(result.succeeded());
+            BOOST_REQUIRE_EQUAL(result.trackPoints.size(), static_cast<std::size_t>(i));
+            BOOST_CHECK_EQUAL(result.trackPoints.front().waypoint.latitude(), i);
+        }
+    }
+    BOOST_CHECK_EQUAL(counters.documents(), 40u);
+    BOOST_CHECK_EQUAL(counters.failedDocuments(), 4u);
+    std::size_t totalBytes = 0;
+    for (const std::string& gpx : gpxTexts) totalBytes += gpx.size();
+    BOOST_CHECK_EQUAL(counters.bytes(), totalBytes);
+}
+
+BOOST_AUTO_TEST_CASE(LimitsStillParseEveryDocument){
+    const std::vector<std::string> gpxTexts (12, trackOf(5));
+    const std::vector<std::string_view> gpxViews (gpxTexts.begin(), gpxTexts.end());
+    GPS::ThreadPool pool {3};
+
+    // Ensure one document at a time, or a byte limit smaller than any document, still parses them all
+    for (const GPS::GPX::BatchLimits limits : {GPS::GPX::BatchLimits {1, std::size_t {1} << 30}, GPS::GPX::BatchLimits {0, 10}})
+    {
+        const std::vector<GPS::GPX::BatchResult> results = GPS::GPX::parseTrackStrings(gpxViews, pool, limits);
+        BOOST_REQUIRE_EQUAL(results.size(), 12u);
+        for (const GPS::GPX::BatchResult& result : results)
+        {
+            BOOST_CHECK_EQUAL(result.trackPoints.size(), 5u);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Files){
+    GPS::ThreadPool pool {2};
+    const std::vector<GPS::GPX::BatchResult> results =
+        GPS::GPX::parseTrackFiles({"data/NorthYorkMoors.gpx", "data/missing.gpx", "data/NorthYorkMoors.gpx"}, pool);
+
+    // Ensure files are parsed as parseTrackFile() would, and a missing file only fails its own result
+    BOOST_REQUIRE_EQUAL(results.size(), 3u);
+    BOOST_REQUIRE_EQUAL(results[0].trackPoints.size(), 1091u);
+    BOOST_CHECK_CLOSE(results[0].trackPoints.front().waypoint.latitude(), 54.42204773426058, 1e-12);
+    BOOST_CHECK_THROW(std::rethrow_exception(results[1].error), std::system_error);
+    BOOST_CHECK_EQUAL(results[2].trackPoints.size(), 1091u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gpx-date-time.h"
+
+
+BOOST_AUTO_TEST_SUITE(GPXDateTimeTests)
+
+BOOST_AUTO_TEST_CASE(SecondsSinceEpoch){
+    // Ensure UTC stamps decode to the Unix time, regardless of the local time zone
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("1970-01-01T00:00:00Z"), 0);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("2000-01-01T00:00:10Z"), 946684810);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("2001-02-12T02:20:15Z"), 981944415);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("2024-02-29T23:59:59Z"), 1709251199);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("1969-12-31T23:59:59Z"), -1);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("2038-01-19T03:14:08Z"), 2147483648);
+}
+
+BOOST_AUTO_TEST_CASE(DesignatorsAndFractions){
+    // Ensure offsets are subtracted, a missing designator means UTC, and fractions are discarded
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("2000-01-01T01:00:10+01:00"), 946684810);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("1999-12-31T19:30:10-0430"), 946684810);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("2000-01-01T00:00:10"), 946684810);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("2000-01-01T00:00:10.999Z"), 946684810);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime("\n  2000-01-01T00:00:10Z \n"), 946684810);
+}
+
+BOOST_AUTO_TEST_CASE(Microseconds){
+    GPS::GPX::DateTimeDecoder decoder;
+
+    // Ensure fractions are kept to the microsecond, including before 1970, and further digits are dropped
+    BOOST_CHECK_EQUAL(decoder.decodeMicroseconds("2000-01-01T00:00:10Z"), 946684810'000'000);
+    BOOST_CHECK_EQUAL(decoder.decodeMicroseconds("2000-01-01T00:00:10.25Z"), 946684810'250'000);
+    BOOST_CHECK_EQUAL(decoder.decodeMicroseconds("2000-01-01T01:00:10.000001+01:00"), 946684810'000'001);
+    BOOST_CHECK_EQUAL(decoder.decodeMicroseconds("2000-01-01T00:00:10.12345678Z"), 946684810'123'456);
+    BOOST_CHECK_EQUAL(decoder.decodeMicroseconds("1969-12-31T23:59:59.5Z"), -500'000);
+    BOOST_CHECK_EQUAL(decoder.decode("1969-12-31T23:59:59.5Z"), -1);
+}
+
+BOOST_AUTO_TEST_CASE(MalformedStamps){
+    const std::vector<std::string> malformed = {
+        "", "yesterday", "2000-01-01", "2000-01-01 00:00:10Z", "2000-1-01T00:00:10Z",
+        "2000-13-01T00:00:10Z", "2001-02-29T00:00:10Z", "2000-01-01T24:00:00Z", "2000-01-01T00:60:00Z",
+        "2000-01-01T00:00:10.Z", "2000-01-01T00:00:10ZZ", "2000-01-01T00:00:10+1", "2000-01-01T00:00:10+01:0",
+    };
+
+    // Ensure each malformed stamp is rejected
+    for (const std::string& dateTime : malformed)
+    {
+        BOOST_CHECK_THROW(GPS::GPX::parseDateTime(dateTime), std::domain_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CachedDate){
+    GPS::GPX::DateTimeDecoder decoder;
+
+    // Ensure a decoder gives the same results when consecutive stamps do, and do not, share a date
+    BOOST_CHECK_EQUAL(decoder.decode("2000-01-01T00:00:10Z"), 946684810);
+    BOOST_CHECK_EQUAL(decoder.decode("2000-01-01T00:00:11Z"), 946684811);
+    BOOST_CHECK_EQUAL(decoder.decode("2000-01-02T00:00:10Z"), 946684810 + 86400);
+    BOOST_CHECK_THROW(decoder.decode("2000-01-02T99:00:10Z"), std::domain_error);
+    BOOST_CHECK_THROW(decoder.decode("2000-02-30T00:00:10Z"), std::domain_error);
+    BOOST_CHECK_EQUAL(decoder.decode("2000-01-02T00:00:11Z"), 946684811 + 86400);
+    BOOST_CHECK_EQUAL(decoder.decode("2000-01-01T00:00:11Z"), 946684811);
+}
+
+BOOST_AUTO_TEST_CASE(Formatting){
+    const std::vector<std::time_t> times = {0, -1, 946684810, 951782400, 1709251199, -62167219200, 253402300799};
+
+    // Ensure times, including those before 1970, are written as UTC stamps that decode to the same time
+    char text[GPS::GPX::formattedDateTimeLength];
+    BOOST_CHECK_EQUAL(std::string(text, GPS::GPX::formatDateTime(946684810, text)), "2000-01-01T00:00:10Z");
+    BOOST_CHECK_EQUAL(std::string(text, GPS::GPX::formatDateTime(-1, text)), "1969-12-31T23:59:59Z");
+    BOOST_CHECK_EQUAL(std::string(text, GPS::GPX::formatDateTime(951782400, text)), "2000-02-29T00:00:00Z");
+    for (std::time_t time : times)
+    {
+        BOOST_CHECK_EQUAL(GPS::GPX::parseDateTime({text, GPS::GPX::formatDateTime(time, text)}), time);
+    }
+
+    // Ensure fractions of a second are written to the millisecond where that is exact, and otherwise to the microsecond
+    char timeStamp[GPS::GPX::maxFormattedTimeStampLength];
+    BOOST_CHECK_EQUAL(std::string(timeStamp, GPS::GPX::formatTimeStamp(946684810'000'000, timeStamp)), "2000-01-01T00:00:10Z");
+    BOOST_CHECK_EQUAL(std::string(timeStamp, GPS::GPX::formatTimeStamp(946684810'250'000, timeStamp)), "2000-01-01T00:00:10.250Z");
+    BOOST_CHECK_EQUAL(std::string(timeStamp, GPS::GPX::formatTimeStamp(-1, timeStamp)), "1969-12-31T23:59:59.999999Z");
+
+    // Ensure years outside 0000-9999 are rejected
+    BOOST_CHECK_THROW(GPS::GPX::formatDateTime(-62167219201, text), std::domain_error);
+    BOOST_CHECK_THROW(GPS::GPX::formatDateTime(253402300800, text), std::domain_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
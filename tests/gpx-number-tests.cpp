@@ -0,0 +1,60 @@
+#include <boost/test/unit_test.hpp>
+
+#include <clocale>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gpx-number.h"
+
+
+BOOST_AUTO_TEST_SUITE(GPXNumberTests)
+
+BOOST_AUTO_TEST_CASE(WellFormedNumbers){
+    // Ensure signs, fractions, exponents and surrounding whitespace are accepted
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber("309"), 309);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber("-8.5"), -8.5);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber("+8.5"), 8.5);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber(".5"), 0.5);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber("5."), 5);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber("-1.25e3"), -1250);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber("\n  54.5\t"), 54.5);
+}
+
+BOOST_AUTO_TEST_CASE(ExactRoundTrip){
+    const std::vector<std::string> digits = {"54.42204773426058", "-0.7285404205322266", "0.1", "1e-300", "179.99999999999997"};
+
+    // Ensure the results are correctly rounded, matching strtod in the "C" locale
+    for (const std::string& text : digits)
+    {
+        BOOST_CHECK_EQUAL(GPS::GPX::parseNumber(text), std::strtod(text.c_str(), nullptr));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LocaleIndependent){
+    const char* previousLocale = std::setlocale(LC_NUMERIC, nullptr);
+    const std::string savedLocale = previousLocale != nullptr ? previousLocale : "C";
+    const bool commaLocale = std::setlocale(LC_NUMERIC, "de_DE.UTF-8") != nullptr;
+
+    // Ensure a decimal comma locale, if available, changes nothing
+    BOOST_CHECK_EQUAL(GPS::GPX::parseNumber("54.5"), 54.5);
+    BOOST_CHECK_THROW(GPS::GPX::parseNumber("54,5"), std::domain_error);
+    if (commaLocale) std::setlocale(LC_NUMERIC, savedLocale.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(MalformedNumbers){
+    const std::vector<std::string> malformed = {
+        "", " ", "-", "+", "+-1", "--1", "1.2.3", "12abc", "1 2", "0x1p3", "inf", "-nan", "1e400", "e5",
+    };
+
+    // Ensure each malformed number is rejected
+    for (const std::string& text : malformed)
+    {
+        double value;
+        BOOST_CHECK_MESSAGE(! GPS::GPX::tryParseNumber(text, value), "'" << text << "' accepted");
+        BOOST_CHECK_THROW(GPS::GPX::parseNumber(text), std::domain_error);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "thread-pool.h"
+
+
+BOOST_AUTO_TEST_SUITE(GPXParallelParserTests)
+
+// A point whose time is i tenths of a second after midnight.
+std::string trkpt(int i)
+{
+    const auto twoDigits = [](int n) { return std::string {static_cast<char>('0' + n / 10), static_cast<char>('0' + n % 10)}; };
+    const int second = i / 10;
+    const std::string time = twoDigits(second / 3600 % 24) + ":" + twoDigits(second / 60 % 60) + ":" + twoDigits(second % 60) + "." + std::to_string(i % 10);
+    return "<trkpt lat=\"" + std::to_string(i % 90) + "\" lon=\"" + std::to_string(i % 180) + "\">"
+           "<ele>" + std::to_string(i % 1000) + "</ele><time>2000-01-01T" + time + "Z</time></trkpt>\n";
+}
+
+// A document large enough to be split, with several segments and some non-trkpt siblings.
+std::string largeGPX(const std::string& extraSegmentContent = "")
+{
+    std::string gpx = "<?xml version=\"1.0\"?>\n<gpx><trk><name>Large</name>\n";
+    int i = 0;
+    for (int segment = 0; segment < 4; ++segment)
+    {
+        gpx += "<trkseg>\n";
+        for (int point = 0; point < 5000; ++point)
+        {
+            gpx += trkpt(i++);
+            if (point == 2500) gpx += "<extensions><trkpt lat=\"99\" lon=\"0\"/></extensions>\n";
+            if (segment == 2 && point == 4000) gpx += extraSegmentContent;
+        }
+        gpx += "</trkseg>\n";
+    }
+    gpx += "</trk></gpx>\n";
+    return gpx;
+}
+
+// A 'trk' with points directly within it, around a short 'trkseg' (which overrides them).
+std::string directPointsGPX(bool segmentFirst)
+{
+    std::string segment = "<trkseg>\n";
+    for (int i = 0; i < (segmentFirst ? 1 : 3); ++i) segment += trkpt(100000 + i);
+    segment += "</trkseg>\n";
+
+    std::string gpx = "<?xml version=\"1.0\"?>\n<gpx><trk>\n";
+    if (segmentFirst) gpx += segment;
+    for (int i = 0; i < 20000; ++i) gpx += trkpt(i);
+    if (! segmentFirst) gpx += segment;
+    for (int i = 20000; i < 40000; ++i) gpx += trkpt(i);
+    gpx += "</trk></gpx>\n";
+    return gpx;
+}
+
+// Compare every field of every point with those from the sequential parser, for several numbers of threads.
+void checkSameAsSequential(const std::string& gpx)
+{
+    const std::vector<GPS::Trackpoint> expected = GPS::GPX::parseTrackString(gpx);
+    for (unsigned int threadCount : {1, 3, 4, 8})
+    {
+        GPS::ThreadPool pool {threadCount};
+        const std::vector<GPS::Trackpoint> trackPoints = GPS::GPX::parseTrackString(gpx, pool);
+        BOOST_REQUIRE_EQUAL(trackPoints.size(), expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(trackPoints[i].waypoint.latitude(), expected[i].waypoint.latitude());
+            BOOST_CHECK_EQUAL(trackPoints[i].waypoint.longitude(), expected[i].waypoint.longitude());
+            BOOST_CHECK_EQUAL(trackPoints[i].waypoint.altitude(), expected[i].waypoint.altitude());
+            BOOST_CHECK_EQUAL(trackPoints[i].timeStamp, expected[i].timeStamp);
+        }
+    }
+}
+
+std::string errorFrom(auto parse)
+{
+    try
+    {
+        parse();
+    }
+    catch (const std::exception& e)
+    {
+        return e.what();
+    }
+    return "no error";
+}
+
+
+BOOST_AUTO_TEST_CASE(SameAsSequential){
+    // Ensure the points match those of the sequential parser, whatever the number of threads
+    checkSameAsSequential(largeGPX());
+
+    // Ensure points directly within the 'trk' are overridden by a 'trkseg' before or among them,
+    // rather than taken in place of the segment's points
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(directPointsGPX(false)).size(), 3u);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(directPointsGPX(true)).size(), 1u);
+    checkSameAsSequential(directPointsGPX(false));
+    checkSameAsSequential(directPointsGPX(true));
+}
+
+BOOST_AUTO_TEST_CASE(SameErrorsAsSequential){
+    GPS::ThreadPool pool {4};
+    const std::vector<std::string> invalidGPX = {
+        largeGPX("<trkpt lat=\"1\" lon=\"2\"/>\n"),
+        largeGPX("<trkpt lat=\"100\" lon=\"2\"><time>2000-01-01T00:00:00Z</time></trkpt>\n"),
+        largeGPX("<trkpt lat=\"1\" lon=\"2\"><ele>1</ele></trkpt></trkseg>\n"),
+        largeGPX("<trkpt lat=\"1\" lon=\"2\"><ele>1<ele></trkpt>\n"),
+    };
+
+    // Ensure errors deep within a piece parsed by a worker are reported as the sequential parser reports them
+    for (const std::string& gpx : invalidGPX)
+    {
+        const std::string expectedError = errorFrom([&gpx]{ GPS::GPX::parseTrackString(gpx); });
+        BOOST_CHECK_NE(expectedError, "no error");
+        BOOST_CHECK_EQUAL(errorFrom([&]{ GPS::GPX::parseTrackString(gpx, pool); }), expectedError);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PoolReturnsResultsAndExceptions){
+    GPS::ThreadPool pool {2};
+    std::future<int> result = pool.submit([]{ return 42; });
+    std::future<void> failure = pool.submit([]{ throw std::runtime_error("failed"); });
+
+    // Ensure task results and exceptions are passed back through the futures
+    BOOST_CHECK_EQUAL(result.get(), 42);
+    BOOST_CHECK_THROW(failure.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,158 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "gpx-parser.h"
+#include "gzip.h"
+
+
+BOOST_AUTO_TEST_SUITE(GPXParserTests)
+
+const std::string segmentedGPX =
+    "<?xml version=\"1.0\"?>\n"
+    "<gpx><trk>\n"
+    "  <trkseg>\n"
+    "    <trkpt lat=\"1\" lon=\"2\"><ele>3</ele><time>2000-01-01T00:00:10Z</time></trkpt>\n"
+    "    <trkpt lat=\"4\" lon=\"5\"><time>2000-01-01T00:00:20Z</time></trkpt>\n"
+    "  </trkseg>\n"
+    "  <trkseg>\n"
+    "    <trkpt lat=\"-6\" lon=\"-7\"><ele>-8.5</ele><time>2000-01-01T00:00:30Z</time></trkpt>\n"
+    "  </trkseg>\n"
+    "</trk></gpx>\n";
+
+
+BOOST_AUTO_TEST_CASE(SegmentsAreConcatenated){
+    std::vector<GPS::Trackpoint> trackPoints = GPS::GPX::parseTrackString(segmentedGPX);
+
+    // Ensure points from every segment are returned, in document order
+    BOOST_REQUIRE_EQUAL(trackPoints.size(), 3u);
+    BOOST_CHECK_EQUAL(trackPoints[0].waypoint.altitude(), 3);
+    BOOST_CHECK_EQUAL(trackPoints[1].waypoint.altitude(), 0);
+    BOOST_CHECK_EQUAL(trackPoints[2].waypoint.latitude(), -6);
+    BOOST_CHECK_EQUAL(trackPoints[2].waypoint.altitude(), -8.5);
+    BOOST_CHECK_EQUAL(trackPoints[2].timeStamp, 946684830 * GPS::microsecondsPerSecond);
+}
+
+BOOST_AUTO_TEST_CASE(PointsOutsideSegmentsIgnoredWhenSegmentsExist){
+    const std::string gpx = "<gpx><trk>"
+                            "<trkpt lat=\"9\" lon=\"9\"/>"
+                            "<trkseg><trkpt lat=\"1\" lon=\"2\"><time>2000-01-01T00:00:10Z</time></trkpt></trkseg>"
+                            "</trk></gpx>";
+
+    // Ensure a track with segments only takes points from its segments
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(gpx).size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(MissingElementsAndAttributes){
+    // Ensure each missing mandatory part is reported
+    BOOST_CHECK_THROW(GPS::GPX::parseTrackString("<kml><trk/></kml>"), std::domain_error);
+    BOOST_CHECK_THROW(GPS::GPX::parseTrackString("<gpx><rte/></gpx>"), std::domain_error);
+    BOOST_CHECK_THROW(GPS::GPX::parseTrackString("<gpx><trk><trkseg/></trk></gpx>"), std::domain_error);
+    BOOST_CHECK_THROW(GPS::GPX::parseTrackString("<gpx><trk><trkpt lon=\"1\"><time>2000-01-01T00:00:10Z</time></trkpt></trk></gpx>"), std::domain_error);
+    BOOST_CHECK_THROW(GPS::GPX::parseTrackString("<gpx><trk><trkpt lat=\"1\" lon=\"1\"/></trk></gpx>"), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(UnusedElementsIgnored){
+    const std::string gpx = "<gpx><metadata><link href=\"a>b\"><text>Link</text></link></metadata>"
+                            "<wpt lat=\"0\" lon=\"0\"><name>Start</name></wpt><rte><rtept lat=\"0\" lon=\"0\"/></rte>"
+                            "<trk><name>Run</name><trkseg>"
+                            "<trkpt lat=\"1\" lon=\"2\"><ele>3</ele><time>2000-01-01T00:00:10Z</time>"
+                            "<extensions><gpxtpx:TrackPointExtension><gpxtpx:hr>150</gpxtpx:hr></gpxtpx:TrackPointExtension></extensions></trkpt>"
+                            "</trkseg><extensions/></trk></gpx>";
+
+    std::vector<GPS::Trackpoint> trackPoints = GPS::GPX::parseTrackString(gpx);
+
+    // Ensure metadata, waypoints, routes and extensions do not affect the track
+    BOOST_REQUIRE_EQUAL(trackPoints.size(), 1u);
+    BOOST_CHECK_EQUAL(trackPoints[0].waypoint.altitude(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(SinkAndVectorOverloads){
+    std::vector<GPS::Trackpoint> trackPoints;
+    trackPoints.reserve(4);
+    trackPoints.push_back(GPS::GPX::parseTrackString(segmentedGPX).back());
+    GPS::GPX::parseTrackString(segmentedGPX, trackPoints);
+
+    std::vector<double> latitudes;
+    GPS::GPX::parseTrackString(segmentedGPX, [&latitudes](const GPS::Trackpoint& trackPoint) { latitudes.push_back(trackPoint.waypoint.latitude()); });
+
+    // Ensure points are appended to an existing vector, or passed to a sink, in document order
+    BOOST_REQUIRE_EQUAL(trackPoints.size(), 4u);
+    BOOST_CHECK_EQUAL(trackPoints[1].waypoint.latitude(), 1);
+    BOOST_CHECK_EQUAL(trackPoints[3].waypoint.latitude(), -6);
+    BOOST_REQUIRE_EQUAL(latitudes.size(), 3u);
+    BOOST_CHECK_EQUAL(latitudes[1], 4);
+}
+
+BOOST_AUTO_TEST_CASE(SensorExtensions){
+    const std::string gpx = "<gpx><trk><trkseg>"
+                            "<trkpt lat=\"1\" lon=\"2\"><time>2000-01-01T00:00:10Z</time>"
+                            "<extensions><gpxtpx:TrackPointExtension><gpxtpx:hr>150</gpxtpx:hr><gpxtpx:cad>80</gpxtpx:cad>"
+                            "<gpxtpx:atemp>12.5</gpxtpx:atemp></gpxtpx:TrackPointExtension><power>210</power></extensions></trkpt>"
+                            "<trkpt lat=\"3\" lon=\"4\"><time>2000-01-01T00:00:20Z</time></trkpt>"
+                            "<trkpt lat=\"5\" lon=\"6\"><time>2000-01-01T00:00:30Z</time>"
+                            "<extensions><gpxtpx:TrackPointExtension><gpxtpx:hr>x</gpxtpx:hr><gpxtpx:hr>155</gpxtpx:hr>"
+                            "</gpxtpx:TrackPointExtension></extensions></trkpt>"
+                            "</trkseg></trk></gpx>";
+    std::vector<GPS::Trackpoint> trackPoints;
+    GPS::SensorData sensors;
+    GPS::GPX::parseTrackString(gpx, trackPoints, sensors);
+
+    // Ensure readings are taken from either level of the extensions, for every point, in the same pass
+    BOOST_REQUIRE_EQUAL(trackPoints.size(), 3u);
+    BOOST_REQUIRE_EQUAL(sensors.size(), 3u);
+    BOOST_CHECK_EQUAL(sensors.channel(GPS::SensorChannel::Cadence)[0], 80);
+    BOOST_CHECK_EQUAL(sensors.channel(GPS::SensorChannel::Temperature)[0], 12.5);
+    BOOST_CHECK_EQUAL(sensors.channel(GPS::SensorChannel::Power)[0], 210);
+    BOOST_CHECK(std::isnan(sensors.channel(GPS::SensorChannel::Power)[1]));
+
+    // Ensure malformed readings are skipped in favour of the next one
+    BOOST_CHECK_EQUAL(sensors.channel(GPS::SensorChannel::HeartRate)[0], 150);
+    BOOST_CHECK(std::isnan(sensors.channel(GPS::SensorChannel::HeartRate)[1]));
+    BOOST_CHECK_EQUAL(sensors.channel(GPS::SensorChannel::HeartRate)[2], 155);
+
+    // Ensure points held back outside segments keep their readings, and compressed input is read the same way
+    GPS::SensorData directSensors;
+    trackPoints.clear();
+    GPS::GPX::parseTrackString("<gpx><trk><trkpt lat=\"1\" lon=\"2\"><time>2000-01-01T00:00:10Z</time>"
+                               "<extensions><heartrate>90</heartrate></extensions></trkpt></trk></gpx>", trackPoints, directSensors);
+    BOOST_REQUIRE_EQUAL(directSensors.size(), 1u);
+    BOOST_CHECK_EQUAL(directSensors.channel(GPS::SensorChannel::HeartRate)[0], 90);
+
+    std::ostringstream compressed;
+    GPS::GzipOutputStream gzip {compressed};
+    gzip << gpx;
+    gzip.close();
+    GPS::SensorData compressedSensors;
+    GPS::GPX::parseTrackString(compressed.str(), trackPoints, compressedSensors);
+    BOOST_CHECK_EQUAL(compressedSensors.channel(GPS::SensorChannel::Cadence).size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(CompressedInput){
+    std::ostringstream compressed;
+    GPS::GzipOutputStream gzip {compressed};
+    gzip << segmentedGPX;
+    gzip.close();
+    std::istringstream compressedStream {compressed.str()};
+    GPS::ThreadPool pool {2};
+
+    // Ensure gzip-compressed GPX is recognised and decompressed by each entry point
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(compressed.str()).size(), 3u);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackStream(compressedStream).size(), 3u);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(compressed.str(), pool).size(), 3u);
+    BOOST_CHECK_THROW(GPS::GPX::parseTrackString(compressed.str().substr(0, 40)), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(SampleFile){
+    std::vector<GPS::Trackpoint> trackPoints = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+
+    // Ensure the sample track is read in full
+    BOOST_REQUIRE_EQUAL(trackPoints.size(), 1091u);
+    BOOST_CHECK_CLOSE(trackPoints.front().waypoint.latitude(), 54.42204773426058, 1e-12);
+    BOOST_CHECK_EQUAL(trackPoints.front().waypoint.altitude(), 309);
+    BOOST_CHECK_EQUAL(trackPoints.front().timeStamp, 946684810 * GPS::microsecondsPerSecond);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
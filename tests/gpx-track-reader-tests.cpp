@@ -0,0 +1,126 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "gpx-track-reader.h"
+
+
+BOOST_AUTO_TEST_SUITE(GPXTrackReaderTests)
+
+std::vector<GPS::Trackpoint> parseInChunks(const std::string& gpx, std::size_t chunkSize)
+{
+    std::vector<GPS::Trackpoint> trackPoints;
+    GPS::GPX::IncrementalTrackParser parser {[&trackPoints](const GPS::Trackpoint& trackPoint) { trackPoints.push_back(trackPoint); }};
+    for (std::size_t start = 0; start < gpx.size(); start += chunkSize)
+    {
+        parser.feed(gpx.data() + start, std::min(chunkSize, gpx.size() - start));
+    }
+    parser.finish();
+    return trackPoints;
+}
+
+std::string errorFrom(auto parse)
+{
+    try
+    {
+        parse();
+    }
+    catch (const std::exception& e)
+    {
+        return e.what();
+    }
+    return "no error";
+}
+
+
+BOOST_AUTO_TEST_CASE(SampleFileInChunks){
+    std::ifstream sampleFile {"data/NorthYorkMoors.gpx"};
+    const std::string gpx {std::istreambuf_iterator<char>(sampleFile), {}};
+    const std::vector<GPS::Trackpoint> expected = GPS::GPX::parseTrackString(gpx);
+
+    // Ensure the incremental parser produces the same points as the tree parser, however the input is split
+    for (std::size_t chunkSize : {1, 7, 4096, 1 << 20})
+    {
+        std::vector<GPS::Trackpoint> trackPoints = parseInChunks(gpx, chunkSize);
+        BOOST_REQUIRE_EQUAL(trackPoints.size(), expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(trackPoints[i].waypoint.latitude(), expected[i].waypoint.latitude());
+            BOOST_CHECK_EQUAL(trackPoints[i].waypoint.longitude(), expected[i].waypoint.longitude());
+            BOOST_CHECK_EQUAL(trackPoints[i].waypoint.altitude(), expected[i].waypoint.altitude());
+            BOOST_CHECK_EQUAL(trackPoints[i].timeStamp, expected[i].timeStamp);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SameSelectionAsTheTreeParser){
+    const std::string gpx = "<gpx><trk>"
+                            "<trkpt lat=\"9\" lon=\"9\"><time>2000-01-01T00:00:00Z</time></trkpt>"
+                            "<trkseg><trkpt lat=\"1\" lon=\"2\" lat=\"3\"><ele>4</ele><ele>5</ele><time>2000-01-01T00:00:10Z</time></trkpt></trkseg>"
+                            "<trkseg><trkpt lat=\"6\" lon=\"7\"><extensions><ele>8</ele></extensions><time>2000-01-01T00:00:20Z</time></trkpt></trkseg>"
+                            "</trk><trk><trkseg><trkpt lat=\"0\" lon=\"0\"><time>2000-01-01T00:00:30Z</time></trkpt></trkseg></trk></gpx>";
+
+    std::vector<GPS::Trackpoint> trackPoints = parseInChunks(gpx, 5);
+
+    // Ensure only segment points of the first track are used, with the last duplicate attribute and first 'ele'
+    BOOST_REQUIRE_EQUAL(trackPoints.size(), 2u);
+    BOOST_CHECK_EQUAL(trackPoints[0].waypoint.latitude(), 3);
+    BOOST_CHECK_EQUAL(trackPoints[0].waypoint.altitude(), 4);
+    BOOST_CHECK_EQUAL(trackPoints[1].waypoint.latitude(), 6);
+    BOOST_CHECK_EQUAL(trackPoints[1].waypoint.altitude(), 0);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(gpx).size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(SegmentContentsFilterSkipsExtensions){
+    const std::string contents = "<trkpt lat=\"1\" lon=\"2\"><ele>3</ele><extensions><hr>150</hr></extensions>"
+                                 "<time>2000-01-01T00:00:00Z</time></trkpt><trkpt lat=\"4\" lon=\"5\"/></trkseg>";
+    XML::Parser parser = XML::Parser::forElementSequence(contents);
+    parser.setFilter(GPS::GPX::TrackReader::segmentContentsFilter());
+
+    std::vector<std::string> names;
+    for (XML::Event event = parser.nextEvent(); event.type != XML::Event::Type::EndOfDocument; event = parser.nextEvent())
+    {
+        if (event.type == XML::Event::Type::StartElement) names.emplace_back(event.name);
+    }
+
+    // Ensure the points and the elements they are read from are kept, and their extensions skipped
+    const std::vector<std::string> expectedNames = {"trkpt", "ele", "time", "trkpt"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), expectedNames.begin(), expectedNames.end());
+}
+
+BOOST_AUTO_TEST_CASE(FirstErrorInDocumentOrder){
+    const std::vector<std::pair<std::string, std::string>> invalidTracks = {
+        {"<kml><trk/></kml>", "Missing 'gpx' element."},
+        {"<gpx><rte/></gpx>", "Missing 'trk' element."},
+        {"<gpx><trk><trkseg/></trk></gpx>", "Missing 'trkpt' element."},
+        {"<gpx><trk><name/></trk></gpx>", "Missing 'trkpt' element."},
+        {"<gpx><trk><trkpt lon=\"1\"><time>2000-01-01T00:00:10Z</time></trkpt></trk></gpx>", "Missing 'lat' attribute."},
+        {"<gpx><trk><trkpt lat=\"1\" lon=\"1\"/></trk></gpx>", "Missing 'time' element."},
+        {"<gpx><trk><trkseg><trkpt lat=\"1\" lon=\"1,5\"><time>2000-01-01T00:00:10Z</time></trkpt></trkseg></trk></gpx>",
+         "Malformed number content: 1,5"},
+        {"<gpx><trk><trkseg><trkpt lat=\"1\" lon=\"1\"><ele/><time>2000-01-01T00:00:10Z</time></trkpt></trkseg></trk></gpx>",
+         "Malformed number content: "},
+        {"<gpx><trk><trkseg><trkpt lat=\"91\" lon=\"1\"><time>2000-01-01T00:00:10Z</time></trkpt></trkseg></trk></gpx>",
+         "Latitude values must not exceed 90.000000 degrees."},
+        {"<gpx><trk><trkseg><trkpt lat=\"1\" lon=\"1\"><time>yesterday</time></trkpt></trkseg><trkseg/></trk></gpx>",
+         "Malformed date/time content: yesterday"},
+        {"<gpx><trk><trkseg><trkpt lat=\"1\" lon=\"1\"><time>2000-01-01T00:00:10Z</time></trkpt></trkseg><trkseg/></trk></gpx>",
+         "Missing 'trkpt' element."},
+    };
+
+    // Ensure each invalid track is rejected with its first error, whether parsed whole or in chunks
+    for (const auto& [gpx, expectedError] : invalidTracks)
+    {
+        BOOST_CHECK_EQUAL(errorFrom([&gpx]{ parseInChunks(gpx, 3); }), expectedError);
+        BOOST_CHECK_EQUAL(errorFrom([&gpx]{ GPS::GPX::parseTrackString(gpx); }), expectedError);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
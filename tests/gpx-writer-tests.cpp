@@ -0,0 +1,98 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "gpx-writer.h"
+#include "track.h"
+
+
+BOOST_AUTO_TEST_SUITE(GPXWriterTests)
+
+BOOST_AUTO_TEST_CASE(DocumentLayout){
+    const std::vector<GPS::Trackpoint> trackPoints = {{GPS::Waypoint {54.5, -0.25, 309}, 946684810'000'000}, {GPS::Waypoint {-1, 2, -8.5}, 946684820'250'000}};
+    const std::vector<std::size_t> segmentStarts = {1};
+
+    // Ensure the document is laid out as expected, with shortest numbers, UTC times (with any fraction) and escaped names
+    BOOST_CHECK_EQUAL(GPS::GPX::writeTrackString(trackPoints, {"Fish & <Chips>"}, segmentStarts),
+                      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                      "<gpx version=\"1.1\" creator=\"GPS\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+                      "  <trk>\n"
+                      "    <name>Fish &amp; &lt;Chips&gt;</name>\n"
+                      "    <trkseg>\n"
+                      "      <trkpt lat=\"54.5\" lon=\"-0.25\"><ele>309</ele><time>2000-01-01T00:00:10Z</time></trkpt>\n"
+                      "    </trkseg>\n"
+                      "    <trkseg>\n"
+                      "      <trkpt lat=\"-1\" lon=\"2\"><ele>-8.5</ele><time>2000-01-01T00:00:20.250Z</time></trkpt>\n"
+                      "    </trkseg>\n"
+                      "  </trk>\n"
+                      "</gpx>\n");
+}
+
+BOOST_AUTO_TEST_CASE(SampleRoundTrip){
+    const std::vector<GPS::Trackpoint> original = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const std::vector<std::size_t> segmentStarts = {100, 500};
+    const std::string written = GPS::GPX::writeTrackString(original, {}, segmentStarts);
+    const std::vector<GPS::Trackpoint> reread = GPS::GPX::parseTrackString(written);
+
+    // Ensure the parser reads back exactly the points written, and writing them again gives the same bytes
+    BOOST_REQUIRE_EQUAL(reread.size(), original.size());
+    for (std::size_t i = 0; i < original.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(reread[i].waypoint.latitude(), original[i].waypoint.latitude());
+        BOOST_CHECK_EQUAL(reread[i].waypoint.longitude(), original[i].waypoint.longitude());
+        BOOST_CHECK_EQUAL(reread[i].waypoint.altitude(), original[i].waypoint.altitude());
+        BOOST_CHECK_EQUAL(reread[i].timeStamp, original[i].timeStamp);
+    }
+    BOOST_CHECK_EQUAL(GPS::GPX::writeTrackString(reread, {}, segmentStarts), written);
+}
+
+BOOST_AUTO_TEST_CASE(StreamsAndTracks){
+    const std::vector<GPS::Trackpoint> trackPoints (5000, {GPS::Waypoint {54.42204773426058, -0.7285404205322266, 0.1}, 0});
+    std::ostringstream trackStream, pointStream;
+    GPS::GPX::writeTrack(trackStream, GPS::Track {trackPoints});
+    GPS::GPX::writeTrack(pointStream, trackPoints);
+
+    // Ensure a Track, and output larger than one chunk, are written the same way to a stream
+    BOOST_CHECK_GT(trackStream.str().size(), 100'000u);
+    BOOST_CHECK_EQUAL(trackStream.str(), GPS::GPX::writeTrackString(trackPoints));
+    BOOST_CHECK_EQUAL(pointStream.str(), trackStream.str());
+}
+
+BOOST_AUTO_TEST_CASE(StreamingWriter){
+    std::string gpx;
+    GPS::GPX::TrackWriter writer {gpx};
+    writer.startSegment();
+    writer.write({GPS::Waypoint {1, 2, 3}, 10});
+    BOOST_CHECK_THROW(writer.write({GPS::Waypoint {1, 2, 3}, 253402300800 * GPS::microsecondsPerSecond}), std::domain_error);
+    writer.startSegment();
+    writer.startSegment();
+    writer.write({GPS::Waypoint {4, 5, 6}, 20});
+    writer.finish();
+
+    // Ensure empty segments are not written, a failed point writes nothing, and the writer closes once finished
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(gpx).size(), 2u);
+    const std::size_t secondSegment = gpx.find("<trkseg>", gpx.find("<trkseg>") + 1);
+    BOOST_CHECK(secondSegment != std::string::npos && gpx.find("<trkseg>", secondSegment + 1) == std::string::npos);
+    BOOST_CHECK_THROW(writer.write({GPS::Waypoint {1, 2, 3}, 10}), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(CompressedFile){
+    const std::vector<GPS::Trackpoint> original = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const std::string filePath = (std::filesystem::temp_directory_path() / "gpx-writer-tests.gpx.gz").string();
+    GPS::GPX::writeTrackFile(filePath, original);
+    const std::vector<GPS::Trackpoint> reread = GPS::GPX::parseTrackFile(filePath);
+
+    // Ensure a .gz file is compressed, and reads back as the same points
+    BOOST_CHECK_LT(std::filesystem::file_size(filePath) * 4, GPS::GPX::writeTrackString(original).size());
+    BOOST_REQUIRE_EQUAL(reread.size(), original.size());
+    BOOST_CHECK_EQUAL(reread.back().waypoint.latitude(), original.back().waypoint.latitude());
+    BOOST_CHECK_EQUAL(reread.back().timeStamp, original.back().timeStamp);
+    std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
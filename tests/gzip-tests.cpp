@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "gzip.h"
+
+
+BOOST_AUTO_TEST_SUITE(GzipTests)
+
+std::string compress(const std::string& text, int level = -1)
+{
+    std::ostringstream compressed;
+    GPS::GzipOutputStream gzip {compressed, level};
+    gzip << text;
+    gzip.close();
+    return compressed.str();
+}
+
+std::string inflateInPieces(const std::string& compressed, std::size_t pieceSize, std::size_t chunkSize)
+{
+    std::string text;
+    GPS::GzipInflater inflater {chunkSize};
+    for (std::size_t i = 0; i < compressed.size(); i += pieceSize)
+    {
+        inflater.feed(std::string_view {compressed}.substr(i, pieceSize), [&](std::string_view chunk) {
+            BOOST_CHECK_LE(chunk.size(), chunkSize);
+            text += chunk;
+        });
+    }
+    inflater.finish();
+    return text;
+}
+
+std::string sampleText()
+{
+    std::string text;
+    for (int i = 0; i < 100000; ++i) text += "<trkpt lat=\"" + std::to_string(i) + "\"/>\n";
+    return text;
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip){
+    const std::string text = sampleText();
+    const std::string compressed = compress(text);
+
+    // Ensure data is compressed in gzip format, and decompresses the same whether fed whole or byte by byte
+    BOOST_CHECK(GPS::isGzipData(compressed));
+    BOOST_CHECK_LT(compressed.size() * 5, text.size());
+    BOOST_CHECK(inflateInPieces(compressed, compressed.size(), 4096) == text);
+    BOOST_CHECK(inflateInPieces(compressed, 1, 100) == text);
+    BOOST_CHECK(inflateInPieces(compress("", 1), 3, 10).empty());
+}
+
+BOOST_AUTO_TEST_CASE(ConcatenatedMembers){
+    // Ensure concatenated gzip members are decompressed in turn
+    BOOST_CHECK_EQUAL(inflateInPieces(compress("first, ") + compress("second", 9), 5, 16), "first, second");
+}
+
+BOOST_AUTO_TEST_CASE(CorruptData){
+    const std::string compressed = compress(sampleText());
+    std::string corrupted = compressed;
+    corrupted[compressed.size() / 2] ^= 0x55;
+
+    // Ensure corrupt, truncated and trailing data are each rejected
+    BOOST_CHECK_THROW(inflateInPieces(corrupted, 1000, 4096), std::domain_error);
+    BOOST_CHECK_THROW(inflateInPieces(compressed.substr(0, compressed.size() - 4), 1000, 4096), std::domain_error);
+    BOOST_CHECK_THROW(inflateInPieces(compressed + "<gpx/>", 1000, 4096), std::domain_error);
+    BOOST_CHECK_THROW(inflateInPieces("", 1, 4096), std::domain_error);
+    BOOST_CHECK_THROW(GPS::GzipOutputStream(std::cout, 10), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(BackgroundReader){
+    const std::string text = sampleText();
+    std::istringstream compressed {compress(text)};
+    GPS::BackgroundGzipReader reader {[&compressed](char* buffer, std::size_t size) {
+        compressed.read(buffer, size);
+        return static_cast<std::size_t>(compressed.gcount());
+    }, 1000, 2};
+
+    std::string decompressed;
+    for (std::string_view chunk = reader.nextChunk(); ! chunk.empty(); chunk = reader.nextChunk())
+    {
+        decompressed += chunk;
+    }
+
+    // Ensure every chunk arrives, in order
+    BOOST_CHECK(decompressed == text);
+}
+
+BOOST_AUTO_TEST_CASE(BackgroundReaderErrors){
+    GPS::BackgroundGzipReader failingSource {[](char*, std::size_t) -> std::size_t { throw std::runtime_error("read failed"); }};
+    std::istringstream corrupt {"\x1f\x8b not really gzip"};
+    GPS::BackgroundGzipReader corruptSource {[&corrupt](char* buffer, std::size_t size) {
+        corrupt.read(buffer, size);
+        return static_cast<std::size_t>(corrupt.gcount());
+    }};
+
+    // Ensure errors from the source, or in the data, reach the caller
+    BOOST_CHECK_THROW(failingSource.nextChunk(), std::runtime_error);
+    BOOST_CHECK_THROW(corruptSource.nextChunk(), std::domain_error);
+
+    // Ensure a reader abandoned part-way through stops cleanly
+    const std::string text = sampleText();
+    std::istringstream compressed {compress(text)};
+    GPS::BackgroundGzipReader abandoned {[&compressed](char* buffer, std::size_t size) {
+        compressed.read(buffer, size);
+        return static_cast<std::size_t>(compressed.gcount());
+    }, 100, 1};
+    BOOST_CHECK(! abandoned.nextChunk().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
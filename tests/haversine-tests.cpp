@@ -0,0 +1,142 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "earth.h"
+#include "geometry.h"
+#include "haversine.h"
+
+using namespace GPS;
+
+namespace
+{
+  void checkAgreesWithWaypoint(metres distance, const Waypoint& p1, const Waypoint& p2)
+  {
+      const metres expected = Waypoint::horizontalDistanceBetween(p1, p2);
+      const metres halfCircumference = Earth::meanRadius * pi;
+      const metres tolerance = halfCircumference - expected < Haversine::antipodalMargin
+                             ? Haversine::antipodalTolerance
+                             : Haversine::relativeTolerance * expected;
+      BOOST_CHECK_SMALL(distance - expected, tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(HaversineTests)
+
+BOOST_AUTO_TEST_CASE(KernelsAgreeWithWaypoint){
+    std::mt19937 random {2024};
+    std::uniform_real_distribution<degrees> latitude {-poleLatitude, poleLatitude};
+    std::uniform_real_distribution<degrees> longitude {-antiMeridianLongitude, antiMeridianLongitude};
+    std::uniform_real_distribution<degrees> step {-0.001, 0.001};
+
+    for (const Haversine::Kernel& kernel : Haversine::availableKernels())
+    {
+        // Every count up to a few vectors, so that each remainder size is covered.
+        for (std::size_t count = 0; count <= 20; ++count)
+        {
+            std::vector<degrees> lat1, lon1, lat2, lon2;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                lat1.push_back(latitude(random));
+                lon1.push_back(longitude(random));
+                // Alternately far apart, and short legs as in a track.
+                const bool shortLeg = i % 2 == 0 && std::abs(lat1.back()) < 89 && std::abs(lon1.back()) < 179;
+                lat2.push_back(shortLeg ? lat1.back() + step(random) : latitude(random));
+                lon2.push_back(shortLeg ? lon1.back() + step(random) : longitude(random));
+            }
+            std::vector<metres> distances(count + 1, -1);
+            kernel.distancesBetween(lat1.data(), lon1.data(), lat2.data(), lon2.data(), distances.data(), count);
+
+            // Ensure every distance agrees with the scalar function, and nothing is written beyond the end
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                checkAgreesWithWaypoint(distances[i], Waypoint(lat1[i], lon1[i], 0), Waypoint(lat2[i], lon2[i], 0));
+            }
+            BOOST_CHECK_EQUAL(distances[count], -1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AwkwardPoints){
+    // Coincident points, the poles, either side of the antimeridian, and antipodes.
+    const std::vector<degrees> lat1 = {51.5, 90, -90, 10, 10, 0, 45, 89.9999, -30, 60};
+    const std::vector<degrees> lon1 = {-0.1, 0, 0, 179.9999, -180, 0, 10, 45, 120, 0};
+    const std::vector<degrees> lat2 = {51.5, -90, 89.9999, 10, 10, 0, -45, 89.9999, 30.0001, 60.00001};
+    const std::vector<degrees> lon2 = {-0.1, 0, 100, -179.9999, 180, 180, -170, -135, -60, 0};
+
+    for (const Haversine::Kernel& kernel : Haversine::availableKernels())
+    {
+        std::vector<metres> distances(lat1.size());
+        kernel.distancesBetween(lat1.data(), lon1.data(), lat2.data(), lon2.data(), distances.data(), distances.size());
+
+        // Ensure each distance agrees with the scalar function, within the antipodal tolerance there
+        for (std::size_t i = 0; i < distances.size(); ++i)
+        {
+            checkAgreesWithWaypoint(distances[i], Waypoint(lat1[i], lon1[i], 0), Waypoint(lat2[i], lon2[i], 0));
+        }
+
+        // Ensure coincident points are exactly no distance apart
+        BOOST_CHECK_EQUAL(distances[0], 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DistancesFromOrigin){
+    std::mt19937 random {7};
+    std::uniform_real_distribution<degrees> latitude {-poleLatitude, poleLatitude};
+    std::uniform_real_distribution<degrees> longitude {-antiMeridianLongitude, antiMeridianLongitude};
+    const Waypoint origin {54.4, -0.9, 100};
+
+    std::vector<degrees> latitudes, longitudes;
+    for (std::size_t i = 0; i < 37; ++i)
+    {
+        latitudes.push_back(latitude(random));
+        longitudes.push_back(longitude(random));
+    }
+
+    // Ensure every implementation agrees with the scalar function
+    for (const Haversine::Kernel& kernel : Haversine::availableKernels())
+    {
+        std::vector<metres> distances(latitudes.size());
+        kernel.distancesFrom(origin.latitude(), origin.longitude(), latitudes.data(), longitudes.data(),
+                             distances.data(), distances.size());
+        for (std::size_t i = 0; i < distances.size(); ++i)
+        {
+            checkAgreesWithWaypoint(distances[i], origin, Waypoint(latitudes[i], longitudes[i], 0));
+        }
+    }
+
+    // Ensure the span functions use the selected implementation
+    std::vector<metres> distances(latitudes.size());
+    std::vector<metres> expected(latitudes.size());
+    Haversine::distancesFrom(origin, latitudes, longitudes, distances);
+    Haversine::selectedKernel().distancesFrom(origin.latitude(), origin.longitude(), latitudes.data(), longitudes.data(),
+                                              expected.data(), expected.size());
+    BOOST_CHECK(distances == expected);
+
+    const std::vector<degrees> origins (latitudes.size(), origin.latitude());
+    const std::vector<degrees> originLongitudes (latitudes.size(), origin.longitude());
+    Haversine::distancesBetween(origins, originLongitudes, latitudes, longitudes, distances);
+    Haversine::selectedKernel().distancesBetween(origins.data(), originLongitudes.data(), latitudes.data(), longitudes.data(),
+                                                 expected.data(), expected.size());
+    BOOST_CHECK(distances == expected);
+}
+
+BOOST_AUTO_TEST_CASE(MismatchedSizes){
+    const std::vector<degrees> coordinates (4, 1.0);
+    const std::vector<degrees> fewerCoordinates (3, 1.0);
+    std::vector<metres> distances (4);
+    std::vector<metres> fewerDistances (3);
+    const Waypoint origin {0, 0, 0};
+
+    // Ensure the spans must all be the same size
+    BOOST_CHECK_THROW(Haversine::distancesBetween(coordinates, coordinates, coordinates, fewerCoordinates, distances), std::invalid_argument);
+    BOOST_CHECK_THROW(Haversine::distancesBetween(coordinates, coordinates, coordinates, coordinates, fewerDistances), std::invalid_argument);
+    BOOST_CHECK_THROW(Haversine::distancesFrom(origin, fewerCoordinates, coordinates, distances), std::invalid_argument);
+    BOOST_CHECK_THROW(Haversine::distancesFrom(origin, coordinates, coordinates, fewerDistances), std::invalid_argument);
+    BOOST_CHECK_NO_THROW(Haversine::distancesFrom(origin, coordinates, coordinates, distances));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
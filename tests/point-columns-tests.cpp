@@ -0,0 +1,59 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "point-columns.h"
+
+
+BOOST_AUTO_TEST_SUITE(PointColumnsTests)
+
+BOOST_AUTO_TEST_CASE(ColumnsFromPoints){
+    const std::vector<GPS::Trackpoint> trackPoints = {
+        {GPS::Waypoint {1, 2, 3}, 4},
+        {GPS::Waypoint {-5, -6, 7}, 8},
+    };
+    const GPS::PointColumns columns {trackPoints};
+
+    // Ensure each field is stored in its own column, in track order
+    BOOST_REQUIRE_EQUAL(columns.size(), 2u);
+    BOOST_CHECK_EQUAL(columns.latitudes[1], -5);
+    BOOST_CHECK_EQUAL(columns.longitudes[1], -6);
+    BOOST_CHECK_EQUAL(columns.altitudes[1], 7);
+    BOOST_CHECK_EQUAL(columns.timeStamps[1], 8);
+    BOOST_CHECK_EQUAL(columns.waypoint(0).longitude(), 2);
+
+    // Ensure the columns are aligned for vector loads
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(columns.latitudes.data()) % 64, 0u);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(columns.timeStamps.data()) % 64, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(FirstIndexOfExtremes){
+    // Long enough for both whole vectors and a remainder, with ties in each.
+    std::vector<double> values (23, 1.5);
+    values[3] = 7;
+    values[9] = 7;
+    values[5] = -8;
+    values[21] = -8;
+    values[6] = 0.25;
+    values[17] = -0.25;
+
+    // Ensure the earliest of equal values is found
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfGreatest(values), 3u);
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfLeast(values), 5u);
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfGreatestMagnitude(values), 5u);
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfLeastMagnitude(values), 6u);
+
+    // Ensure values in the remainder, and single values, are found
+    values[22] = 9;
+    values[20] = -0.0;
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfGreatest(values), 22u);
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfLeastMagnitude(values), 20u);
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfLeast(std::vector<double> {4}), 0u);
+
+    // Ensure positive and negative zero are equally close to zero
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfLeastMagnitude(std::vector<double> {1, -0.0, 0.0, 2, 3}), 1u);
+    BOOST_CHECK_EQUAL(GPS::firstIndexOfLeastMagnitude(std::vector<double> {1, 0.0, -0.0, 2, 3}), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
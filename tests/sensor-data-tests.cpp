@@ -0,0 +1,71 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "sensor-data.h"
+#include "track.h"
+
+
+BOOST_AUTO_TEST_SUITE(SensorDataTests)
+
+GPS::SensorReadings heartRateOf(double beatsPerMinute)
+{
+    GPS::SensorReadings readings;
+    readings[GPS::SensorChannel::HeartRate] = beatsPerMinute;
+    return readings;
+}
+
+BOOST_AUTO_TEST_CASE(ColumnsAllocatedWhenPresent){
+    GPS::SensorData sensors;
+    sensors.append({});
+    sensors.append(heartRateOf(120));
+    sensors.append({});
+
+    // Ensure only the channels with readings have columns, filled with NaN where a point has none
+    BOOST_CHECK_EQUAL(sensors.size(), 3u);
+    BOOST_CHECK(! sensors.hasChannel(GPS::SensorChannel::Power));
+    BOOST_CHECK(sensors.channel(GPS::SensorChannel::Power).empty());
+    BOOST_REQUIRE(sensors.hasChannel(GPS::SensorChannel::HeartRate));
+    BOOST_REQUIRE_EQUAL(sensors.channel(GPS::SensorChannel::HeartRate).size(), 3u);
+    BOOST_CHECK(std::isnan(sensors.channel(GPS::SensorChannel::HeartRate)[0]));
+    BOOST_CHECK_EQUAL(sensors.channel(GPS::SensorChannel::HeartRate)[1], 120);
+    BOOST_CHECK(std::isnan(sensors.channel(GPS::SensorChannel::HeartRate)[2]));
+}
+
+BOOST_AUTO_TEST_CASE(TrackReadings){
+    std::vector<GPS::Trackpoint> trackPoints;
+    GPS::SensorData sensors;
+    const double heartRates[] = {100, 140, NAN, 160, 120};
+    for (int i = 0; i < 5; ++i)
+    {
+        trackPoints.push_back({GPS::Waypoint(0, 0, 0), 10 * i * GPS::microsecondsPerSecond});
+        sensors.append(heartRateOf(heartRates[i]));
+    }
+    const GPS::Track track {trackPoints, sensors};
+
+    // Ensure points without a reading are ignored
+    BOOST_CHECK_EQUAL(track.maxSensorReading(GPS::SensorChannel::HeartRate), 160);
+    BOOST_CHECK_EQUAL(track.averageSensorReading(GPS::SensorChannel::HeartRate), 130);
+
+    // Ensure the best period is found, and a period longer than the track covers all of it
+    BOOST_CHECK_EQUAL(track.maxAverageSensorReading(GPS::SensorChannel::HeartRate, 0), 160);
+    BOOST_CHECK_EQUAL(track.maxAverageSensorReading(GPS::SensorChannel::HeartRate, 20), 150);
+    BOOST_CHECK_EQUAL(track.maxAverageSensorReading(GPS::SensorChannel::HeartRate, 1000), 130);
+}
+
+BOOST_AUTO_TEST_CASE(MissingReadings){
+    GPS::SensorData sensors;
+    sensors.append(heartRateOf(100));
+    const GPS::Track track {{{GPS::Waypoint(0, 0, 0), 0}}, sensors};
+
+    // Ensure a channel without readings, a negative period and mismatched readings are rejected
+    BOOST_CHECK_THROW(track.maxSensorReading(GPS::SensorChannel::Power), std::domain_error);
+    BOOST_CHECK_THROW(track.averageSensorReading(GPS::SensorChannel::Cadence), std::domain_error);
+    BOOST_CHECK_THROW(GPS::Track({}).maxAverageSensorReading(GPS::SensorChannel::HeartRate, 60), std::domain_error);
+    BOOST_CHECK_THROW(track.maxAverageSensorReading(GPS::SensorChannel::HeartRate, -1), std::invalid_argument);
+    BOOST_CHECK_THROW(GPS::Track({}, sensors), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,72 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "thread-pool.h"
+
+
+BOOST_AUTO_TEST_SUITE(ThreadPoolTests)
+
+BOOST_AUTO_TEST_CASE(ResultsAndExceptions){
+    GPS::ThreadPool pool {3};
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i)
+    {
+        results.push_back(pool.submit([i]{ if (i == 50) throw std::runtime_error("task 50"); return i * i; }));
+    }
+
+    // Ensure every task's result, or exception, reaches its future
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i == 50) BOOST_CHECK_THROW(results[i].get(), std::runtime_error);
+        else BOOST_CHECK_EQUAL(results[i].get(), i * i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TasksSubmittedByTasks){
+    std::atomic<int> tasksRun {0};
+    {
+        GPS::ThreadPool pool {4};
+        for (int i = 0; i < 20; ++i)
+        {
+            pool.submit([&pool, &tasksRun]
+            {
+                for (int j = 0; j < 10; ++j)
+                {
+                    pool.submit([&tasksRun]{ ++tasksRun; });
+                }
+                ++tasksRun;
+            });
+        }
+    }
+
+    // Ensure tasks queued by running tasks are run, and that the destructor waits for them all
+    BOOST_CHECK_EQUAL(tasksRun, 220);
+}
+
+BOOST_AUTO_TEST_CASE(IdleWorkersSteal){
+    GPS::ThreadPool pool {2};
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    // Block one worker, then queue further tasks that are dealt to both workers' queues.
+    std::future<void> blocked = pool.submit([released]{ released.wait(); });
+    std::vector<std::future<void>> others;
+    for (int i = 0; i < 6; ++i)
+    {
+        others.push_back(pool.submit([]{}));
+    }
+
+    // Ensure the free worker runs the tasks queued for the blocked one
+    for (std::future<void>& other : others)
+    {
+        BOOST_CHECK(other.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    }
+    release.set_value();
+    blocked.get();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
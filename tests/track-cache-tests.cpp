@@ -0,0 +1,164 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track-cache.h"
+
+
+BOOST_AUTO_TEST_SUITE(TrackCacheTests)
+
+// An empty directory for one test, removed when the test ends.
+struct CacheDirectory
+{
+    std::string path;
+
+    explicit CacheDirectory(const std::string& name)
+      : path{(std::filesystem::temp_directory_path() / ("track-cache-tests-" + name)).string()}
+    {
+        std::filesystem::remove_all(path);
+    }
+
+    ~CacheDirectory()
+    {
+        std::filesystem::remove_all(path);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(ContentHash){
+    std::string bytes;
+    for (char c = 0; c < 100; ++c) bytes += c;
+
+    // Ensure the hash matches the XXH64 reference values, for inputs shorter and longer than one 32-byte stripe
+    BOOST_CHECK_EQUAL(GPS::contentHash(""), 0xEF46DB3751D8E999);
+    BOOST_CHECK_EQUAL(GPS::contentHash("a"), 0xD24EC4F1A98C6E5B);
+    BOOST_CHECK_EQUAL(GPS::contentHash("abc"), 0x44BC2CF5AD770999);
+    BOOST_CHECK_EQUAL(GPS::contentHash("Nobody inspects the spammish repetition"), 0xFBCEA83C8A378BF1);
+    BOOST_CHECK_EQUAL(GPS::contentHash(bytes), 0x6AC1E58032166597);
+}
+
+BOOST_AUTO_TEST_CASE(Keys){
+    const std::string key = GPS::TrackCache::keyFor("abc");
+
+    // Ensure keys name the hash, length and versions, and differ with the contents
+    BOOST_CHECK_EQUAL(key, "44bc2cf5ad770999-3-p" + std::to_string(GPS::GPX::parserVersion) + "-f2");
+    BOOST_CHECK_NE(GPS::TrackCache::keyFor("abd"), key);
+    BOOST_CHECK_EQUAL(GPS::TrackCache::keyFor(""), "ef46db3751d8e999-0-p" + std::to_string(GPS::GPX::parserVersion) + "-f2");
+}
+
+BOOST_AUTO_TEST_CASE(ParsedOnlyOnce){
+    const CacheDirectory directory {"parse"};
+    GPS::TrackCache cache {directory.path};
+    const std::vector<GPS::Trackpoint> first = cache.parseTrackFile("data/NorthYorkMoors.gpx");
+    const std::vector<GPS::Trackpoint> second = GPS::TrackCache {directory.path}.parseTrackFile("data/NorthYorkMoors.gpx");
+    const std::vector<GPS::Trackpoint> parsed = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+
+    // Ensure the first parse is a miss, a later one (by another cache on the directory) a hit, and both give the parsed points
+    BOOST_CHECK_EQUAL(cache.misses(), 1u);
+    BOOST_CHECK_EQUAL(cache.hits(), 0u);
+    BOOST_CHECK_EQUAL(cache.parseTrackFile("data/NorthYorkMoors.gpx").size(), parsed.size());
+    BOOST_CHECK_EQUAL(cache.hits(), 1u);
+    BOOST_REQUIRE_EQUAL(second.size(), parsed.size());
+    BOOST_REQUIRE_EQUAL(first.size(), parsed.size());
+    for (std::size_t i = 0; i < parsed.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(second[i].waypoint.latitude(), parsed[i].waypoint.latitude());
+        BOOST_CHECK_EQUAL(second[i].timeStamp, parsed[i].timeStamp);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Metrics){
+    const CacheDirectory directory {"metrics"};
+    GPS::TrackCache cache {directory.path};
+    const std::string key = GPS::TrackCache::keyFor("metrics");
+    const GPS::TrackCache::Metrics metrics = {{"totalLength", 12345.678901234567}, {"maxSpeed", 1e-300},
+                                              {"netHeightGain", -0.0}, {"averageSpeed", std::numeric_limits<double>::infinity()}};
+
+    // Ensure metrics are missing until stored, then read back exactly, and bad names are rejected
+    BOOST_CHECK(! cache.findMetrics(key));
+    cache.storeMetrics(key, metrics);
+    const std::optional<GPS::TrackCache::Metrics> found = cache.findMetrics(key);
+    BOOST_REQUIRE(found);
+    BOOST_CHECK(*found == metrics);
+    BOOST_CHECK(std::signbit(found->at("netHeightGain")));
+    BOOST_CHECK_EQUAL(cache.hits(), 1u);
+    BOOST_CHECK_EQUAL(cache.misses(), 1u);
+    BOOST_CHECK_THROW(cache.storeMetrics(key, {{"max speed", 1}}), std::invalid_argument);
+    BOOST_CHECK_THROW(cache.storeMetrics(key, {{"end", 1}}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(DamagedEntries){
+    const CacheDirectory directory {"damaged"};
+    GPS::TrackCache cache {directory.path};
+    const std::string key = GPS::TrackCache::keyFor("damaged");
+    cache.storeTrack(key, std::vector<GPS::Trackpoint> {{GPS::Waypoint {1, 2, 3}, 4}});
+    cache.storeMetrics(key, {{"totalTime", 1}});
+    std::ofstream {directory.path + "/" + key + ".track", std::ios::binary | std::ios::app} << "x";
+    std::ofstream {directory.path + "/" + key + ".metrics", std::ios::trunc} << "totalTime 1\n";
+
+    // Ensure truncated or extended files are treated as misses rather than misread
+    BOOST_CHECK(! cache.findTrack(key));
+    BOOST_CHECK(! cache.findMetrics(key));
+    BOOST_CHECK_EQUAL(cache.misses(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(LeastRecentlyUsedEviction){
+    const CacheDirectory directory {"eviction"};
+    const std::vector<GPS::Trackpoint> trackPoints (100, {GPS::Waypoint {1, 2, 3}, 4}); // 3232 bytes as a track file.
+    GPS::TrackCache cache {directory.path, 10'000};
+    std::vector<std::string> keys;
+    const auto start = std::filesystem::file_time_type::clock::now() - std::chrono::hours {1};
+    for (int i = 0; i < 3; ++i)
+    {
+        keys.push_back(GPS::TrackCache::keyFor(std::to_string(i)));
+        cache.storeTrack(keys.back(), trackPoints);
+        std::filesystem::last_write_time(directory.path + "/" + keys.back() + ".track", start + std::chrono::minutes {i});
+    }
+    BOOST_REQUIRE(cache.findTrack(keys[0])); // Now the most recently used.
+    keys.push_back(GPS::TrackCache::keyFor("3"));
+    cache.storeTrack(keys.back(), trackPoints);
+
+    // Ensure the least recently used entries are removed to bring the cache within three quarters of its bound
+    BOOST_CHECK_EQUAL(cache.evictions(), 2u);
+    BOOST_CHECK(cache.findTrack(keys[0]));
+    BOOST_CHECK(! cache.findTrack(keys[1]));
+    BOOST_CHECK(! cache.findTrack(keys[2]));
+    BOOST_CHECK(cache.findTrack(keys[3]));
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentWriters){
+    const CacheDirectory directory {"concurrent"};
+    const std::string key = GPS::TrackCache::keyFor("concurrent");
+    const std::vector<GPS::Trackpoint> trackPoints (10'000, {GPS::Waypoint {1, 2, 3}, 4});
+    std::atomic<int> incompleteReads {0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        // Separate TrackCaches, as separate processes would have.
+        threads.emplace_back([&] {
+            GPS::TrackCache cache {directory.path};
+            for (int j = 0; j < 10; ++j)
+            {
+                cache.storeTrack(key, trackPoints);
+                const std::optional<std::vector<GPS::Trackpoint>> found = cache.findTrack(key);
+                if (! found || found->size() != trackPoints.size()) ++incompleteReads;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    // Ensure readers only ever see complete entries, and no temporary files are left behind
+    BOOST_CHECK_EQUAL(incompleteReads, 0);
+    BOOST_CHECK_EQUAL(std::distance(std::filesystem::directory_iterator {directory.path}, std::filesystem::directory_iterator {}), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track-codec.h"
+
+
+BOOST_AUTO_TEST_SUITE(TrackCodecTests)
+
+BOOST_AUTO_TEST_CASE(SampleTrackRoundTrip){
+    const std::vector<GPS::Trackpoint> original = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const std::string encoding = GPS::encodeTrack(original);
+    const std::vector<GPS::Trackpoint> decoded = GPS::decodeTrack(encoding);
+
+    // Ensure each field is within half a unit of the chosen precision, and times are exact
+    BOOST_REQUIRE_EQUAL(decoded.size(), original.size());
+    for (std::size_t i = 0; i < original.size(); ++i)
+    {
+        BOOST_CHECK_SMALL(decoded[i].waypoint.latitude() - original[i].waypoint.latitude(), 0.5e-7 + 1e-12);
+        BOOST_CHECK_SMALL(decoded[i].waypoint.longitude() - original[i].waypoint.longitude(), 0.5e-7 + 1e-12);
+        BOOST_CHECK_SMALL(decoded[i].waypoint.altitude() - original[i].waypoint.altitude(), 0.5e-2 + 1e-9);
+        BOOST_CHECK_EQUAL(decoded[i].timeStamp, original[i].timeStamp);
+    }
+
+    // Ensure the encoding is at least ten times smaller than the GPX text
+    BOOST_CHECK_LT(encoding.size() * 10, std::filesystem::file_size("data/NorthYorkMoors.gpx"));
+}
+
+BOOST_AUTO_TEST_CASE(NearestDecimalValues){
+    const std::vector<GPS::Trackpoint> original = {
+        {GPS::Waypoint {54.42204773426058, -0.7285404205322266, 309.123}, 946684810},
+        {GPS::Waypoint {90, -180, -6371000}, -5000000000},
+        {GPS::Waypoint {-90, 180, 1e9}, 5000000000},
+    };
+    const std::vector<GPS::Trackpoint> decoded = GPS::decodeTrack(GPS::encodeTrack(original, {5, 1}));
+
+    // Ensure values are rounded to the nearest decimal, the extremes stay valid, and large time steps survive
+    BOOST_REQUIRE_EQUAL(decoded.size(), 3u);
+    BOOST_CHECK_EQUAL(decoded[0].waypoint.latitude(), 54.42205);
+    BOOST_CHECK_EQUAL(decoded[0].waypoint.longitude(), -0.72854);
+    BOOST_CHECK_EQUAL(decoded[0].waypoint.altitude(), 309.1);
+    BOOST_CHECK_EQUAL(decoded[1].waypoint.latitude(), 90);
+    BOOST_CHECK_EQUAL(decoded[1].waypoint.longitude(), -180);
+    BOOST_CHECK_EQUAL(decoded[1].timeStamp, -5000000000);
+    BOOST_CHECK_EQUAL(decoded[2].waypoint.altitude(), 1e9);
+    BOOST_CHECK_EQUAL(decoded[2].timeStamp, 5000000000);
+}
+
+BOOST_AUTO_TEST_CASE(TimeUnits){
+    std::vector<GPS::Trackpoint> oneHertz;
+    for (GPS::microseconds second = 0; second < 100; ++second)
+    {
+        oneHertz.push_back({GPS::Waypoint {1, 2, 3}, (946684810 + second) * GPS::microsecondsPerSecond});
+    }
+    const std::vector<GPS::Trackpoint> subSecond = {{GPS::Waypoint {1, 2, 3}, 946684810'100'000}, {GPS::Waypoint {1, 2, 3}, -999'999}};
+    const std::vector<GPS::Trackpoint> decoded = GPS::decodeTrack(GPS::encodeTrack(subSecond));
+
+    // Ensure whole-second steps take one byte each, as whole seconds would, and finer time stamps are exact
+    BOOST_CHECK_LT(GPS::encodeTrack(oneHertz).size(), 100u * 5);
+    BOOST_REQUIRE_EQUAL(decoded.size(), 2u);
+    BOOST_CHECK_EQUAL(decoded[0].timeStamp, subSecond[0].timeStamp);
+    BOOST_CHECK_EQUAL(decoded[1].timeStamp, subSecond[1].timeStamp);
+}
+
+BOOST_AUTO_TEST_CASE(AppendsAndEmpty){
+    std::vector<GPS::Trackpoint> trackPoints = {{GPS::Waypoint {1, 2, 3}, 4}};
+    GPS::decodeTrack(GPS::encodeTrack(trackPoints), trackPoints);
+    GPS::decodeTrack(GPS::encodeTrack({}), trackPoints);
+
+    // Ensure decoded points are appended, and an empty track round-trips
+    BOOST_REQUIRE_EQUAL(trackPoints.size(), 2u);
+    BOOST_CHECK_EQUAL(trackPoints[1].waypoint.altitude(), 3);
+    BOOST_CHECK(GPS::decodeTrack(GPS::encodeTrack({})).empty());
+}
+
+BOOST_AUTO_TEST_CASE(InvalidOptions){
+    const std::vector<GPS::Trackpoint> trackPoints = {{GPS::Waypoint {1, 2, 1e15}, 4}};
+
+    // Ensure out-of-range precisions, and altitudes too large for the precision, are rejected
+    BOOST_CHECK_THROW(GPS::encodeTrack(trackPoints, {13, 2}), std::invalid_argument);
+    BOOST_CHECK_THROW(GPS::encodeTrack(trackPoints, {7, 7}), std::invalid_argument);
+    BOOST_CHECK_THROW(GPS::encodeTrack(trackPoints, {7, 6}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(MalformedEncodings){
+    const std::string valid = GPS::encodeTrack(std::vector<GPS::Trackpoint> {{GPS::Waypoint {1, 2, 3}, 4}, {GPS::Waypoint {5, 6, 7}, 8}});
+
+    // After the magic and version: the point count, the two precisions, the time unit, then the first column's length.
+    auto corrupted = [&valid](std::size_t offset, char byte) { std::string encoding = valid; encoding[offset] = byte; return encoding; };
+    const std::vector<std::string> malformed = {
+        "", "GPSZ", corrupted(0, 'X'), corrupted(4, 3), corrupted(5, 3), corrupted(6, 13), corrupted(7, 7), corrupted(8, 7),
+        corrupted(9, '\x7f'), corrupted(9, 1), corrupted(13, '\x80'), valid.substr(0, valid.size() - 1), valid + '\0',
+    };
+
+    // Ensure damaged or truncated encodings are rejected rather than misread
+    for (const std::string& encoding : malformed)
+    {
+        BOOST_CHECK_THROW(GPS::decodeTrack(encoding), std::domain_error);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
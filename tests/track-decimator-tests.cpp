@@ -0,0 +1,103 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "gpx-writer.h"
+#include "track-decimator.h"
+
+
+BOOST_AUTO_TEST_SUITE(TrackDecimatorTests)
+
+// Points logged at 10 Hz for two and a half seconds, heading north at about 1 metre per point.
+std::vector<GPS::Trackpoint> tenHertzPoints()
+{
+    std::vector<GPS::Trackpoint> trackPoints;
+    for (int i = 0; i < 25; ++i)
+    {
+        trackPoints.push_back({GPS::Waypoint {i * 0.00001, 0, 100}, i * 100'000});
+    }
+    return trackPoints;
+}
+
+std::vector<GPS::Trackpoint> decimated(const std::vector<GPS::Trackpoint>& trackPoints, GPS::DecimationOptions options)
+{
+    std::vector<GPS::Trackpoint> kept;
+    GPS::TrackDecimator decimator {[&kept](const GPS::Trackpoint& trackPoint) { kept.push_back(trackPoint); }, options};
+    for (const GPS::Trackpoint& trackPoint : trackPoints)
+    {
+        decimator.add(trackPoint);
+    }
+    decimator.finish();
+    return kept;
+}
+
+BOOST_AUTO_TEST_CASE(FirstPointOfEachInterval){
+    const std::vector<GPS::Trackpoint> kept = decimated(tenHertzPoints(), {GPS::microsecondsPerSecond});
+
+    // Ensure each second is represented by its first point, and the last point is kept
+    BOOST_REQUIRE_EQUAL(kept.size(), 4u);
+    BOOST_CHECK_EQUAL(kept[0].timeStamp, 0);
+    BOOST_CHECK_EQUAL(kept[1].timeStamp, 1'000'000);
+    BOOST_CHECK_EQUAL(kept[2].timeStamp, 2'000'000);
+    BOOST_CHECK_EQUAL(kept[3].timeStamp, 2'400'000);
+}
+
+BOOST_AUTO_TEST_CASE(AverageOfEachInterval){
+    const std::vector<GPS::Trackpoint> kept = decimated(tenHertzPoints(), {GPS::microsecondsPerSecond, GPS::DecimationOptions::Mode::Average});
+
+    // Ensure each second is replaced by the mean of its points, followed by the last point
+    BOOST_REQUIRE_EQUAL(kept.size(), 4u);
+    BOOST_CHECK_EQUAL(kept[0].timeStamp, 450'000);
+    BOOST_CHECK_CLOSE(kept[0].waypoint.latitude(), 0.000045, 1e-9);
+    BOOST_CHECK_EQUAL(kept[2].timeStamp, 2'200'000);
+    BOOST_CHECK_EQUAL(kept[2].waypoint.altitude(), 100);
+    BOOST_CHECK_EQUAL(kept[3].timeStamp, 2'400'000);
+    BOOST_CHECK_CLOSE(kept[3].waypoint.latitude(), 0.00024, 1e-9);
+
+    // Ensure the last point is kept when the final interval is only partly filled, but not repeated
+    // when it is the only point of its interval
+    std::vector<GPS::Trackpoint> tenSeconds = tenHertzPoints();
+    tenSeconds.erase(tenSeconds.begin() + 10, tenSeconds.end());
+    for (GPS::Trackpoint& trackPoint : tenSeconds) trackPoint.timeStamp *= 10;
+    const std::vector<GPS::Trackpoint> fiveSecondMeans = decimated(tenSeconds, {5 * GPS::microsecondsPerSecond, GPS::DecimationOptions::Mode::Average});
+    BOOST_REQUIRE_EQUAL(fiveSecondMeans.size(), 3u);
+    BOOST_CHECK_EQUAL(fiveSecondMeans[1].timeStamp, 7'000'000);
+    BOOST_CHECK_EQUAL(fiveSecondMeans[2].timeStamp, 9'000'000);
+    tenSeconds.erase(tenSeconds.begin() + 6, tenSeconds.end());
+    BOOST_CHECK_EQUAL(decimated(tenSeconds, {5 * GPS::microsecondsPerSecond, GPS::DecimationOptions::Mode::Average}).size(), 2u);
+
+    // Ensure the last point is kept even if the mean of its interval is too close to be
+    const std::vector<GPS::Trackpoint> closeMeans = decimated(tenHertzPoints(), {GPS::microsecondsPerSecond, GPS::DecimationOptions::Mode::Average, 50});
+    BOOST_REQUIRE_EQUAL(closeMeans.size(), 2u);
+    BOOST_CHECK_EQUAL(closeMeans.back().timeStamp, 2'400'000);
+
+    // Ensure an interval spanning the anti-meridian averages to a point on it
+    const std::vector<GPS::Trackpoint> antiMeridian = {{GPS::Waypoint {0, 179.9, 0}, 0}, {GPS::Waypoint {0, -179.9, 0}, 1}};
+    BOOST_CHECK_CLOSE(decimated(antiMeridian, {10, GPS::DecimationOptions::Mode::Average})[0].waypoint.longitude(), 180, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(MinimumDistance){
+    const std::vector<GPS::Trackpoint> kept = decimated(tenHertzPoints(), {0, GPS::DecimationOptions::Mode::FirstPoint, 5});
+
+    // Ensure points closer than the distance to the last point kept are dropped, except the last
+    BOOST_REQUIRE_EQUAL(kept.size(), 6u);
+    BOOST_CHECK_EQUAL(kept[1].timeStamp, 500'000);
+    BOOST_CHECK_EQUAL(kept.back().timeStamp, 2'400'000);
+
+    // Ensure the defaults keep every point, and negative options are rejected
+    BOOST_CHECK_EQUAL(decimated(tenHertzPoints(), {}).size(), 25u);
+    BOOST_CHECK_THROW(decimated({}, {-1}), std::invalid_argument);
+    BOOST_CHECK_THROW(decimated({}, {0, GPS::DecimationOptions::Mode::FirstPoint, -1}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(DecimatedParsing){
+    const std::string gpx = GPS::GPX::writeTrackString(tenHertzPoints());
+
+    // Ensure sub-second times survive writing and parsing, and points are decimated as they are parsed
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(gpx)[1].timeStamp, 100'000);
+    BOOST_CHECK_EQUAL(GPS::GPX::parseTrackString(gpx, GPS::DecimationOptions {GPS::microsecondsPerSecond}).size(), 4u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
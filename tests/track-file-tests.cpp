@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track-file.h"
+
+
+BOOST_AUTO_TEST_SUITE(TrackFileTests)
+
+std::string temporaryPath(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / ("track-file-tests-" + name)).string();
+}
+
+std::string contentsOf(const std::string& filePath)
+{
+    std::ifstream file {filePath, std::ios::binary};
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void overwrite(const std::string& filePath, const std::string& contents)
+{
+    std::ofstream {filePath, std::ios::binary} << contents;
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip){
+    const std::vector<GPS::Trackpoint> original = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const std::string filePath = temporaryPath("round-trip");
+    GPS::writeTrackFile(filePath, original);
+
+    const GPS::TrackFile trackFile {filePath};
+    const std::vector<GPS::Trackpoint> copied = GPS::readTrackFile(filePath);
+
+    // Ensure every field of every point is restored exactly
+    BOOST_CHECK_EQUAL(std::filesystem::file_size(filePath), 32u + 32u * original.size());
+    BOOST_REQUIRE_EQUAL(trackFile.trackPoints().size(), original.size());
+    BOOST_REQUIRE_EQUAL(copied.size(), original.size());
+    for (std::size_t i = 0; i < original.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(trackFile.trackPoints()[i].waypoint.latitude(), original[i].waypoint.latitude());
+        BOOST_CHECK_EQUAL(trackFile.trackPoints()[i].waypoint.longitude(), original[i].waypoint.longitude());
+        BOOST_CHECK_EQUAL(trackFile.trackPoints()[i].waypoint.altitude(), original[i].waypoint.altitude());
+        BOOST_CHECK_EQUAL(trackFile.trackPoints()[i].timeStamp, original[i].timeStamp);
+        BOOST_CHECK_EQUAL(copied[i].timeStamp, original[i].timeStamp);
+    }
+    std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_CASE(LittleEndianLayout){
+    const std::vector<GPS::Trackpoint> trackPoints = {{GPS::Waypoint {1, -2, 0.5}, -1}};
+    const std::string filePath = temporaryPath("layout");
+    GPS::writeTrackFile(filePath, trackPoints);
+    const std::string contents = contentsOf(filePath);
+
+    // Ensure the header and record fields are where the format says, in little-endian order
+    BOOST_REQUIRE_EQUAL(contents.size(), 64u);
+    BOOST_CHECK_EQUAL(contents.substr(0, 8), "GPSTRACK");
+    BOOST_CHECK_EQUAL(contents.substr(8, 8), std::string("\x02\0\0\0\x20\0\0\0", 8));
+    BOOST_CHECK_EQUAL(contents.substr(16, 8), std::string("\x01\0\0\0\0\0\0\0", 8));
+    BOOST_CHECK_EQUAL(contents.substr(32, 8), std::string("\0\0\0\0\0\0\xf0\x3f", 8));   // 1.0
+    BOOST_CHECK_EQUAL(contents.substr(40, 8), std::string("\0\0\0\0\0\0\0\xc0", 8));     // -2.0
+    BOOST_CHECK_EQUAL(contents.substr(48, 8), std::string("\0\0\0\0\0\0\xe0\x3f", 8));   // 0.5
+    BOOST_CHECK_EQUAL(contents.substr(56, 8), std::string(8, '\xff'));                   // -1
+    std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_CASE(WholeSecondsVersion){
+    const std::vector<GPS::Trackpoint> trackPoints = {{GPS::Waypoint {1, 2, 3}, 10}, {GPS::Waypoint {4, 5, 6}, -20}};
+    const std::string filePath = temporaryPath("version-1");
+    GPS::writeTrackFile(filePath, trackPoints);
+    std::string contents = contentsOf(filePath);
+    contents[8] = 1;
+    overwrite(filePath, contents);
+
+    // Ensure the time stamps of a version 1 file are read as whole seconds
+    const std::vector<GPS::Trackpoint> reread = GPS::readTrackFile(filePath);
+    BOOST_REQUIRE_EQUAL(reread.size(), 2u);
+    BOOST_CHECK_EQUAL(reread[0].timeStamp, 10 * GPS::microsecondsPerSecond);
+    BOOST_CHECK_EQUAL(reread[1].timeStamp, -20 * GPS::microsecondsPerSecond);
+    BOOST_CHECK_EQUAL(reread[1].waypoint.altitude(), 6);
+    std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyTrack){
+    const std::string filePath = temporaryPath("empty");
+    GPS::writeTrackFile(filePath, {});
+
+    // Ensure a track file may hold no points
+    BOOST_CHECK(GPS::TrackFile {filePath}.trackPoints().empty());
+    std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidFilesRejected){
+    const std::vector<GPS::Trackpoint> trackPoints = {{GPS::Waypoint {1, 2, 3}, 10}, {GPS::Waypoint {4, 5, 6}, 20}};
+    const std::string filePath = temporaryPath("invalid");
+    GPS::writeTrackFile(filePath, trackPoints);
+    const std::string valid = contentsOf(filePath);
+
+    auto corrupted = [&valid](std::size_t offset, char byte) { std::string contents = valid; contents[offset] = byte; return contents; };
+    const std::vector<std::string> invalidContents = {
+        "", "GPSTRACK", corrupted(0, 'X'), corrupted(8, 3), corrupted(12, 16), corrupted(16, 3),
+        corrupted(40, '\x01'), corrupted(88, '\x01'), valid.substr(0, valid.size() - 1), valid + '\0',
+    };
+
+    // Ensure bad magic, versions, sizes, counts, checksums and lengths are each rejected
+    for (const std::string& contents : invalidContents)
+    {
+        overwrite(filePath, contents);
+        BOOST_CHECK_THROW(GPS::TrackFile {filePath}, std::domain_error);
+    }
+    std::filesystem::remove(filePath);
+
+    // Ensure a missing file is reported as such
+    BOOST_CHECK_THROW(GPS::TrackFile {filePath}, std::system_error);
+}
+
+BOOST_AUTO_TEST_CASE(OutOfRangePositionsRejected){
+    const std::vector<GPS::Trackpoint> trackPoints = {{GPS::Waypoint {1, 2, 3}, 10}, {GPS::Waypoint {4, 5, 6}, 20}};
+    const std::string filePath = temporaryPath("out-of-range");
+    GPS::writeTrackFile(filePath, trackPoints);
+    const std::string valid = contentsOf(filePath);
+
+    // Replace a field of the second record, keeping the checksum correct so that only the value is wrong.
+    auto withField = [&valid](std::size_t fieldOffset, double value, char version)
+    {
+        std::string contents = valid;
+        std::memcpy(contents.data() + 64 + fieldOffset, &value, sizeof value);
+        contents[8] = version;
+        const std::uint64_t checksum = GPS::trackFileChecksum(reinterpret_cast<const unsigned char*>(contents.data()) + 32, 64);
+        std::memcpy(contents.data() + 24, &checksum, sizeof checksum);
+        return contents;
+    };
+
+    // Ensure each out-of-range field is rejected, both where the records are used in place (version 2)
+    // and where they are decoded (version 1)
+    for (char version : {'\x02', '\x01'})
+    {
+        const std::vector<std::string> invalidContents = {
+            withField(0, 90.5, version), withField(0, std::nan(""), version), withField(8, -180.5, version), withField(16, -7e6, version),
+        };
+        for (const std::string& contents : invalidContents)
+        {
+            overwrite(filePath, contents);
+            BOOST_CHECK_THROW(GPS::TrackFile {filePath}, std::domain_error);
+            BOOST_CHECK_THROW(GPS::readTrackFile(filePath), std::domain_error);
+        }
+
+        // Ensure the limits themselves are accepted
+        overwrite(filePath, withField(0, -90, version));
+        BOOST_CHECK_EQUAL(GPS::TrackFile {filePath}.trackPoints()[1].waypoint.latitude(), -90);
+    }
+    std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
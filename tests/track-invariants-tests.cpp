@@ -0,0 +1,123 @@
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "track.h"
+#include "track-invariants.h"
+
+
+BOOST_AUTO_TEST_SUITE(TrackInvariantsTests)
+
+using GPS::Trackpoint;
+using GPS::TrackViolation;
+using GPS::Waypoint;
+
+const GPS::microseconds second = GPS::microsecondsPerSecond;
+const GPS::metres infinity = std::numeric_limits<GPS::metres>::infinity();
+
+const std::vector<Trackpoint> walk = {
+    {Waypoint {0, 0, 100}, 0},
+    {Waypoint {0.001, 0, 150}, 20 * second},
+    {Waypoint {0.001, 0.001, 120}, 30 * second},
+    {Waypoint {0, 0.001, 110}, 50 * second},
+};
+
+BOOST_AUTO_TEST_CASE(InvariantsFoundOnConstruction){
+    std::vector<Trackpoint> trackPoints = walk;
+    trackPoints[2].timeStamp = trackPoints[1].timeStamp;
+    trackPoints[3].timeStamp = 0;
+    trackPoints[3].waypoint = Waypoint {0, 0.001, infinity};
+    const GPS::Track track {trackPoints};
+
+    // Ensure the first point that breaks each invariant is recorded
+    BOOST_CHECK_EQUAL(track.invariants().pointCount, 4u);
+    BOOST_CHECK(track.invariants().hasLegs());
+    BOOST_CHECK(! track.invariants().timesIncrease());
+    BOOST_CHECK_EQUAL(track.invariants().firstNonIncreasingTime.value(), 2u);
+    BOOST_CHECK(! track.invariants().altitudesFinite());
+    BOOST_CHECK_EQUAL(track.invariants().firstInfiniteAltitude.value(), 3u);
+
+    // Ensure a good track breaks none
+    const GPS::Track goodTrack {walk};
+    BOOST_CHECK(goodTrack.invariants().timesIncrease());
+    BOOST_CHECK(goodTrack.invariants().altitudesFinite());
+    BOOST_CHECK(! GPS::Track {std::vector<Trackpoint> {}}.invariants().hasPoints());
+    BOOST_CHECK(! GPS::Track {{walk[0]}}.invariants().hasLegs());
+
+    // Ensure copies keep the invariants
+    BOOST_CHECK_EQUAL(GPS::Track {track}.invariants().firstNonIncreasingTime.value(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(QueriesUseTheInvariants){
+    std::vector<Trackpoint> trackPoints = walk;
+    trackPoints[3].timeStamp = trackPoints[2].timeStamp;
+    const GPS::Track track {trackPoints};
+
+    // Ensure queries that need increasing times report the offending point
+    try
+    {
+        track.lastWaypointBefore(25 * second);
+        BOOST_ERROR("No exception thrown for times that do not increase.");
+    }
+    catch (const std::domain_error& e)
+    {
+        BOOST_CHECK(std::string {e.what()}.find("track point 3") != std::string::npos);
+    }
+
+    // Ensure they throw without first building the values of the legs
+    BOOST_CHECK_THROW(track.maxSpeed(), std::domain_error);
+    BOOST_CHECK_THROW(track.restingTime(1), std::domain_error);
+    BOOST_CHECK_THROW(track.averageTravellingSpeed(1), std::domain_error);
+    BOOST_CHECK(! track.hasLegCache());
+
+    // Ensure queries that do not need increasing times still succeed
+    BOOST_CHECK_EQUAL(track.totalLength(), GPS::Track {walk}.totalLength());
+    BOOST_CHECK_EQUAL(track.highestWaypoint().altitude(), 150);
+}
+
+BOOST_AUTO_TEST_CASE(ValidatedFactory){
+    // Ensure valid points are made into a Track
+    const GPS::ValidatedTrack accepted = GPS::Track::validated(walk);
+    BOOST_REQUIRE(accepted.has_value());
+    BOOST_CHECK(static_cast<bool>(accepted));
+    BOOST_CHECK_EQUAL(accepted.value().numberOfWaypoints(), 4u);
+    BOOST_CHECK_EQUAL(accepted->totalTime(), 50);
+    BOOST_CHECK(accepted->invariants().timesIncrease());
+    BOOST_CHECK_THROW(accepted.error(), std::logic_error);
+
+    // Ensure each violation is reported, without throwing, with the offending point
+    std::vector<Trackpoint> stalled = walk;
+    stalled[2].timeStamp = stalled[1].timeStamp;
+    const GPS::ValidatedTrack rejectedTime = GPS::Track::validated(stalled);
+    BOOST_REQUIRE(! rejectedTime.has_value());
+    BOOST_CHECK_EQUAL(rejectedTime.error().kind, TrackViolation::NonIncreasingTime);
+    BOOST_CHECK_EQUAL(rejectedTime.error().pointIndex, 2u);
+    BOOST_CHECK_THROW(rejectedTime.value(), std::logic_error);
+
+    std::vector<Trackpoint> soaring = walk;
+    soaring[1].waypoint = Waypoint {0.001, 0, infinity};
+    const GPS::ValidatedTrack rejectedAltitude = GPS::Track::validated(soaring);
+    BOOST_REQUIRE(! rejectedAltitude);
+    BOOST_CHECK_EQUAL(rejectedAltitude.error().kind, TrackViolation::InfiniteAltitude);
+    BOOST_CHECK_EQUAL(rejectedAltitude.error().pointIndex, 1u);
+
+    BOOST_CHECK_EQUAL(GPS::Track::validated({}).error().kind, TrackViolation::NoPoints);
+
+    GPS::SensorData sensorData;
+    sensorData.append({});
+    BOOST_CHECK_EQUAL(GPS::Track::validated(walk, sensorData).error().kind, TrackViolation::SensorCountMismatch);
+
+    // Ensure the earliest violation in the track is the one reported
+    soaring[3].timeStamp = 0;
+    BOOST_CHECK_EQUAL(GPS::Track::validated(soaring).error().kind, TrackViolation::InfiniteAltitude);
+    stalled[3].waypoint = Waypoint {0, 0.001, infinity};
+    BOOST_CHECK_EQUAL(GPS::Track::validated(stalled).error().kind, TrackViolation::NonIncreasingTime);
+
+    // Ensure the description names the offending point
+    BOOST_CHECK_EQUAL(rejectedTime.error().description(), "The time of track point 2 is not after that of the point before it.");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
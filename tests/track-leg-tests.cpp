@@ -0,0 +1,85 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track.h"
+#include "track-leg.h"
+
+
+BOOST_AUTO_TEST_SUITE(TrackLegTests)
+
+using GPS::Trackpoint;
+using GPS::Waypoint;
+
+BOOST_AUTO_TEST_CASE(LegColumnsMatchLegs){
+    const std::vector<Trackpoint> trackPoints = {
+        {Waypoint {0, 0, 100}, 0},
+        {Waypoint {0.001, 0, 150}, 20 * GPS::microsecondsPerSecond},
+        {Waypoint {0.001, 0.001, 120}, 30 * GPS::microsecondsPerSecond},
+    };
+    const GPS::LegColumns legs {GPS::PointColumns {trackPoints}};
+    const GPS::Leg secondLeg {trackPoints[1], trackPoints[2]};
+
+    // Ensure there is one value in each column per leg, exactly as the Leg gives it
+    BOOST_REQUIRE_EQUAL(legs.size(), 2u);
+    BOOST_CHECK_EQUAL(legs.distances[1], secondLeg.distance());
+    BOOST_CHECK_EQUAL(legs.altitudeChanges[1], -30);
+    BOOST_CHECK_EQUAL(legs.durations[1], 10 * GPS::microsecondsPerSecond);
+    BOOST_CHECK_EQUAL(legs.speeds[1], secondLeg.averageSpeed());
+    BOOST_CHECK_EQUAL(legs.gradients[1], secondLeg.gradient());
+    BOOST_CHECK_GE(legs.capacityInBytes(), 2 * 5 * sizeof(double));
+
+    // Ensure a track with too few points has no legs
+    BOOST_CHECK_EQUAL(GPS::LegColumns {GPS::PointColumns {std::vector<Trackpoint> {}}}.size(), 0u);
+    BOOST_CHECK_EQUAL(GPS::LegColumns {GPS::PointColumns {std::span {trackPoints}.first(1)}}.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(CacheBuiltOnFirstUseAndReleased){
+    const GPS::Track track {GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx")};
+
+    // Ensure queries that do not need the legs leave them unbuilt
+    track.highestWaypoint();
+    BOOST_CHECK(track.hasPointColumns());
+    BOOST_CHECK(! track.hasLegCache());
+
+    // Ensure the legs are kept after a query that needs them, and shared by copies of the track
+    const GPS::metres length = track.totalLength();
+    BOOST_CHECK(track.hasLegCache());
+    const GPS::Track copy {track};
+    BOOST_CHECK(copy.hasLegCache());
+
+    // Ensure releasing the legs changes no results
+    track.releaseCaches();
+    BOOST_CHECK(! track.hasPointColumns());
+    BOOST_CHECK(! track.hasLegCache());
+    BOOST_CHECK(copy.hasLegCache());
+    BOOST_CHECK_EQUAL(track.totalLength(), length);
+    BOOST_CHECK_EQUAL(copy.totalLength(), length);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentQueries){
+    const GPS::Track track {GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx")};
+    const GPS::seconds expected = GPS::Track {track.points()}.travellingTime(20);
+    std::atomic<int> wrongResults {0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 50; ++j)
+            {
+                if (track.travellingTime(20) != expected) ++wrongResults;
+                if (i == 0) track.releaseCaches();
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    // Ensure queries from several threads, while the legs are released and rebuilt, all agree
+    BOOST_CHECK_EQUAL(wrongResults, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
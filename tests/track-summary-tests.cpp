@@ -0,0 +1,156 @@
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gpx-parser.h"
+#include "track.h"
+#include "track-summary.h"
+
+
+BOOST_AUTO_TEST_SUITE(TrackSummaryTests)
+
+using GPS::Trackpoint;
+using GPS::Waypoint;
+
+const GPS::microseconds second = GPS::microsecondsPerSecond;
+
+/* Heading north along the meridian: 111 m in 100 s, a 10-second rest, 111 m climbing 50 m in 20 s,
+ * and back 111 m descending 50 m in 50 s.  The second, third and last points are in the same place.
+ */
+const std::vector<Trackpoint> walk = {
+    {Waypoint {0, 0, 100}, 0},
+    {Waypoint {0.001, 0, 100}, 100 * second},
+    {Waypoint {0.001, 0, 100}, 110 * second},
+    {Waypoint {0.002, 0, 150}, 130 * second},
+    {Waypoint {0.001, 0, 100}, 180 * second},
+};
+
+// Compare each query, including whether it throws and with what message, by calling it on both.
+void checkSameResults(const std::vector<Trackpoint>& trackPoints, GPS::TrackSummaryOptions options)
+{
+    const GPS::Track track {trackPoints};
+    const GPS::TrackSummary summary {track, options};
+    const Waypoint target = options.targetWaypoint.value_or(Waypoint {0, 0, 0});
+    const GPS::speed resting = options.restingSpeedThreshold;
+    const GPS::speed travelling = options.travellingSpeedThreshold;
+
+    const auto check = [](const char* query, std::function<double()> fromTrack, std::function<double()> fromSummary) {
+        BOOST_TEST_CONTEXT(query)
+        {
+            double expected = 0;
+            try { expected = fromTrack(); }
+            catch (const std::domain_error& error)
+            {
+                const std::string message = error.what();
+                BOOST_CHECK_EXCEPTION(fromSummary(), std::domain_error, [&message](const std::domain_error& e) { return e.what() == message; });
+                return;
+            }
+            catch (const std::invalid_argument&) { BOOST_CHECK_THROW(fromSummary(), std::invalid_argument); return; }
+            BOOST_CHECK_EQUAL(fromSummary(), expected);
+        }
+    };
+    const auto checkWaypoint = [&check](const char* query, std::function<Waypoint()> fromTrack, std::function<Waypoint()> fromSummary) {
+        check(query, [&]{ return fromTrack().latitude(); }, [&]{ return fromSummary().latitude(); });
+        check(query, [&]{ return fromTrack().altitude(); }, [&]{ return fromSummary().altitude(); });
+    };
+
+    check("numberOfWaypoints", [&]{ return track.numberOfWaypoints(); }, [&]{ return summary.numberOfWaypoints(); });
+    check("totalTime", [&]{ return track.totalTime(); }, [&]{ return summary.totalTime(); });
+    check("netHeightGain", [&]{ return track.netHeightGain(); }, [&]{ return summary.netHeightGain(); });
+    check("totalHeightGain", [&]{ return track.totalHeightGain(); }, [&]{ return summary.totalHeightGain(); });
+    check("netLength", [&]{ return track.netLength(); }, [&]{ return summary.netLength(); });
+    check("totalLength", [&]{ return track.totalLength(); }, [&]{ return summary.totalLength(); });
+    check("averageSpeed", [&]{ return track.averageSpeed(); }, [&]{ return summary.averageSpeed(); });
+    checkWaypoint("highestWaypoint", [&]{ return track.highestWaypoint(); }, [&]{ return summary.highestWaypoint(); });
+    checkWaypoint("lowestWaypoint", [&]{ return track.lowestWaypoint(); }, [&]{ return summary.lowestWaypoint(); });
+    checkWaypoint("mostNorthelyWaypoint", [&]{ return track.mostNorthelyWaypoint(); }, [&]{ return summary.mostNorthelyWaypoint(); });
+    checkWaypoint("mostSoutherlyWaypoint", [&]{ return track.mostSoutherlyWaypoint(); }, [&]{ return summary.mostSoutherlyWaypoint(); });
+    checkWaypoint("mostEasterlyWaypoint", [&]{ return track.mostEasterlyWaypoint(); }, [&]{ return summary.mostEasterlyWaypoint(); });
+    checkWaypoint("mostWesterlyWaypoint", [&]{ return track.mostWesterlyWaypoint(); }, [&]{ return summary.mostWesterlyWaypoint(); });
+    checkWaypoint("mostEquatorialWaypoint", [&]{ return track.mostEquatorialWaypoint(); }, [&]{ return summary.mostEquatorialWaypoint(); });
+    checkWaypoint("leastEquatorialWaypoint", [&]{ return track.leastEquatorialWaypoint(); }, [&]{ return summary.leastEquatorialWaypoint(); });
+    check("maxSpeed", [&]{ return track.maxSpeed(); }, [&]{ return summary.maxSpeed(); });
+    check("maxRateOfAscent", [&]{ return track.maxRateOfAscent(); }, [&]{ return summary.maxRateOfAscent(); });
+    check("maxRateOfDescent", [&]{ return track.maxRateOfDescent(); }, [&]{ return summary.maxRateOfDescent(); });
+    check("maxGradient", [&]{ return track.maxGradient(); }, [&]{ return summary.maxGradient(); });
+    check("minGradient", [&]{ return track.minGradient(); }, [&]{ return summary.minGradient(); });
+    check("steepestGradient", [&]{ return track.steepestGradient(); }, [&]{ return summary.steepestGradient(); });
+    checkWaypoint("nearestWaypointTo", [&]{ return track.nearestWaypointTo(target); }, [&]{ return summary.nearestWaypointTo(); });
+    checkWaypoint("farthestWaypointFrom", [&]{ return track.farthestWaypointFrom(target); }, [&]{ return summary.farthestWaypointFrom(); });
+    check("numberOfWaypointsNear", [&]{ return track.numberOfWaypointsNear(target, options.nearDistance); }, [&]{ return summary.numberOfWaypointsNear(); });
+    check("proportionOfWaypointsNear", [&]{ return track.proportionOfWaypointsNear(target, options.nearDistance); }, [&]{ return summary.proportionOfWaypointsNear(); });
+    check("restingTime", [&]{ return track.restingTime(resting); }, [&]{ return summary.restingTime(); });
+    check("travellingTime", [&]{ return track.travellingTime(travelling); }, [&]{ return summary.travellingTime(); });
+    check("longestRestingPeriod", [&]{ return track.longestRestingPeriod(resting); }, [&]{ return summary.longestRestingPeriod(); });
+    check("longestTravellingPeriod", [&]{ return track.longestTravellingPeriod(travelling); }, [&]{ return summary.longestTravellingPeriod(); });
+    check("averageRestingPeriod", [&]{ return track.averageRestingPeriod(resting); }, [&]{ return summary.averageRestingPeriod(); });
+    check("averageTravellingPeriod", [&]{ return track.averageTravellingPeriod(travelling); }, [&]{ return summary.averageTravellingPeriod(); });
+    check("proportionRestingTime", [&]{ return track.proportionRestingTime(resting); }, [&]{ return summary.proportionRestingTime(); });
+    check("proportionTravellingTime", [&]{ return track.proportionTravellingTime(travelling); }, [&]{ return summary.proportionTravellingTime(); });
+    check("averageTravellingSpeed", [&]{ return track.averageTravellingSpeed(travelling); }, [&]{ return summary.averageTravellingSpeed(); });
+    check("durationBeforeTravellingBegins", [&]{ return track.durationBeforeTravellingBegins(travelling); }, [&]{ return summary.durationBeforeTravellingBegins(); });
+}
+
+BOOST_AUTO_TEST_CASE(TrackQueries){
+    const GPS::Track track {walk};
+
+    // Ensure the queries measure the legs between points, counting a run of resting legs as one period
+    BOOST_CHECK_EQUAL(track.totalTime(), 180);
+    BOOST_CHECK_EQUAL(track.totalHeightGain(), 50);
+    BOOST_CHECK_EQUAL(track.netHeightGain(), 0);
+    BOOST_CHECK_CLOSE(track.netLength(), 111.2, 0.1);
+    BOOST_CHECK_CLOSE(track.maxRateOfAscent(), 2.5, 1e-9);
+    BOOST_CHECK_CLOSE(track.maxRateOfDescent(), 1, 1e-9);
+    BOOST_CHECK_CLOSE(track.steepestGradient(), 24.2, 0.1);
+    BOOST_CHECK_EQUAL(track.restingTime(0.5), 10);
+    BOOST_CHECK_EQUAL(track.longestTravellingPeriod(2), 70);
+    BOOST_CHECK_EQUAL(track.durationBeforeTravellingBegins(2), 110);
+    BOOST_CHECK_EQUAL(track.averageTravellingPeriod(1), 85);
+
+    // Ensure ties go to the earlier point, except for the farthest point
+    BOOST_CHECK_EQUAL(track.mostNorthelyWaypoint().altitude(), 150);
+    BOOST_CHECK_EQUAL(track.nearestWaypointTo(Waypoint {0.001, 0, 100}).altitude(), 100);
+    BOOST_CHECK_EQUAL(track.farthestWaypointFrom(Waypoint {0.0015, 0, 125}).altitude(), 100);
+    BOOST_CHECK_EQUAL(track.numberOfWaypointsNear(Waypoint {0.001, 0, 100}, 0), 3u);
+    BOOST_CHECK_EQUAL(track.lastWaypointBefore(110 * second).latitude(), 0.001);
+    BOOST_CHECK_EQUAL(track.firstWaypointAfter(110 * second).latitude(), 0.002);
+
+    // Ensure queries that cannot be answered are reported
+    BOOST_CHECK_THROW(track.averageTravellingPeriod(10), std::domain_error);
+    BOOST_CHECK_THROW(track.firstWaypointAfter(180 * second), std::domain_error);
+    BOOST_CHECK_THROW(track.numberOfWaypointsNear(Waypoint {0, 0, 0}, -1), std::invalid_argument);
+    BOOST_CHECK_THROW(GPS::Track {{walk[0]}}.maxSpeed(), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(SameResultsAsTrack){
+    const std::vector<Trackpoint> sample = GPS::GPX::parseTrackFile("data/NorthYorkMoors.gpx");
+    const Waypoint target = sample[sample.size() / 2].waypoint;
+
+    // Ensure every query gives exactly the result of the Track member function
+    checkSameResults(walk, {0.5, 2, Waypoint {0.001, 0, 100}, 0});
+    checkSameResults(walk, {0, 0, Waypoint {0.0015, 0, 125}, 60});
+    checkSameResults(sample, {15, 30, target, 500});
+    checkSameResults(sample, {0, 100, target, 0});
+}
+
+BOOST_AUTO_TEST_CASE(SameErrorsAsTrack){
+    std::vector<Trackpoint> backwards = walk;
+    backwards[2].timeStamp = backwards[1].timeStamp;
+    std::vector<Trackpoint> finishesFirst = {walk[3], walk[0]};
+
+    // Ensure queries throw for the same tracks as the Track member functions
+    checkSameResults({}, {0, 0, Waypoint {0, 0, 0}, 10});
+    checkSameResults({walk[0]}, {0, 0, Waypoint {0, 0, 0}, 10});
+    checkSameResults(backwards, {0.5, 2, Waypoint {0, 0, 0}, 10});
+    checkSameResults(finishesFirst, {0.5, 2, Waypoint {0, 0, 0}, -1});
+
+    // Ensure the queries relative to a waypoint need one
+    const GPS::TrackSummary summary {GPS::Track {walk}};
+    BOOST_CHECK_THROW(summary.nearestWaypointTo(), std::logic_error);
+    BOOST_CHECK_THROW(summary.numberOfWaypointsNear(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
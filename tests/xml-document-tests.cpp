@@ -0,0 +1,80 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "xml-parser.h"
+#include "xml-document.h"
+
+
+BOOST_AUTO_TEST_SUITE(XMLDocumentTests)
+
+const std::string mixedXML =
+    "<gpx creator=\"a\" creator=\"b\">"
+    "<wpt lat=\"1\" lon=\"2\"/>"
+    "<trk><trkpt lat=\"3\" lon=\"4\"><ele>5</ele></trkpt></trk>"
+    "<wpt lat=\"6\" lon=\"7\"/>"
+    "</gpx>";
+
+
+BOOST_AUTO_TEST_CASE(SubElementsKeepDocumentOrder){
+    XML::Parser parser {std::string_view{mixedXML}};
+    XML::Document document {parser};
+
+    std::vector<std::string_view> names;
+    for (const XML::Node& subElement : document.getRootElement().getSubElements())
+    {
+        names.push_back(subElement.getName());
+    }
+
+    // Ensure mixed sub-elements are visited in the order they appear
+    BOOST_CHECK((names == std::vector<std::string_view>{"wpt", "trk", "wpt"}));
+    BOOST_CHECK_EQUAL(document.getRootElement().countSubElements("wpt"), 2u);
+    BOOST_CHECK_EQUAL(document.getRootElement().getSubElement("wpt", 1).getAttribute("lat"), "6");
+}
+
+BOOST_AUTO_TEST_CASE(LookupsMatchElementTree){
+    XML::Parser treeParser {std::string_view{mixedXML}};
+    XML::Parser documentParser {std::string_view{mixedXML}};
+    XML::Element tree = treeParser.parseRootElement();
+    XML::Document document {documentParser};
+    const XML::Node& root = document.getRootElement();
+
+    // Ensure the Document answers the same queries as the Element tree
+    BOOST_CHECK_EQUAL(root.getAttribute("creator"), tree.getAttribute("creator"));
+    BOOST_CHECK_EQUAL(root.getSubElement("trk").getSubElement("trkpt").getSubElement("ele").getLeafContent(),
+                      tree.getSubElement("trk").getSubElement("trkpt").getSubElement("ele").getLeafContent());
+    BOOST_CHECK_EQUAL(root.containsSubElement("rte"), tree.containsSubElement("rte"));
+    BOOST_CHECK_EQUAL(root.getSubElement("wpt").isLeaf(), tree.getSubElement("wpt").isLeaf());
+    BOOST_CHECK_THROW(root.getSubElement("wpt", 2), std::out_of_range);
+    BOOST_CHECK_THROW(root.getAttribute("version"), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(NamesAreInterned){
+    XML::Parser parser {std::string_view{mixedXML}};
+    XML::Document document {parser};
+    const XML::Node& root = document.getRootElement();
+
+    // Ensure repeated names share a single copy
+    BOOST_CHECK(root.getSubElement("wpt", 0).getName().data() == root.getSubElement("wpt", 1).getName().data());
+    BOOST_CHECK(root.getSubElement("wpt").getAttributes()[0].name.data() == root.getSubElement("trk").getSubElement("trkpt").getAttributes()[0].name.data());
+}
+
+BOOST_AUTO_TEST_CASE(IndexedLookups){
+    std::string manyPointsXML = "<trkseg>";
+    for (int i = 0; i < 100; ++i)
+    {
+        manyPointsXML += "<trkpt n=\"" + std::to_string(i) + "\"/>";
+        if (i % 10 == 0) manyPointsXML += "<extensions/>";
+    }
+    manyPointsXML += "</trkseg>";
+    XML::Parser parser {std::string_view{manyPointsXML}};
+    XML::Document document {parser};
+
+    // Ensure lookups on an element with many sub-elements still respect document order
+    BOOST_CHECK_EQUAL(document.getRootElement().countSubElements("trkpt"), 100u);
+    BOOST_CHECK_EQUAL(document.getRootElement().countSubElements("extensions"), 10u);
+    BOOST_CHECK_EQUAL(document.getRootElement().getSubElement("trkpt", 57).getAttribute("n"), "57");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
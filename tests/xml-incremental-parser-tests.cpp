@@ -0,0 +1,204 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include "xml-incremental-parser.h"
+#include "xml-parser.h"
+
+
+BOOST_AUTO_TEST_SUITE(XMLIncrementalParserTests)
+
+const std::string sampleXML =
+    "<?xml version=\"1.0\"?>\n"
+    "<gpx version=\"1.1\">\n"
+    "  <trk><name>Test</name>\n"
+    "    <trkpt lat=\"1.5\" lon=\"-2.5\"><ele>10</ele></trkpt>\n"
+    "    <trkpt lat=\"3\" lon=\"4\"/>\n"
+    "    <extensions>ignored<hr>150</hr></extensions>\n"
+    "  </trk>\n"
+    "</gpx>\n";
+
+void appendToTrace(std::string& trace, const XML::Event& event)
+{
+    switch (event.type)
+    {
+      case XML::Event::Type::StartElement:
+        trace += "<" + std::string{event.name};
+        for (const XML::AttributeView& attribute : event.attributes)
+        {
+            trace += " " + std::string{attribute.name} + "=" + std::string{attribute.value};
+        }
+        trace += ">";
+        break;
+      case XML::Event::Type::Text:
+        trace += "[" + std::string{event.text} + "]";
+        break;
+      case XML::Event::Type::EndElement:
+        trace += "</" + std::string{event.name} + ">";
+        break;
+      case XML::Event::Type::EndOfDocument:
+        trace += "$";
+        break;
+    }
+}
+
+std::string traceInChunks(const std::string& xml, std::size_t chunkSize, XML::PathFilter filter = {})
+{
+    std::string trace;
+    XML::IncrementalParser parser {[&trace](const XML::Event& event) { appendToTrace(trace, event); }, filter};
+    for (std::size_t start = 0; start < xml.size(); start += chunkSize)
+    {
+        parser.feed(xml.data() + start, std::min(chunkSize, xml.size() - start));
+    }
+    parser.finish();
+    return trace;
+}
+
+
+BOOST_AUTO_TEST_CASE(ChunkBoundariesDoNotAffectEvents){
+    XML::Parser pullParser {std::string_view{sampleXML}};
+    std::string expectedTrace;
+    XML::Event event;
+    do
+    {
+        event = pullParser.nextEvent();
+        appendToTrace(expectedTrace, event);
+    }
+    while (event.type != XML::Event::Type::EndOfDocument);
+
+    // Ensure every way of splitting the document produces the same events as the pull parser
+    for (std::size_t chunkSize = 1; chunkSize <= sampleXML.size(); ++chunkSize)
+    {
+        BOOST_CHECK_EQUAL(traceInChunks(sampleXML, chunkSize), expectedTrace);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ChunkBoundariesDoNotAffectSkipping){
+    const std::string expectedTrace = "<gpx version=1.1><trk><trkpt lat=1.5 lon=-2.5></trkpt><trkpt lat=3 lon=4></trkpt></trk></gpx>$";
+
+    // Ensure skipped elements may be split across chunks
+    for (std::size_t chunkSize = 1; chunkSize <= sampleXML.size(); ++chunkSize)
+    {
+        BOOST_CHECK_EQUAL(traceInChunks(sampleXML, chunkSize, {"gpx/trk/trkpt"}), expectedTrace);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LongSkippedRunNotHeldInBuffer){
+    const std::string waypoint = "<wpt lat=\"1\" lon=\"2\"><ele>3</ele><name>Skipped</name></wpt>\n";
+    std::string xml = "<gpx>";
+    for (int i = 0; i < 2000; ++i) xml += waypoint;
+    xml += "<trk><trkpt lat=\"5\" lon=\"6\"/></trk></gpx>";
+
+    std::string trace;
+    XML::IncrementalParser parser {[&trace](const XML::Event& event) { appendToTrace(trace, event); }, {"gpx/trk/trkpt"}};
+    const std::size_t chunkSize = 100;
+    std::size_t mostBuffered = 0;
+    for (std::size_t start = 0; start < xml.size(); start += chunkSize)
+    {
+        parser.feed(xml.data() + start, std::min(chunkSize, xml.size() - start));
+        mostBuffered = std::max(mostBuffered, parser.bufferedSize());
+    }
+    parser.finish();
+
+    // Ensure the run of skipped siblings is consumed as it arrives, rather than kept until the next event
+    BOOST_CHECK_EQUAL(trace, "<gpx><trk><trkpt lat=5 lon=6></trkpt></trk></gpx>$");
+    BOOST_CHECK_LE(mostBuffered, chunkSize + waypoint.size());
+}
+
+BOOST_AUTO_TEST_CASE(LargeSkippedElementNotHeldInBuffer){
+    const std::string routePoint = "<rtept lat=\"1\" lon=\"2\"><ele>3</ele><name>Skipped</name><extensions><hr>60</hr></extensions></rtept>\n";
+    std::string route = "<rte><name>Route</name>";
+    for (int i = 0; i < 2000; ++i) route += routePoint;
+    route += "</rte>";
+    const std::string xml = "<gpx>" + route + "<trk><trkpt lat=\"5\" lon=\"6\"/></trk></gpx>";
+
+    const std::size_t chunkSize = 100;
+    auto feedInChunks = [chunkSize](XML::IncrementalParser& parser, const std::string& text)
+    {
+        std::size_t mostBuffered = 0;
+        for (std::size_t start = 0; start < text.size(); start += chunkSize)
+        {
+            parser.feed(text.data() + start, std::min(chunkSize, text.size() - start));
+            mostBuffered = std::max(mostBuffered, parser.bufferedSize());
+        }
+        return mostBuffered;
+    };
+
+    std::string trace;
+    XML::IncrementalParser parser {[&trace](const XML::Event& event) { appendToTrace(trace, event); }, {"gpx/trk/trkpt"}};
+    const std::size_t mostBuffered = feedInChunks(parser, xml);
+    parser.finish();
+
+    // Ensure a skipped element is consumed tag by tag as it arrives, rather than kept until it ends
+    BOOST_CHECK_EQUAL(trace, "<gpx><trk><trkpt lat=5 lon=6></trkpt></trk></gpx>$");
+    BOOST_CHECK_LE(mostBuffered, chunkSize + routePoint.size());
+
+    // Ensure a mismatched tag deep within it is still reported, with the path to the skipped element
+    std::string mismatched = "<gpx>" + route;
+    mismatched.insert(mismatched.rfind("</rtept>"), "</ele>");
+    XML::IncrementalParser failingParser {[](const XML::Event&) {}, {"gpx/trk/trkpt"}};
+    BOOST_CHECK_EXCEPTION(feedInChunks(failingParser, mismatched), XML::ParseError,
+                          [](const XML::ParseError& e) { return e.elementPath() == "gpx/rte/rtept"; });
+
+    // Ensure a skipped element that is never closed is reported at the end of the input
+    XML::IncrementalParser truncatedParser {[](const XML::Event&) {}, {"gpx/trk/trkpt"}};
+    feedInChunks(truncatedParser, "<gpx>" + route.substr(0, route.size() / 2));
+    BOOST_CHECK_THROW(truncatedParser.finish(), XML::ParseError);
+}
+
+BOOST_AUTO_TEST_CASE(EventsArriveBeforeTheEndOfInput){
+    std::string trace;
+    XML::IncrementalParser parser {[&trace](const XML::Event& event) { appendToTrace(trace, event); }};
+    const std::string firstChunk = "<gpx><trk><name>Te";
+    parser.feed(firstChunk.data(), firstChunk.size());
+
+    // Ensure completed tokens are reported straight away, and unfinished ones are held back
+    BOOST_CHECK_EQUAL(trace, "<gpx><trk><name>");
+    BOOST_CHECK(! parser.isComplete());
+
+    const std::string secondChunk = "st</name></trk></gpx>trailing";
+    parser.feed(secondChunk.data(), secondChunk.size());
+    BOOST_CHECK_EQUAL(trace, "<gpx><trk><name>[Test]</name></trk></gpx>$");
+    BOOST_CHECK(parser.isComplete());
+}
+
+BOOST_AUTO_TEST_CASE(TruncatedDocumentRejectedAtFinish){
+    XML::IncrementalParser parser {[](const XML::Event&) {}};
+    const std::string truncatedXML = sampleXML.substr(0, sampleXML.find("</trk>") + 3);
+    parser.feed(truncatedXML.data(), truncatedXML.size());
+
+    // Ensure an incomplete document is only rejected once no more input can arrive
+    BOOST_CHECK_THROW(parser.finish(), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(MalformedXMLRejectedWhenFed){
+    XML::IncrementalParser parser {[](const XML::Event&) {}};
+    const std::string mismatchedXML = "<gpx><trk></gpx>";
+
+    // Ensure errors are reported as soon as they are seen, without waiting for finish()
+    BOOST_CHECK_THROW(parser.feed(mismatchedXML.data(), mismatchedXML.size()), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(ErrorPositionCountsDiscardedText){
+    const std::string mismatchedXML = "<gpx>\n  <trk>\n    <trkpt lat=\"1\"></trk>\n</gpx>";
+
+    // Ensure positions are within the whole document, not the current chunk
+    for (std::size_t chunkSize : {1, 4, 100})
+    {
+        try
+        {
+            traceInChunks(mismatchedXML, chunkSize);
+            BOOST_FAIL("No error reported");
+        }
+        catch (const XML::ParseError& error)
+        {
+            BOOST_CHECK_EQUAL(error.offset(), mismatchedXML.find("</trk>"));
+            BOOST_CHECK_EQUAL(error.line(), 3u);
+            BOOST_CHECK_EQUAL(error.column(), 20u);
+            BOOST_CHECK_EQUAL(error.elementPath(), "gpx/trk/trkpt");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "xml-parser.h"
+
+
+BOOST_AUTO_TEST_SUITE(XMLParserTests)
+
+const std::string sampleXML =
+    "<?xml version=\"1.0\"?>\n"
+    "<gpx version=\"1.1\">\n"
+    "  <trk><name>Test</name>\n"
+    "    <trkpt lat=\"1.5\" lon=\"-2.5\"><ele>10</ele></trkpt>\n"
+    "    <trkpt lat=\"3\" lon=\"4\"/>\n"
+    "  </trk>\n"
+    "</gpx>\n";
+
+
+BOOST_AUTO_TEST_CASE(StreamAndBufferFrontEndsAgree){
+    std::istringstream xmlStream {sampleXML};
+    XML::Parser streamParser {xmlStream};
+    XML::Parser bufferParser {std::string_view{sampleXML}};
+
+    XML::Element fromStream = streamParser.parseRootElement();
+    XML::Element fromBuffer = bufferParser.parseRootElement();
+
+    // Ensure both front ends build the same tree
+    BOOST_CHECK_EQUAL(fromStream.getName(), fromBuffer.getName());
+    BOOST_CHECK_EQUAL(fromStream.getAttribute("version"), fromBuffer.getAttribute("version"));
+    BOOST_CHECK_EQUAL(fromBuffer.getSubElement("trk").countSubElements("trkpt"), 2u);
+    BOOST_CHECK_EQUAL(fromBuffer.getSubElement("trk").getSubElement("trkpt").getAttribute("lon"), "-2.5");
+    BOOST_CHECK_EQUAL(fromBuffer.getSubElement("trk").getSubElement("trkpt").getSubElement("ele").getLeafContent(), "10");
+    BOOST_CHECK(fromBuffer.getSubElement("trk").getSubElement("trkpt",1).isLeaf());
+}
+
+BOOST_AUTO_TEST_CASE(ParserRefersToItsOwnText){
+    // Ensure a Parser, whose positions may be within text it owns, cannot be copied or moved
+    BOOST_CHECK(! std::is_copy_constructible_v<XML::Parser>);
+    BOOST_CHECK(! std::is_copy_assignable_v<XML::Parser>);
+    BOOST_CHECK(! std::is_move_constructible_v<XML::Parser>);
+    BOOST_CHECK(! std::is_move_assignable_v<XML::Parser>);
+
+    // Ensure an element sequence is returned without being moved
+    XML::Parser sequenceParser = XML::Parser::forElementSequence("<a/> <b/></c>");
+    BOOST_CHECK_EQUAL(sequenceParser.nextEvent().name, "a");
+    BOOST_CHECK(sequenceParser.nextEvent().type == XML::Event::Type::EndElement);
+    BOOST_CHECK_EQUAL(sequenceParser.nextEvent().name, "b");
+}
+
+BOOST_AUTO_TEST_CASE(TruncatedBuffer){
+    const std::string_view truncatedXML = std::string_view{sampleXML}.substr(0, sampleXML.find("</trk>"));
+    XML::Parser parser {truncatedXML};
+
+    // Ensure that running off the end of the buffer is reported as malformed XML
+    BOOST_CHECK_THROW(parser.parseRootElement(), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(UnterminatedAttributeValue){
+    XML::Parser parser {std::string_view{"<gpx version=\"1.1></gpx>"}};
+
+    // Ensure that an attribute value with no closing quote is rejected
+    BOOST_CHECK_THROW(parser.parseRootElement(), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(EventSequence){
+    XML::Parser parser {std::string_view{sampleXML}};
+    std::string trace;
+
+    for (XML::Event event = parser.nextEvent(); event.type != XML::Event::Type::EndOfDocument; event = parser.nextEvent())
+    {
+        switch (event.type)
+        {
+          case XML::Event::Type::StartElement:
+            trace += "<" + std::string{event.name};
+            for (const XML::AttributeView& attribute : event.attributes)
+            {
+                trace += " " + std::string{attribute.name} + "=" + std::string{attribute.value};
+            }
+            trace += ">";
+            break;
+          case XML::Event::Type::Text:
+            trace += "[" + std::string{event.text} + "]";
+            break;
+          case XML::Event::Type::EndElement:
+            trace += "</" + std::string{event.name} + ">";
+            break;
+          case XML::Event::Type::EndOfDocument:
+            break;
+        }
+    }
+
+    // Ensure events arrive in document order, with leaf content only for leaf elements
+    BOOST_CHECK_EQUAL(trace, "<gpx version=1.1><trk><name>[Test]</name>"
+                             "<trkpt lat=1.5 lon=-2.5><ele>[10]</ele></trkpt>"
+                             "<trkpt lat=3 lon=4></trkpt></trk></gpx>");
+}
+
+BOOST_AUTO_TEST_CASE(EventsRejectWhatTheTreeRejects){
+    const std::string mismatchedXML = "<gpx><trk></gpx></trk>";
+    XML::Parser treeParser {std::string_view{mismatchedXML}};
+    XML::Parser eventParser {std::string_view{mismatchedXML}};
+
+    auto pullAllEvents = [&eventParser]{
+        while (eventParser.nextEvent().type != XML::Event::Type::EndOfDocument) {}
+    };
+
+    // Ensure both modes reject a mismatched closing tag
+    BOOST_CHECK_THROW(treeParser.parseRootElement(), std::domain_error);
+    BOOST_CHECK_THROW(pullAllEvents(), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(ErrorPosition){
+    const std::string mismatchedXML = "<gpx>\n  <trk>\n    <trkpt lat=\"1\"></trk>\n</gpx>";
+    XML::Parser parser {std::string_view{mismatchedXML}};
+
+    // Ensure the error reports where the problem is, and within which elements
+    try
+    {
+        parser.parseRootElement();
+        BOOST_FAIL("No error reported");
+    }
+    catch (const XML::ParseError& error)
+    {
+        BOOST_CHECK_EQUAL(error.offset(), mismatchedXML.find("</trk>"));
+        BOOST_CHECK_EQUAL(error.line(), 3u);
+        BOOST_CHECK_EQUAL(error.column(), 20u);
+        BOOST_CHECK_EQUAL(error.elementPath(), "gpx/trk/trkpt");
+        BOOST_CHECK_EQUAL(std::string{error.what()}, "Malformed XML: missing closing tag for 'trkpt' at line 3, column 20 within gpx/trk/trkpt.");
+    }
+}
+
+const std::string annotatedXML =
+    "<gpx><metadata><name a=\"x>y\">Big</name><metadata><desc/></metadata></metadata>\n"
+    "  <trk><name>Test</name>\n"
+    "    <trkpt lat=\"1\"><ele>10</ele><extensions><hr>150</hr></extensions></trkpt>\n"
+    "    <trkpt lat=\"2\"/>\n"
+    "  </trk><wpt><trkpt/></wpt>\n"
+    "</gpx>\n";
+
+BOOST_AUTO_TEST_CASE(FilteredTree){
+    XML::Parser parser {std::string_view{annotatedXML}};
+    parser.setFilter({"gpx/trk/trkpt/ele"});
+    XML::Element gpx = parser.parseRootElement();
+
+    // Ensure only the elements on the filter's paths are built
+    BOOST_CHECK(! gpx.containsSubElement("metadata"));
+    BOOST_CHECK(! gpx.containsSubElement("wpt"));
+    BOOST_CHECK(! gpx.getSubElement("trk").containsSubElement("name"));
+    BOOST_REQUIRE_EQUAL(gpx.getSubElement("trk").countSubElements("trkpt"), 2u);
+    BOOST_CHECK_EQUAL(gpx.getSubElement("trk").getSubElement("trkpt").getAttribute("lat"), "1");
+    BOOST_CHECK_EQUAL(gpx.getSubElement("trk").getSubElement("trkpt").getSubElement("ele").getLeafContent(), "10");
+    BOOST_CHECK(! gpx.getSubElement("trk").getSubElement("trkpt").containsSubElement("extensions"));
+}
+
+BOOST_AUTO_TEST_CASE(FilteredEvents){
+    XML::Parser parser {std::string_view{annotatedXML}};
+    parser.setFilter({"gpx/trk/trkpt/ele"});
+    std::string trace;
+    for (XML::Event event = parser.nextEvent(); event.type != XML::Event::Type::EndOfDocument; event = parser.nextEvent())
+    {
+        if (event.type == XML::Event::Type::StartElement) trace += "<" + std::string{event.name} + ">";
+        if (event.type == XML::Event::Type::Text) trace += "[" + std::string{event.text} + "]";
+        if (event.type == XML::Event::Type::EndElement) trace += "</" + std::string{event.name} + ">";
+    }
+
+    // Ensure skipped elements produce no events
+    BOOST_CHECK_EQUAL(trace, "<gpx><trk><trkpt><ele>[10]</ele></trkpt><trkpt></trkpt></trk></gpx>");
+}
+
+BOOST_AUTO_TEST_CASE(FilterWildcards){
+    XML::Parser parser {std::string_view{annotatedXML}};
+    parser.setFilter({"gpx/*/name", "gpx/trk/trkpt/extensions/*"});
+    std::string trace;
+    for (XML::Event event = parser.nextEvent(); event.type != XML::Event::Type::EndOfDocument; event = parser.nextEvent())
+    {
+        if (event.type == XML::Event::Type::StartElement) trace += "<" + std::string{event.name} + ">";
+        if (event.type == XML::Event::Type::Text) trace += "[" + std::string{event.text} + "]";
+        if (event.type == XML::Event::Type::EndElement) trace += "</" + std::string{event.name} + ">";
+    }
+
+    // Ensure "*" matches any name, and that a named path is preferred where both match
+    BOOST_CHECK_EQUAL(trace, "<gpx><metadata><name>[Big]</name></metadata><trk><trkpt><extensions><hr>[150]</hr></extensions></trkpt>"
+                             "<trkpt></trkpt></trk><wpt></wpt></gpx>");
+}
+
+BOOST_AUTO_TEST_CASE(SkippedElementsMustBeBalanced){
+    const std::vector<std::string> malformedXML = {
+        "<gpx><metadata><name></metadata></name></gpx>",
+        "<gpx><metadata><name>",
+        "<gpx><metadata a=\"></metadata></gpx>",
+    };
+
+    // Ensure skipping still rejects mismatched or missing closing tags
+    for (const std::string& xml : malformedXML)
+    {
+        XML::Parser parser {std::string_view{xml}};
+        parser.setFilter({"gpx/trk"});
+        BOOST_CHECK_THROW(parser.parseRootElement(), std::domain_error);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
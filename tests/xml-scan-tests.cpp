@@ -0,0 +1,71 @@
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <string>
+
+#include "xml-scan.h"
+
+
+BOOST_AUTO_TEST_SUITE(XMLScanTests)
+
+// Expected results, computed one character at a time.
+const char* referenceFindNameDelimiter(const char* begin, const char* end)
+{
+    while (begin != end && ! XML::Scan::isNameDelimiter(*begin)) ++begin;
+    return begin;
+}
+
+const char* referenceSkipWhitespace(const char* begin, const char* end)
+{
+    while (begin != end && XML::Scan::isWhitespace(*begin)) ++begin;
+    return begin;
+}
+
+const char* referenceFindChar(const char* begin, const char* end, char target)
+{
+    while (begin != end && *begin != target) ++begin;
+    return begin;
+}
+
+
+BOOST_AUTO_TEST_CASE(AllScannersAgreeWithReference){
+    std::mt19937 random {2024};
+    const std::string alphabet = "abcXYZ019:_-.\x80\xff\t\n\v\f\r /<>=\"";
+
+    for (const XML::Scan::Scanner& scanner : XML::Scan::availableScanners())
+    {
+        for (int trial = 0; trial < 2000; ++trial)
+        {
+            // Mostly runs of one class, so that the scans cross 16 and 32 byte boundaries.
+            std::string text;
+            const std::size_t length = random() % 100;
+            const char filler = trial % 2 == 0 ? 'a' : ' ';
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                text += random() % 8 == 0 ? alphabet[random() % alphabet.size()] : filler;
+            }
+            const char* begin = text.data() + (length > 0 ? random() % (length + 1) : 0);
+            const char* end = text.data() + text.size();
+
+            // Ensure every implementation stops at the same character as the reference
+            BOOST_REQUIRE_MESSAGE(scanner.findNameDelimiter(begin, end) == referenceFindNameDelimiter(begin, end), scanner.name);
+            BOOST_REQUIRE_MESSAGE(scanner.skipWhitespace(begin, end) == referenceSkipWhitespace(begin, end), scanner.name);
+            BOOST_REQUIRE_MESSAGE(scanner.findChar(begin, end, '<') == referenceFindChar(begin, end, '<'), scanner.name);
+            BOOST_REQUIRE_MESSAGE(scanner.findChar(begin, end, '"') == referenceFindChar(begin, end, '"'), scanner.name);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(EmptyRange){
+    const char* text = "abc";
+
+    // Ensure scanning an empty range returns its end
+    for (const XML::Scan::Scanner& scanner : XML::Scan::availableScanners())
+    {
+        BOOST_CHECK(scanner.findNameDelimiter(text, text) == text);
+        BOOST_CHECK(scanner.skipWhitespace(text, text) == text);
+        BOOST_CHECK(scanner.findChar(text, text, '<') == text);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()